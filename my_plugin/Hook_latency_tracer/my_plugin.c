@@ -0,0 +1,260 @@
+/*
+  my_plugin.c - hook chain latency tracer
+
+  Wraps the head of the grbl.on_* callback chains and records call counts and cumulative time spent in each chain.
+  my_plugin_init() is called after driver and core plugins are initialized so all links registered by them are traced.
+
+  NOTE: only the chain head is timed, the time reported is for the whole chain.
+        Individual links cannot be timed as each plugin keeps its previous link in a private static,
+        the chain cannot be walked and the tracer cannot tell which plugin a link belongs to.
+
+  Use:
+  $HOOKS to list the chains by cost.
+  $HOOKS=R to reset the counters.
+
+  Part of grblHAL
+
+  Public domain.
+  This code is is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include <string.h>
+
+#include "grbl/hal.h"
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define DEMCR       (*(volatile uint32_t *)0xE000EDFC)
+#define DWT_CTRL    (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT  (*(volatile uint32_t *)0xE0001004)
+#define DWT_LAR     (*(volatile uint32_t *)0xE0001FB0)
+#endif
+
+typedef enum {
+    Hook_ExecuteRealtime = 0,
+    Hook_ExecuteDelay,
+    Hook_RealtimeReport,
+    Hook_StateChange,
+    Hook_ReportOptions,
+    Hook_ProgramCompleted,
+    Hook_ProbeToolsetter,
+    Hook_Count
+} hook_id_t;
+
+typedef struct {
+    const char *name;
+    bool traced;
+    uint32_t calls;
+    uint32_t max;
+    uint64_t ticks;
+} hook_stats_t;
+
+static bool use_cyccnt = false;
+static uint32_t ticks_per_us = 1;
+static hook_stats_t hooks[Hook_Count] = {
+    { .name = "on_execute_realtime" },
+    { .name = "on_execute_delay" },
+    { .name = "on_realtime_report" },
+    { .name = "on_state_change" },
+    { .name = "on_report_options" },
+    { .name = "on_program_completed" },
+    { .name = "on_probe_toolsetter" }
+};
+
+static on_execute_realtime_ptr on_execute_realtime, on_execute_delay;
+static on_realtime_report_ptr on_realtime_report;
+static on_state_change_ptr on_state_change;
+static on_report_options_ptr on_report_options;
+static on_program_completed_ptr on_program_completed;
+static on_probe_toolsetter_ptr on_probe_toolsetter;
+
+// Cycle counter when available, microseconds otherwise.
+static inline uint32_t timestamp (void)
+{
+#ifdef DWT_CYCCNT
+    if(use_cyccnt)
+        return DWT_CYCCNT;
+#endif
+    return hal.get_micros ? hal.get_micros() : hal.get_elapsed_ticks() * 1000;
+}
+
+static inline void hook_done (hook_id_t id, uint32_t t0)
+{
+    uint32_t ticks = timestamp() - t0;
+
+    hooks[id].calls++;
+    hooks[id].ticks += ticks;
+    if(ticks > hooks[id].max)
+        hooks[id].max = ticks;
+}
+
+static void traceExecuteRealtime (sys_state_t state)
+{
+    uint32_t t0 = timestamp();
+
+    on_execute_realtime(state);
+
+    hook_done(Hook_ExecuteRealtime, t0);
+}
+
+static void traceExecuteDelay (sys_state_t state)
+{
+    uint32_t t0 = timestamp();
+
+    on_execute_delay(state);
+
+    hook_done(Hook_ExecuteDelay, t0);
+}
+
+static void traceRealtimeReport (stream_write_ptr stream_write, report_tracking_flags_t report)
+{
+    uint32_t t0 = timestamp();
+
+    on_realtime_report(stream_write, report);
+
+    hook_done(Hook_RealtimeReport, t0);
+}
+
+static void traceStateChange (sys_state_t state)
+{
+    uint32_t t0 = timestamp();
+
+    on_state_change(state);
+
+    hook_done(Hook_StateChange, t0);
+}
+
+static void traceProgramCompleted (program_flow_t program_flow, bool check_mode)
+{
+    uint32_t t0 = timestamp();
+
+    on_program_completed(program_flow, check_mode);
+
+    hook_done(Hook_ProgramCompleted, t0);
+}
+
+static bool traceProbeToolsetter (tool_data_t *tool, coord_data_t *position, bool at_g59_3, bool on)
+{
+    bool ok;
+    uint32_t t0 = timestamp();
+
+    ok = on_probe_toolsetter(tool, position, at_g59_3, on);
+
+    hook_done(Hook_ProbeToolsetter, t0);
+
+    return ok;
+}
+
+static void traceReportOptions (bool newopt)
+{
+    uint32_t t0 = timestamp();
+
+    on_report_options(newopt);
+
+    hook_done(Hook_ReportOptions, t0);
+
+    if(!newopt)
+        report_plugin("Hook latency tracer", "0.01");
+}
+
+static inline float to_us (uint64_t ticks)
+{
+    return (float)ticks / (float)ticks_per_us;
+}
+
+static status_code_t hooks_command (sys_state_t state, char *args)
+{
+    uint_fast8_t idx, i, order[Hook_Count];
+
+    if(args) {
+
+        if(strcmp(args, "R"))
+            return Status_InvalidStatement;
+
+        for(idx = 0; idx < Hook_Count; idx++)
+            hooks[idx].calls = hooks[idx].max = hooks[idx].ticks = 0;
+
+        return Status_OK;
+    }
+
+    // Sort by cumulative time, most expensive first.
+    for(idx = 0; idx < Hook_Count; idx++) {
+        i = idx;
+        while(i && hooks[order[i - 1]].ticks < hooks[idx].ticks) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = idx;
+    }
+
+    for(idx = 0; idx < Hook_Count; idx++) {
+
+        hook_stats_t *hook = &hooks[order[idx]];
+
+        hal.stream.write(hook->name);
+        if(hook->traced) {
+            hal.stream.write(" (chain): ");
+            hal.stream.write(uitoa(hook->calls));
+            hal.stream.write(" calls, ");
+            hal.stream.write(ftoa(to_us(hook->ticks), 0));
+            hal.stream.write(" us, avg ");
+            hal.stream.write(ftoa(hook->calls ? to_us(hook->ticks / hook->calls) : 0.0f, 2));
+            hal.stream.write(" us, max ");
+            hal.stream.write(ftoa(to_us(hook->max), 2));
+            hal.stream.write(" us" ASCII_EOL);
+        } else
+            hal.stream.write(": not used" ASCII_EOL);
+    }
+
+    return Status_OK;
+}
+
+void my_plugin_init (void)
+{
+    static const sys_command_t command_list[] = {
+        {"HOOKS", hooks_command, { .noargs = Off }, { .str = "$HOOKS[=R] - list grbl callback chains by cost of the whole chain or reset counters" } }
+    };
+
+    static sys_commands_t commands = {
+        .n_commands = sizeof(command_list) / sizeof(sys_command_t),
+        .commands = command_list
+    };
+
+#ifdef DWT_CYCCNT
+    if(hal.f_mcu) {
+        DEMCR |= (1 << 24);     // TRCENA
+        DWT_LAR = 0xC5ACCE55;   // unlock, required by Cortex-M7
+        DWT_CYCCNT = 0;
+        DWT_CTRL |= 1;          // CYCCNTENA
+        if((use_cyccnt = DWT_CYCCNT != 0))
+            ticks_per_us = hal.f_mcu;
+    }
+#endif
+
+    // Only chains with at least one link are wrapped, the core checks for NULL pointers before calling some of them.
+
+    if((hooks[Hook_ExecuteRealtime].traced = !!(on_execute_realtime = grbl.on_execute_realtime)))
+        grbl.on_execute_realtime = traceExecuteRealtime;
+
+    if((hooks[Hook_ExecuteDelay].traced = !!(on_execute_delay = grbl.on_execute_delay)))
+        grbl.on_execute_delay = traceExecuteDelay;
+
+    if((hooks[Hook_RealtimeReport].traced = !!(on_realtime_report = grbl.on_realtime_report)))
+        grbl.on_realtime_report = traceRealtimeReport;
+
+    if((hooks[Hook_StateChange].traced = !!(on_state_change = grbl.on_state_change)))
+        grbl.on_state_change = traceStateChange;
+
+    if((hooks[Hook_ProgramCompleted].traced = !!(on_program_completed = grbl.on_program_completed)))
+        grbl.on_program_completed = traceProgramCompleted;
+
+    if((hooks[Hook_ProbeToolsetter].traced = !!(on_probe_toolsetter = grbl.on_probe_toolsetter)))
+        grbl.on_probe_toolsetter = traceProbeToolsetter;
+
+    hooks[Hook_ReportOptions].traced = true;
+    on_report_options = grbl.on_report_options;
+    grbl.on_report_options = traceReportOptions;
+
+    system_register_commands(&commands);
+}
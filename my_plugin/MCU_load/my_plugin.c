@@ -1,10 +1,22 @@
 /*
-  my_plugin.c.c - MCU load estimator
+  my_plugin.c.c - MCU load estimator and foreground loop profiler
 
   Counts number of iterations of protocol idle loop per 10ms and add count to real time report.
 
   Higher number is better. E.g. the iMXRT1062 reports > 20000 when idle -> less than 500ns per iteration.
 
+  Also profiles the foreground loop: the loop period, the downstream on_execute_realtime and on_execute_delay
+  hook chains and the on_realtime_report chain. Min/avg/max are for the last one second window, peak and
+  histograms accumulate until reset.
+
+  Use:
+  $PROFILE to output the profile.
+  $PROFILE=R to reset.
+  $PROFILE=1 to add |PRF:<loop avg>,<loop max>,<realtime chain max> element (microseconds) to the real time report.
+  $PROFILE=0 to remove the element from the real time report.
+
+  NOTE: the plugin has to be initialized last in order to time all hooks in the chains.
+
   Part of grblHAL
 
   Public domain.
@@ -13,21 +25,140 @@
   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
 */
 
+#include <stddef.h>
 #include <string.h>
 
 #include "grbl/hal.h"
 
+#ifndef BINARY_REPORT_ENABLE
+#define BINARY_REPORT_ENABLE 0 // set to 1 to add field to the binary status report, requires binary_report.c
+#endif
+
+#if BINARY_REPORT_ENABLE
+#include "binary_report.h"
+#endif
+
+#define PROFILE_BUCKETS 10      // histogram buckets: < 1, < 2, < 4 ... < 256 and >= 256 microseconds
+#define PROFILE_WINDOW  1000    // milliseconds
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define DEMCR       (*(volatile uint32_t *)0xE000EDFC)
+#define DWT_CTRL    (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT  (*(volatile uint32_t *)0xE0001004)
+#define DWT_LAR     (*(volatile uint32_t *)0xE0001FB0)
+#endif
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} profile_window_t;
+
+typedef struct {
+    const char *name;
+    profile_window_t acc;
+    profile_window_t last;
+    uint32_t peak;
+    uint32_t histogram[PROFILE_BUCKETS];
+} profile_section_t;
+
+typedef enum {
+    Profile_Loop = 0,
+    Profile_Realtime,
+    Profile_Delay,
+    Profile_Report,
+    Profile_Sections
+} profile_id_t;
+
 static uint32_t count = 0;
-static bool add_report = false;
-static on_execute_realtime_ptr on_execute_realtime;
+static bool add_report = false, add_profile = false, use_cyccnt = false;
+static uint32_t ticks_per_us = 1, loop_start = 0;
+static profile_section_t profile[Profile_Sections] = {
+    { .name = "Loop" },
+    { .name = "Realtime hooks" },
+    { .name = "Delay hooks" },
+    { .name = "Report hooks" }
+};
+static on_execute_realtime_ptr on_execute_realtime, on_execute_delay;
 static on_realtime_report_ptr on_realtime_report;
 static on_report_options_ptr on_report_options;
 
+// Cycle counter when available, microseconds otherwise.
+static inline uint32_t timestamp (void)
+{
+#ifdef DWT_CYCCNT
+    if(use_cyccnt)
+        return DWT_CYCCNT;
+#endif
+    return hal.get_micros ? hal.get_micros() : hal.get_elapsed_ticks() * 1000;
+}
+
+static void profile_reset (void)
+{
+    uint_fast8_t idx = Profile_Sections;
+
+    do {
+        idx--;
+        memset(&profile[idx].acc, 0, sizeof(profile_section_t) - offsetof(profile_section_t, acc));
+        profile[idx].acc.min = profile[idx].last.min = UINT32_MAX;
+    } while(idx);
+
+    loop_start = 0;
+}
+
+static void profile_add (profile_section_t *section, uint32_t ticks)
+{
+    uint32_t us = ticks / ticks_per_us;
+    uint_fast8_t bucket = 0;
+
+    while(us && bucket < PROFILE_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+
+    section->histogram[bucket]++;
+    section->acc.count++;
+    section->acc.sum += ticks;
+    if(ticks < section->acc.min)
+        section->acc.min = ticks;
+    if(ticks > section->acc.max)
+        section->acc.max = ticks;
+    if(ticks > section->peak)
+        section->peak = ticks;
+}
+
+static void profile_window_close (void)
+{
+    uint_fast8_t idx = Profile_Sections;
+
+    do {
+        idx--;
+        memcpy(&profile[idx].last, &profile[idx].acc, sizeof(profile_window_t));
+        memset(&profile[idx].acc, 0, sizeof(profile_window_t));
+        profile[idx].acc.min = UINT32_MAX;
+    } while(idx);
+}
+
+static inline float to_us (uint32_t ticks)
+{
+    return (float)ticks / (float)ticks_per_us;
+}
+
+static uint32_t window_avg (profile_window_t *window)
+{
+    return window->count ? (uint32_t)(window->sum / window->count) : 0;
+}
+
 void onExecuteRealtime (uint_fast16_t state)
 {
-    static uint32_t last_ms, last_count;
+    static uint32_t last_ms, last_count, window_ms;
+
+    uint32_t ms = hal.get_elapsed_ticks(), t0 = timestamp();
 
-    uint32_t ms = hal.get_elapsed_ticks();
+    if(loop_start)
+        profile_add(&profile[Profile_Loop], t0 - loop_start);
+    loop_start = t0;
 
     if(ms - last_ms >= 10) {
         last_ms = ms;
@@ -37,12 +168,33 @@ void onExecuteRealtime (uint_fast16_t state)
     } else
         last_count++;
 
+    if(ms - window_ms >= PROFILE_WINDOW) {
+        window_ms = ms;
+        profile_window_close();
+    }
+
     on_execute_realtime(state);
+
+    profile_add(&profile[Profile_Realtime], timestamp() - t0);
+}
+
+static void onExecuteDelay (uint_fast16_t state)
+{
+    uint32_t t0 = timestamp();
+
+    if(on_execute_delay)
+        on_execute_delay(state);
+
+    profile_add(&profile[Profile_Delay], timestamp() - t0);
+
+    loop_start = 0; // do not count delays as loop time
 }
 
 static void onRealtimeReport (stream_write_ptr stream_write, report_tracking_flags_t report)
 {
-    static char buf[20] = {0};
+    static char buf[40] = {0};
+
+    uint32_t t0;
 
     if (add_report) {
 
@@ -54,26 +206,138 @@ static void onRealtimeReport (stream_write_ptr stream_write, report_tracking_fla
         stream_write(buf);
     }
 
-    if(on_realtime_report)
+    if(add_profile) {
+        strcpy(buf, "|PRF:");
+        strcat(buf, uitoa(window_avg(&profile[Profile_Loop].last) / ticks_per_us));
+        strcat(buf, ",");
+        strcat(buf, uitoa(profile[Profile_Loop].last.max / ticks_per_us));
+        strcat(buf, ",");
+        strcat(buf, uitoa(profile[Profile_Realtime].last.max / ticks_per_us));
+        stream_write(buf);
+    }
+
+    if(on_realtime_report) {
+        t0 = timestamp();
         on_realtime_report(stream_write, report);
+        profile_add(&profile[Profile_Report], timestamp() - t0);
+    }
+}
+
+static void report_section (profile_section_t *section)
+{
+    uint_fast8_t idx;
+
+    hal.stream.write(section->name);
+    hal.stream.write(" (us): ");
+    if(section->last.count) {
+        hal.stream.write(ftoa(to_us(section->last.min), 2));
+        hal.stream.write("/");
+        hal.stream.write(ftoa(to_us(window_avg(&section->last)), 2));
+        hal.stream.write("/");
+        hal.stream.write(ftoa(to_us(section->last.max), 2));
+    } else
+        hal.stream.write("-/-/-");
+    hal.stream.write(", peak ");
+    hal.stream.write(ftoa(to_us(section->peak), 2));
+    hal.stream.write(", ");
+    hal.stream.write(uitoa(section->last.count));
+    hal.stream.write("/s" ASCII_EOL " histogram: ");
+
+    for(idx = 0; idx < PROFILE_BUCKETS; idx++) {
+        if(idx)
+            hal.stream.write(",");
+        hal.stream.write(uitoa(section->histogram[idx]));
+    }
+
+    hal.stream.write(ASCII_EOL);
 }
 
+static status_code_t profile_command (sys_state_t state, char *args)
+{
+    status_code_t status = Status_OK;
+
+    if(args == NULL) {
+
+        uint_fast8_t idx;
+
+        hal.stream.write(use_cyccnt ? "Timer: cycle counter" ASCII_EOL : (hal.get_micros ? "Timer: microseconds" ASCII_EOL : "Timer: milliseconds" ASCII_EOL));
+        for(idx = 0; idx < Profile_Sections; idx++)
+            report_section(&profile[idx]);
+
+    } else if(!strcmp(args, "R"))
+        profile_reset();
+    else if(!strcmp(args, "0") || !strcmp(args, "1"))
+        add_profile = *args == '1';
+    else
+        status = Status_InvalidStatement;
+
+    return status;
+}
+
+#if BINARY_REPORT_ENABLE
+
+static void fill_load (uint8_t *data)
+{
+    memcpy(data, &count, sizeof(uint32_t));
+}
+
+#endif
+
 static void onReportOptions (bool newopt)
 {
     on_report_options(newopt);
 
     if(!newopt)
-        report_plugin("MCU Load", "v0.01");
+        report_plugin("MCU Load", "v0.02");
 }
 
 void my_plugin_init (void)
 {
+    static const sys_command_t command_list[] = {
+        {"PROFILE", profile_command, { .noargs = Off }, { .str = "$PROFILE[=R|0|1] - output or reset foreground loop profile, 1/0 to enable/disable real time report element" } }
+    };
+
+    static sys_commands_t commands = {
+        .n_commands = sizeof(command_list) / sizeof(sys_command_t),
+        .commands = command_list
+    };
+
+#ifdef DWT_CYCCNT
+    if(hal.f_mcu) {
+        DEMCR |= (1 << 24);     // TRCENA
+        DWT_LAR = 0xC5ACCE55;   // unlock, required by Cortex-M7
+        DWT_CYCCNT = 0;
+        DWT_CTRL |= 1;          // CYCCNTENA
+        if((use_cyccnt = DWT_CYCCNT != 0))
+            ticks_per_us = hal.f_mcu;
+    }
+#endif
+
+    profile_reset();
+
+#if BINARY_REPORT_ENABLE
+    static binary_field_t load = {
+        .id = BinaryField_Load,
+        .format = BinaryFormat_U32,
+        .count = 1,
+        .name = "LOAD",
+        .fill = fill_load
+    };
+
+    binary_report_register(&load);
+#endif
+
     on_report_options = grbl.on_report_options;
     grbl.on_report_options = onReportOptions;
 
     on_execute_realtime = grbl.on_execute_realtime;
     grbl.on_execute_realtime = onExecuteRealtime;
 
+    on_execute_delay = grbl.on_execute_delay;
+    grbl.on_execute_delay = onExecuteDelay;
+
     on_realtime_report = grbl.on_realtime_report;
     grbl.on_realtime_report = onRealtimeReport;
+
+    system_register_commands(&commands);
 }
@@ -10,7 +10,10 @@
   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
 
   Up to 4 macros can be bound to input pins by changing the N_MACROS symbol below.
-  Each macro can be up to 127 characters long, blocks (lines) are separated by a vertical bar character: |
+  Each macro can be up to 255 characters long, blocks (lines) are separated by a vertical bar character: |
+  Macros are validated and compiled to a list of blocks when set, whitespace and comments are stripped
+  and words are converted to upper case. (MSG,..), (PRINT,..) and (DEBUG,..) comments are kept verbatim.
+  All macros share MACRO_POOL_SIZE bytes of storage for the compiled blocks.
   Setting numbers $450 - $453 are for defining the macro content.
   Setting numbers $454 - $457 are for configuring which aux input port to assign to each macro.
   NOTES: If the driver does not support mapping of port numbers settings $454 - $457 will not be available.
@@ -20,11 +23,14 @@
   Examples:
     $450=G0Y5|G1X0F50
     $451=G0x0Y0Z0
+    $451=g0 x0 y0 (park)|M5    - read back as G0X0Y0|M5
+    $451=(MSG, Parked)|G0X0Y0  - read back as (MSG, Parked)|G0X0Y0
 
   Tip: use the $pins command to check the port mapping.
 */
 
 #define N_MACROS 2 // MAX 4
+#define MACRO_POOL_SIZE (N_MACROS * 128) // bytes of NVS storage for compiled macros, shared by all macros
 
 #include <stdio.h>
 #include <string.h>
@@ -42,20 +48,25 @@
 #define N_MACROS 4
 #endif
 
-typedef struct {
-    uint8_t port;
-    char data[128];
-} macro_setting_t;
+#define MACRO_MAX_LENGTH 255
+#define MACRO_SETTINGS_VERSION 0x81 // increment when the layout of macro_settings_t or the compiled format changes,
+                                   // the high bit is set so that the port number stored first by earlier versions does not match
 
+// Compiled macros are stored back to back in the pool, each as a list of blocks
+// prefixed by their length and terminated by a zero length block.
 typedef struct {
-    macro_setting_t macro[N_MACROS];
+    uint8_t version;
+    uint8_t port[N_MACROS];
+    uint8_t code[MACRO_POOL_SIZE];
 } macro_settings_t;
 
 static const pin_cap_t pin_caps = { .irq_mode = IRQ_Mode_Falling };
 
 static bool is_executing = false;
 uint8_t port[N_MACROS];
-static char *command;
+static const uint8_t *code, *macro[N_MACROS];
+static uint_fast8_t remaining;
+static bool in_block;
 static const char *const label[] = { "Macro 1 input", "Macro 2 input", "Macro 3 input", "Macro 4 input" };
 static io_port_cfg_t d_in;
 static nvs_address_t nvs_address;
@@ -86,23 +97,28 @@ static void plugin_reset (void)
 }
 
 // Macro stream input function.
-// Reads character by character from the macro and returns them when
+// Reads character by character from the compiled macro and returns them when
 // requested by the foreground process.
 static int16_t get_macro_char (void)
 {
-    static bool eol_ok = false;
+    if(remaining == 0) {
 
-    if(*command == '\0') {                          // End of macro?
-        end_macro();                                // If end reading from it
-        return eol_ok ? SERIAL_NO_DATA : ASCII_LF;  // and return a linefeed if the last character was not a linefeed.
-    }
+        if(in_block) {                      // End of block?
+            in_block = false;               // If so
+            return ASCII_LF;                // return a linefeed.
+        }
 
-    char c = *command++;    // Get next character.
+        if((remaining = *code++) == 0) {    // End of macro?
+            end_macro();                    // If so end reading from it.
+            return SERIAL_NO_DATA;
+        }
 
-    if((eol_ok = c == '|')) // If character is vertical bar
-        c = ASCII_LF;       // return a linefeed character.
+        in_block = true;
+    }
 
-    return (uint16_t)c;
+    remaining--;
+
+    return (int16_t)*code++;
 }
 
 // This code will be executed after each command is sent to the parser,
@@ -142,8 +158,10 @@ ISR_CODE static void execute_macro (uint8_t irq_port, bool is_high)
             idx--;
         } while(idx && port[idx] != irq_port);
 
-        command = plugin_settings.macro[idx].data;
-        if(!(*command == '\0' || *command == 0xFF)) {    // If valid command
+        code = macro[idx];
+        if(*code) {                                 // If macro is not empty
+            remaining = 0;
+            in_block = false;
             is_executing = true;
             task_add_immediate(run_macro, NULL);     // register run_macro function to be called from foreground process.
         }
@@ -159,24 +177,219 @@ static const setting_group_detail_t macro_groups [] = {
 
 static status_code_t set_port (setting_id_t setting, float value)
 {
-    return d_in.set_value(&d_in, &plugin_settings.macro[setting - Setting_UserDefined_4].port, pin_caps, value);;
+    return d_in.set_value(&d_in, &plugin_settings.port[setting - Setting_UserDefined_4], pin_caps, value);;
 }
 
 static float get_port (setting_id_t setting)
 {
-    return d_in.get_value(&d_in, plugin_settings.macro[setting - Setting_UserDefined_4].port);
+    return d_in.get_value(&d_in, plugin_settings.port[setting - Setting_UserDefined_4]);
+}
+
+// Returns size of compiled macro including the terminating zero length block.
+static uint_fast16_t macro_size (const uint8_t *code)
+{
+    const uint8_t *start = code;
+
+    while(*code)
+        code += *code + 1;
+
+    return code - start + 1;
+}
+
+// Set pointers to the start of each macro in the pool,
+// returns false if the pool is corrupt.
+static bool index_macros (void)
+{
+    uint_fast8_t idx;
+    uint_fast16_t offset = 0;
+
+    for(idx = 0; idx < N_MACROS; idx++) {
+        macro[idx] = &plugin_settings.code[offset];
+        while(offset < MACRO_POOL_SIZE && plugin_settings.code[offset])
+            offset += plugin_settings.code[offset] + 1;
+        if(++offset > MACRO_POOL_SIZE)
+            return false;
+    }
+
+    return true;
+}
+
+// Check that the block is a sequence of words, parameters, expressions
+// and flow control statements are checked when executed.
+static status_code_t validate_block (char *block)
+{
+    float value;
+    uint_fast8_t char_counter = 0;
+
+    if(*block == '$' || *block == '#' || *block == 'O')
+        return Status_OK;
+
+    while(block[char_counter]) {
+
+        if(block[char_counter] == '(') {  // Kept comment, terminated when compiled.
+            while(block[char_counter++] != ')');
+            continue;
+        }
+
+        if(block[char_counter] < 'A' || block[char_counter] > 'Z')
+            return Status_ExpectedCommandLetter;
+
+        if(block[++char_counter] == '#' || block[char_counter] == '[')
+            break;
+
+        if(!read_float(block, &char_counter, &value))
+            return Status_BadNumberFormat;
+    }
+
+    return Status_OK;
+}
+
+// Returns true if the comment is to be kept, the core outputs the text of these.
+static bool is_message (const char *comment)
+{
+    static const char *const keep[] = { "MSG,", "PRINT,", "DEBUG," };
+
+    uint_fast8_t idx, i;
+
+    for(idx = 0; idx < sizeof(keep) / sizeof(char *); idx++) {
+        for(i = 0; keep[idx][i] && CAPS(comment[i]) == keep[idx][i]; i++);
+        if(keep[idx][i] == '\0')
+            return true;
+    }
+
+    return false;
+}
+
+// Compile macro source to a list of length prefixed blocks.
+// Whitespace and comments are stripped and words converted to upper case,
+// system commands and message comments are copied verbatim.
+static status_code_t compile_macro (char *source, uint8_t *code, uint_fast16_t *size)
+{
+    static char block[MACRO_MAX_LENGTH + 1];
+
+    char c;
+    uint_fast16_t len, n = 0;
+    status_code_t status = Status_OK;
+
+    if(strlen(source) > MACRO_MAX_LENGTH)
+        return Status_Overflow;
+
+    while(*source && status == Status_OK) {
+
+        len = 0;
+
+        while(*source == ' ' || *source == '\t')
+            source++;
+
+        if(*source == '$') {
+            while(*source && *source != '|')
+                block[len++] = *source++;
+            while(len && block[len - 1] == ' ')
+                len--;
+        } else while((c = *source) && c != '|') {
+            source++;
+            if(c == '(') {
+                bool keep = is_message(source);
+                if(keep)
+                    block[len++] = c;
+                while(*source && *source != ')' && *source != '|') {
+                    if(keep)
+                        block[len++] = *source;
+                    source++;
+                }
+                if(*source != ')')
+                    status = Status_InvalidStatement; // unterminated comment
+                else if(keep)
+                    block[len++] = *source++;
+                else
+                    source++;
+            } else if(c == ';') {
+                while(*source && *source != '|')
+                    source++;
+            } else if(c != ' ' && c != '\t')
+                block[len++] = CAPS(c);
+        }
+
+        if(*source == '|')
+            source++;
+
+        if(len && status == Status_OK) {
+            block[len] = '\0';
+            if((status = validate_block(block)) == Status_OK) {
+                code[n++] = (uint8_t)len;
+                memcpy(&code[n], block, len);
+                n += len;
+            }
+        }
+    }
+
+    code[n++] = 0;
+    *size = n;
+
+    return status;
+}
+
+static status_code_t set_macro (setting_id_t setting, char *value)
+{
+    static uint8_t compiled[MACRO_MAX_LENGTH + 2];
+
+    uint_fast8_t idx = setting - Setting_UserDefined_0;
+    uint_fast16_t size, old_size, used;
+    uint8_t *dest;
+    status_code_t status;
+
+    if(is_executing)
+        return Status_IdleError;
+
+    if((status = compile_macro(value, compiled, &size)) != Status_OK)
+        return status;
+
+    dest = (uint8_t *)macro[idx];
+    old_size = macro_size(dest);
+    used = (macro[N_MACROS - 1] - plugin_settings.code) + macro_size(macro[N_MACROS - 1]);
+
+    if(used - old_size + size > MACRO_POOL_SIZE)
+        return Status_SettingValueOutOfRange;
+
+    // Move the following macros to make room for or close the gap after the new content.
+    memmove(dest + size, dest + old_size, used - (dest - plugin_settings.code) - old_size);
+    memcpy(dest, compiled, size);
+
+    index_macros();
+
+    return Status_OK;
+}
+
+// Decompile macro to the source format, blocks separated by |.
+static char *get_macro (setting_id_t setting)
+{
+    static char source[MACRO_POOL_SIZE + 1];
+
+    char *s = source;
+    const uint8_t *data = macro[setting - Setting_UserDefined_0];
+
+    while(*data) {
+        if(s != source)
+            *s++ = '|';
+        memcpy(s, data + 1, *data);
+        s += *data;
+        data += *data + 1;
+    }
+    *s = '\0';
+
+    return source;
 }
 
 static const setting_detail_t macro_settings[] = {
-    { Setting_UserDefined_0, Group_UserSettings, "Macro 1", NULL, Format_String, "x(127)", "0", "127", Setting_NonCore, &plugin_settings.macro[0].data, NULL, NULL },
+    { Setting_UserDefined_0, Group_UserSettings, "Macro 1", NULL, Format_String, "x(255)", "0", "255", Setting_NonCoreFn, set_macro, get_macro, NULL },
 #if N_MACROS > 1
-    { Setting_UserDefined_1, Group_UserSettings, "Macro 2", NULL, Format_String, "x(127)", "0", "127", Setting_NonCore, &plugin_settings.macro[1].data, NULL, NULL },
+    { Setting_UserDefined_1, Group_UserSettings, "Macro 2", NULL, Format_String, "x(255)", "0", "255", Setting_NonCoreFn, set_macro, get_macro, NULL },
 #endif
 #if N_MACROS > 2
-    { Setting_UserDefined_2, Group_UserSettings, "Macro 3", NULL, Format_String, "x(127)", "0", "127", Setting_NonCore, &plugin_settings.macro[2].data, NULL, NULL },
+    { Setting_UserDefined_2, Group_UserSettings, "Macro 3", NULL, Format_String, "x(255)", "0", "255", Setting_NonCoreFn, set_macro, get_macro, NULL },
 #endif
 #if N_MACROS > 3
-    { Setting_UserDefined_3, Group_UserSettings, "Macro 4", NULL, Format_String, "x(127)", "0", "127", Setting_NonCore, &plugin_settings.macro[3].data, NULL, NULL },
+    { Setting_UserDefined_3, Group_UserSettings, "Macro 4", NULL, Format_String, "x(255)", "0", "255", Setting_NonCoreFn, set_macro, get_macro, NULL },
 #endif
     { Setting_UserDefined_4, Group_AuxPorts, "Macro 1 port", NULL, Format_Decimal, "-#0", "-1", d_in.port_maxs, Setting_NonCoreFn, set_port, get_port, NULL, { .reboot_required = On } },
 #if N_MACROS > 1
@@ -225,14 +438,18 @@ static void macro_settings_restore (void)
     uint_fast8_t idx = min(N_MACROS, d_in.n_ports);
 
     memset(&plugin_settings, 0xFF, sizeof(macro_settings_t));
+    memset(plugin_settings.code, 0, sizeof(plugin_settings.code));
 
-    // Register empty macro strings and set default port numbers if mapping is available.
+    plugin_settings.version = MACRO_SETTINGS_VERSION;
+
+    // Register empty macros and set default port numbers if mapping is available.
     do {
         idx--;
-        *plugin_settings.macro[idx].data = '\0';
-        plugin_settings.macro[idx].port = d_in.get_next(&d_in, idx == min(N_MACROS, d_in.n_ports) - 1 ? IOPORT_UNASSIGNED : plugin_settings.macro[idx + 1].port, label[idx], pin_caps);
+        plugin_settings.port[idx] = d_in.get_next(&d_in, idx == min(N_MACROS, d_in.n_ports) - 1 ? IOPORT_UNASSIGNED : plugin_settings.port[idx + 1], label[idx], pin_caps);
     } while(idx);
 
+    index_macros();
+
     hal.nvs.memcpy_to_nvs(nvs_address, (uint8_t *)&plugin_settings, sizeof(macro_settings_t), true);
 }
 
@@ -243,12 +460,14 @@ static void macro_settings_load (void)
     uint_fast8_t idx = min(N_MACROS, d_in.n_ports), n_ok = 0, n_enabled = 0;
     xbar_t *pin;
 
-    if(hal.nvs.memcpy_from_nvs((uint8_t *)&plugin_settings, nvs_address, sizeof(macro_settings_t), true) != NVS_TransferResult_OK)
+    // Settings saved by earlier versions have a different layout and are restored to defaults.
+    if(hal.nvs.memcpy_from_nvs((uint8_t *)&plugin_settings, nvs_address, sizeof(macro_settings_t), true) != NVS_TransferResult_OK ||
+        plugin_settings.version != MACRO_SETTINGS_VERSION || !index_macros())
         macro_settings_restore();
 
     do {
         idx--;
-        if((port[idx] = plugin_settings.macro[idx].port) == IOPORT_UNASSIGNED)
+        if((port[idx] = plugin_settings.port[idx]) == IOPORT_UNASSIGNED)
             continue;
         if((pin = d_in.claim(&d_in, &port[idx], label[idx], pin_caps))) {   // Try to claim the port.
             if(pin->cap.debounce) {                                         // Enable debounce if available.
@@ -279,7 +498,7 @@ static void report_options (bool newopt)
     on_report_options(newopt);
 
     if(!newopt)
-        report_plugin("Macro plugin (PD)", "0.05");
+        report_plugin("Macro plugin (PD)", "0.06");
 }
 
 // A call my_plugin_init will be issued automatically at startup.
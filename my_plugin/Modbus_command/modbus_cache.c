@@ -0,0 +1,325 @@
+/*
+
+  modbus_cache.c - Modbus register cache with staleness control
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+Keeps the last known value per device and register so that realtime code, e.g. a VFD spindle get_state
+handler, can be served without waiting for a bus round trip. Reads never block: a miss or a stale value
+queues a background refresh via the transaction scheduler and the caller uses its previous value or retries.
+
+Watched registers are refreshed by scheduler background polls, other entries are refreshed on demand
+and evicted least recently updated first. Invalidating a register bumps its generation so that a refresh
+queued before the invalidate cannot mark the old value as valid.
+
+*/
+
+#include <string.h>
+
+#include "modbus_cache.h"
+
+typedef struct {
+    uint8_t device;         // 0 = free
+    bool valid;
+    bool watched;
+    modbus_function_t function;
+    uint16_t address;
+    uint16_t value;
+    uint32_t updated;
+    uint32_t generation;    // cache generation when last invalidated
+} cache_entry_t;
+
+// Context for refresh reads and polls.
+typedef struct {
+    bool busy;
+    bool watched;
+    uint8_t device;
+    modbus_function_t function;
+    uint16_t address;
+    uint16_t n_registers;
+    uint32_t generation;    // cache generation when the read was queued
+    modbus_sched_response_ptr handler;
+    void *context;
+} refresh_t;
+
+static uint32_t generation = 0;
+static cache_entry_t cache[MODBUS_CACHE_REGISTERS] = {0};
+static refresh_t refreshes[MODBUS_SCHED_QUEUE_SIZE + MODBUS_SCHED_POLLS] = {0};
+static modbus_cache_stats_t stats = {0};
+
+static cache_entry_t *find_entry (uint8_t device, modbus_function_t function, uint16_t address)
+{
+    uint_fast8_t idx;
+
+    for(idx = 0; idx < MODBUS_CACHE_REGISTERS; idx++) {
+        if(cache[idx].device == device && cache[idx].function == function && cache[idx].address == address)
+            return &cache[idx];
+    }
+
+    return NULL;
+}
+
+static cache_entry_t *add_entry (uint8_t device, modbus_function_t function, uint16_t address)
+{
+    uint_fast8_t idx;
+    cache_entry_t *entry = NULL;
+
+    if((entry = find_entry(device, function, address)))
+        return entry;
+
+    for(idx = 0; idx < MODBUS_CACHE_REGISTERS; idx++) {
+        if(cache[idx].device == 0) {
+            entry = &cache[idx];
+            break;
+        }
+        if(!cache[idx].watched && (entry == NULL || (int32_t)(cache[idx].updated - entry->updated) < 0))
+            entry = &cache[idx];
+    }
+
+    if(entry) {
+        memset(entry, 0, sizeof(cache_entry_t));
+        entry->device = device;
+        entry->function = function;
+        entry->address = address;
+        entry->updated = hal.get_elapsed_ticks(); // protects the entry from eviction by the current request
+    }
+
+    return entry;
+}
+
+static void remove_entries (const bool *added)
+{
+    uint_fast8_t idx;
+
+    for(idx = 0; idx < MODBUS_CACHE_REGISTERS; idx++) {
+        if(added[idx])
+            memset(&cache[idx], 0, sizeof(cache_entry_t));
+    }
+}
+
+// Entries created are flagged in added so that they can be removed if the read cannot be queued.
+static bool add_entries (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, bool watched, bool *added)
+{
+    uint_fast8_t idx;
+    cache_entry_t *entry;
+
+    memset(added, 0, MODBUS_CACHE_REGISTERS * sizeof(bool));
+
+    for(idx = 0; idx < n_registers; idx++) {
+        if((entry = find_entry(device, function, address + idx)) == NULL) {
+            if((entry = add_entry(device, function, address + idx)) == NULL) {
+                remove_entries(added);
+                return false;
+            }
+            added[entry - cache] = true;
+        }
+        if(watched)
+            entry->watched = true;
+    }
+
+    return true;
+}
+
+// The refresh slot is taken before the cache entries so that entries are not added for a read that cannot be queued.
+static refresh_t *add_refresh (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, bool watched, bool *added)
+{
+    uint_fast8_t idx;
+
+    for(idx = 0; idx < sizeof(refreshes) / sizeof(refresh_t); idx++) {
+        if(!refreshes[idx].busy) {
+            if(!add_entries(device, function, address, n_registers, watched, added))
+                break;
+            memset(&refreshes[idx], 0, sizeof(refresh_t));
+            refreshes[idx].busy = true;
+            refreshes[idx].watched = watched;
+            refreshes[idx].device = device;
+            refreshes[idx].function = function;
+            refreshes[idx].address = address;
+            refreshes[idx].n_registers = n_registers;
+            refreshes[idx].generation = generation;
+            return &refreshes[idx];
+        }
+    }
+
+    return NULL;
+}
+
+// Values are only stored for entries not invalidated after the read was queued,
+// a read in flight when a register is written may return the old value.
+static void refresh_handler (modbus_response_t *response, void *context)
+{
+    uint_fast8_t idx;
+    refresh_t *refresh = (refresh_t *)context;
+    cache_entry_t *entry;
+    uint32_t ms = hal.get_elapsed_ticks();
+
+    if(!response->exception) {
+
+        stats.refreshes++;
+
+        for(idx = 0; idx < response->num_values; idx++) {
+            if((entry = find_entry(refresh->device, refresh->function, refresh->address + idx))) {
+                if((int32_t)(entry->generation - refresh->generation) > 0)
+                    continue;
+                entry->value = response->values[idx];
+                entry->updated = ms;
+                entry->valid = true;
+            }
+        }
+    }
+
+    if(refresh->handler)
+        refresh->handler(response, refresh->context);
+
+    // The next poll is queued after this response, invalidates from now on reject it.
+    // This may drop one good value but never stores a stale one.
+    if(refresh->watched)
+        refresh->generation = generation;
+    else
+        refresh->busy = false;
+}
+
+static bool queue_refresh (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, modbus_priority_t priority, modbus_sched_response_ptr handler, void *context)
+{
+    uint_fast8_t idx;
+    refresh_t *refresh;
+    bool added[MODBUS_CACHE_REGISTERS];
+
+    // Background refreshes are not queued if one is in progress.
+    if(handler == NULL) for(idx = 0; idx < sizeof(refreshes) / sizeof(refresh_t); idx++) {
+        if(refreshes[idx].busy && !refreshes[idx].watched && refreshes[idx].device == device && refreshes[idx].function == function &&
+            refreshes[idx].address == address && refreshes[idx].n_registers == n_registers)
+            return true;
+    }
+
+    if((refresh = add_refresh(device, function, address, n_registers, false, added)) == NULL)
+        return false;
+
+    refresh->handler = handler;
+    refresh->context = context;
+
+    if(!(refresh->busy = modbus_sched_submit(device, function, address, NULL, n_registers, priority, refresh_handler, refresh)))
+        remove_entries(added);
+
+    return refresh->busy;
+}
+
+bool modbus_cache_watch (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, uint16_t max_age)
+{
+    refresh_t *refresh;
+    bool added[MODBUS_CACHE_REGISTERS];
+
+    if(device == 0 || n_registers == 0 || max_age < 2 || !(function == ModBus_ReadHoldingRegisters || function == ModBus_ReadInputRegisters))
+        return false;
+
+    if((refresh = add_refresh(device, function, address, n_registers, true, added)) == NULL)
+        return false;
+
+    if(!(refresh->busy = modbus_sched_poll_add(device, function, address, n_registers, max_age / 2, refresh_handler, refresh)))
+        remove_entries(added);
+
+    return refresh->busy;
+}
+
+bool modbus_cache_lookup (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, uint16_t *values, uint16_t max_age)
+{
+    bool hit = true, stale = false;
+    uint_fast8_t idx;
+    uint32_t ms = hal.get_elapsed_ticks();
+    cache_entry_t *entry;
+
+    for(idx = 0; idx < n_registers; idx++) {
+        if((entry = find_entry(device, function, address + idx)) == NULL || !entry->valid)
+            hit = false;
+        else if(ms - entry->updated > max_age) {
+            stale = true;
+            hit = false;
+        }
+    }
+
+    if(hit) {
+        stats.hits++;
+        for(idx = 0; idx < n_registers; idx++)
+            values[idx] = find_entry(device, function, address + idx)->value;
+    } else if(stale)
+        stats.stale++;
+    else
+        stats.misses++;
+
+    return hit;
+}
+
+bool modbus_cache_read (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, uint16_t *values, uint16_t max_age)
+{
+    bool hit;
+
+    if(!(hit = modbus_cache_lookup(device, function, address, n_registers, values, max_age)))
+        queue_refresh(device, function, address, n_registers, ModbusPriority_Background, NULL, NULL);
+
+    return hit;
+}
+
+bool modbus_cache_fetch (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, modbus_sched_response_ptr handler, void *context)
+{
+    return handler && queue_refresh(device, function, address, n_registers, ModbusPriority_Normal, handler, context);
+}
+
+void modbus_cache_invalidate (uint8_t device, uint16_t address, uint16_t n_registers)
+{
+    uint_fast8_t idx;
+
+    generation++;
+
+    for(idx = 0; idx < MODBUS_CACHE_REGISTERS; idx++) {
+        if(cache[idx].device == device && cache[idx].address >= address && cache[idx].address < address + n_registers) {
+            cache[idx].valid = false;
+            cache[idx].generation = generation;
+        }
+    }
+}
+
+modbus_cache_stats_t *modbus_cache_get_stats (void)
+{
+    return &stats;
+}
+
+void modbus_cache_report_stats (void)
+{
+    uint_fast8_t idx, entries = 0;
+
+    for(idx = 0; idx < MODBUS_CACHE_REGISTERS; idx++) {
+        if(cache[idx].device)
+            entries++;
+    }
+
+    hal.stream.write("[MODBUSCACHE:");
+    hal.stream.write(uitoa(stats.hits));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(stats.misses));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(stats.stale));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(stats.refreshes));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(entries));
+    hal.stream.write("]" ASCII_EOL);
+}
@@ -0,0 +1,80 @@
+/*
+
+  modbus_cache.h - Modbus register cache with staleness control
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _MODBUS_CACHE_H_
+#define _MODBUS_CACHE_H_
+
+#include "modbus_scheduler.h"
+
+#ifndef MODBUS_CACHE_REGISTERS
+#define MODBUS_CACHE_REGISTERS  16  // max. number of cached registers
+#endif
+#ifndef MODBUS_CACHE_MAX_AGE
+#define MODBUS_CACHE_MAX_AGE    500 // milliseconds, default max. age for $MODBUSCMD cached reads
+#endif
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;    //!< reads of registers not in the cache
+    uint32_t stale;     //!< reads of registers older than the requested max. age
+    uint32_t refreshes; //!< responses stored
+} modbus_cache_stats_t;
+
+/*! \brief Keep registers fresh by background polls.
+\param device Modbus server address.
+\param function ModBus_ReadHoldingRegisters or ModBus_ReadInputRegisters.
+\param address register address.
+\param n_registers number of registers, max MODBUS_SCHED_MAX_REGISTERS.
+\param max_age max. age of the cached values in milliseconds, registers are polled at half this interval.
+\returns true if added, false if no cache entries or poll slots are available.
+*/
+bool modbus_cache_watch (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, uint16_t max_age);
+
+/*! \brief Read registers from the cache without bus I/O.
+If any register is missing or older than max_age a background refresh is queued.
+\param values pointer to array receiving the values, only written to on a hit.
+\returns true on a hit.
+*/
+bool modbus_cache_read (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, uint16_t *values, uint16_t max_age);
+
+/*! \brief Read registers from the cache without bus I/O and without queuing a refresh on a miss.
+\returns true on a hit.
+*/
+bool modbus_cache_lookup (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, uint16_t *values, uint16_t max_age);
+
+/*! \brief Read registers from the device with normal priority, the response refreshes the cache and is then passed to the handler.
+\param handler pointer to function to call with the response.
+\param context pointer passed to the handler.
+\returns true if the read was queued.
+*/
+bool modbus_cache_fetch (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, modbus_sched_response_ptr handler, void *context);
+
+/*! \brief Mark registers as stale, to be called after writing to them. */
+void modbus_cache_invalidate (uint8_t device, uint16_t address, uint16_t n_registers);
+
+modbus_cache_stats_t *modbus_cache_get_stats (void);
+
+/*! \brief Output cache statistics to the current stream. */
+void modbus_cache_report_stats (void);
+
+#endif
@@ -0,0 +1,403 @@
+/*
+
+  modbus_scheduler.c - prioritized Modbus transaction scheduler
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+Only one transaction can be in flight on a RTU bus, the scheduler keeps the bus busy by sending the next
+queued transaction as soon as a response or timeout is received.
+
+Transactions are sent by priority, then in submit order. Queued register reads from the same device and
+function that are adjacent or overlapping are coalesced into a single request and the response is split
+between the submitters. Background polls are only queued when due and sent when nothing else is pending.
+
+*/
+
+#include <string.h>
+
+#include "modbus_scheduler.h"
+
+// Number of values that can be returned in a response, may be less than the ADU allows.
+#define RESPONSE_VALUES (sizeof(((modbus_response_t *)NULL)->values) / sizeof(uint16_t))
+
+typedef struct {
+    bool queued;
+    uint8_t device;
+    uint8_t retries;
+    modbus_function_t function;
+    modbus_priority_t priority;
+    uint16_t address;
+    uint16_t n_registers;
+    uint16_t values[MODBUS_SCHED_MAX_REGISTERS];
+    uint32_t seq;
+    uint32_t submitted;
+    modbus_sched_response_ptr handler;
+    void *context;
+} transaction_t;
+
+typedef struct {
+    uint8_t device;
+    bool pending;
+    modbus_function_t function;
+    uint16_t address;
+    uint16_t n_registers;
+    uint16_t interval;
+    uint32_t next_due;
+    modbus_sched_response_ptr handler;
+    void *context;
+} poll_t;
+
+typedef struct {
+    uint8_t device;         // 0 is broadcast
+    modbus_sched_stats_t stats;
+} device_stats_t;
+
+static struct {
+    bool busy;
+    uint16_t address;
+    uint_fast8_t n_members;
+    transaction_t *members[MODBUS_SCHED_QUEUE_SIZE];
+} in_flight = {0};
+
+static uint32_t seq = 0;
+static transaction_t queue[MODBUS_SCHED_QUEUE_SIZE] = {0};
+static poll_t polls[MODBUS_SCHED_POLLS] = {0};
+static uint_fast8_t n_devices = 0;
+static device_stats_t devices[MODBUS_SCHED_DEVICES] = {0};
+static on_execute_realtime_ptr on_execute_realtime;
+
+static void dispatch (void);
+
+static inline bool is_register_read (modbus_function_t function)
+{
+    return function == ModBus_ReadHoldingRegisters || function == ModBus_ReadInputRegisters;
+}
+
+static modbus_sched_stats_t *get_stats (uint8_t device, bool add)
+{
+    uint_fast8_t idx;
+
+    for(idx = 0; idx < n_devices; idx++) {
+        if(devices[idx].device == device)
+            return &devices[idx].stats;
+    }
+
+    if(add && n_devices < MODBUS_SCHED_DEVICES) {
+        devices[n_devices].device = device;
+        return &devices[n_devices++].stats;
+    }
+
+    return NULL;
+}
+
+// Leaves the in flight transactions queued, they will be resent in submit order.
+// Returns false when the retries are used up.
+static bool retry (void)
+{
+    uint_fast8_t idx;
+    modbus_sched_stats_t *stats;
+
+    if(in_flight.members[0]->retries >= MODBUS_SCHED_RETRIES)
+        return false;
+
+    for(idx = 0; idx < in_flight.n_members; idx++)
+        in_flight.members[idx]->retries++;
+
+    if((stats = get_stats(in_flight.members[0]->device, true)))
+        stats->retries++;
+
+    in_flight.busy = false;
+
+    return true;
+}
+
+// Passes the response to the handlers of the in flight transactions and dequeues them.
+static void complete (modbus_response_t *response)
+{
+    uint_fast8_t idx;
+    uint32_t latency, ms = hal.get_elapsed_ticks();
+    modbus_sched_stats_t *stats = get_stats(in_flight.members[0]->device, true);
+    bool timeout = response->exception == ModBus_Timeout;
+
+    if(stats)
+        stats->coalesced += in_flight.n_members - 1;
+
+    for(idx = 0; idx < in_flight.n_members; idx++) {
+
+        transaction_t *t = in_flight.members[idx];
+        modbus_sched_response_ptr handler = t->handler;
+        void *context = t->context;
+        modbus_response_t member_response;
+
+        memcpy(&member_response, response, sizeof(modbus_response_t));
+
+        if(!response->exception && is_register_read(t->function)) {
+            member_response.num_values = t->n_registers;
+            memcpy(member_response.values, &response->values[t->address - in_flight.address], t->n_registers * sizeof(uint16_t));
+        }
+
+        if(stats) {
+            stats->transactions++;
+            if(timeout)
+                stats->timeouts++;
+            else if(response->exception)
+                stats->exceptions++;
+            latency = ms - t->submitted;
+            stats->latency_sum += latency;
+            if(latency > stats->latency_max)
+                stats->latency_max = latency;
+        }
+
+        t->queued = false;
+
+        if(handler)
+            handler(&member_response, context);
+    }
+
+    in_flight.busy = false;
+    dispatch();
+}
+
+static void response_handler (modbus_response_t *response)
+{
+    if(response->exception == ModBus_Timeout && retry())
+        dispatch();
+    else
+        complete(response);
+}
+
+static void dispatch (void)
+{
+    bool merged;
+    uint_fast8_t idx;
+    uint16_t end;
+    transaction_t *next = NULL;
+
+    if(in_flight.busy)
+        return;
+
+    for(idx = 0; idx < MODBUS_SCHED_QUEUE_SIZE; idx++) {
+        if(queue[idx].queued && (next == NULL || queue[idx].priority < next->priority || (queue[idx].priority == next->priority && (int32_t)(queue[idx].seq - next->seq) < 0)))
+            next = &queue[idx];
+    }
+
+    if(next == NULL)
+        return;
+
+    in_flight.members[0] = next;
+    in_flight.n_members = 1;
+    in_flight.address = next->address;
+    end = next->address + next->n_registers;
+
+    if(is_register_read(next->function)) do {
+
+        merged = false;
+
+        for(idx = 0; idx < MODBUS_SCHED_QUEUE_SIZE; idx++) {
+
+            transaction_t *t = &queue[idx];
+
+            if(t->queued && t != next && t->device == next->device && t->function == next->function &&
+                t->address <= end && t->address + t->n_registers >= in_flight.address) {
+
+                uint_fast8_t member = in_flight.n_members;
+                uint16_t address = min(in_flight.address, t->address), t_end = max(end, t->address + t->n_registers);
+
+                while(member && in_flight.members[member - 1] != t)
+                    member--;
+
+                if(member == 0 && t_end - address <= MODBUS_SCHED_MAX_REGISTERS && t_end - address <= RESPONSE_VALUES) {
+                    in_flight.members[in_flight.n_members++] = t;
+                    in_flight.address = address;
+                    end = t_end;
+                    merged = true;
+                }
+            }
+        }
+    } while(merged);
+
+    in_flight.busy = true;
+
+    // If the bus is not available the request is retried on the next poll, it fails as a timeout when the retries are used up.
+    if(modbus_message(next->device, next->function, in_flight.address, next->values, end - in_flight.address, response_handler) != Status_OK && !retry()) {
+
+        modbus_response_t response = {0};
+
+        response.device = next->device;
+        response.function = next->function;
+        response.exception = ModBus_Timeout;
+
+        complete(&response);
+    }
+}
+
+static void poll_response (modbus_response_t *response, void *context)
+{
+    poll_t *poll = (poll_t *)context;
+
+    poll->pending = false;
+
+    if(poll->handler)
+        poll->handler(response, poll->context);
+}
+
+static void onExecuteRealtime (sys_state_t state)
+{
+    on_execute_realtime(state);
+
+    if(!in_flight.busy) {
+
+        uint_fast8_t idx;
+        uint32_t ms = hal.get_elapsed_ticks();
+
+        for(idx = 0; idx < MODBUS_SCHED_POLLS; idx++) {
+            if(polls[idx].interval && !polls[idx].pending && (int32_t)(ms - polls[idx].next_due) >= 0) {
+                polls[idx].next_due = ms + polls[idx].interval;
+                polls[idx].pending = modbus_sched_submit(polls[idx].device, polls[idx].function, polls[idx].address, NULL, polls[idx].n_registers,
+                                                          ModbusPriority_Background, poll_response, &polls[idx]);
+            }
+        }
+
+        dispatch();
+    }
+}
+
+bool modbus_sched_submit (uint8_t device, modbus_function_t function, uint16_t address, uint16_t *values, uint16_t n_registers, modbus_priority_t priority, modbus_sched_response_ptr handler, void *context)
+{
+    uint_fast8_t idx = MODBUS_SCHED_QUEUE_SIZE;
+    transaction_t *t = NULL;
+
+    if(n_registers > MODBUS_SCHED_MAX_REGISTERS || (is_register_read(function) && n_registers > RESPONSE_VALUES))
+        return false;
+
+    // Write multiple registers request ADU: address, function, register address, count, byte count, 2 bytes per register and CRC.
+    if(function == ModBus_WriteRegisters && 9 + 2 * n_registers > MODBUS_MAX_ADU_SIZE)
+        return false;
+
+    do {
+        if(!queue[--idx].queued)
+            t = &queue[idx];
+    } while(idx);
+
+    if(t) {
+
+        memset(t, 0, sizeof(transaction_t));
+
+        t->device = device;
+        t->function = function;
+        t->priority = priority;
+        t->address = address;
+        t->n_registers = n_registers;
+        t->seq = seq++;
+        t->submitted = hal.get_elapsed_ticks();
+        t->handler = handler;
+        t->context = context;
+        if(values)
+            memcpy(t->values, values, n_registers * sizeof(uint16_t));
+        t->queued = true;
+
+        dispatch();
+    }
+
+    return t != NULL;
+}
+
+bool modbus_sched_poll_add (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, uint16_t interval, modbus_sched_response_ptr handler, void *context)
+{
+    uint_fast8_t idx;
+
+    if(interval == 0 || n_registers > MODBUS_SCHED_MAX_REGISTERS || n_registers > RESPONSE_VALUES)
+        return false;
+
+    for(idx = 0; idx < MODBUS_SCHED_POLLS; idx++) {
+        if(polls[idx].interval == 0) {
+            polls[idx].device = device;
+            polls[idx].function = function;
+            polls[idx].address = address;
+            polls[idx].n_registers = n_registers;
+            polls[idx].handler = handler;
+            polls[idx].context = context;
+            polls[idx].pending = false;
+            polls[idx].next_due = hal.get_elapsed_ticks();
+            polls[idx].interval = interval;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void modbus_sched_poll_remove (modbus_sched_response_ptr handler, void *context)
+{
+    uint_fast8_t idx;
+
+    for(idx = 0; idx < MODBUS_SCHED_POLLS; idx++) {
+        if(polls[idx].handler == handler && polls[idx].context == context) {
+            polls[idx].interval = 0;
+            polls[idx].handler = NULL; // a pending response is dropped
+        }
+    }
+}
+
+modbus_sched_stats_t *modbus_sched_get_stats (uint8_t device)
+{
+    return get_stats(device, false);
+}
+
+void modbus_sched_report_stats (void)
+{
+    uint_fast8_t idx;
+
+    for(idx = 0; idx < n_devices; idx++) {
+
+        modbus_sched_stats_t *stats = &devices[idx].stats;
+
+        hal.stream.write("[MODBUSSTATS:");
+        hal.stream.write(uitoa(devices[idx].device));
+        hal.stream.write(",");
+        hal.stream.write(uitoa(stats->transactions));
+        hal.stream.write(",");
+        hal.stream.write(uitoa(stats->timeouts));
+        hal.stream.write(",");
+        hal.stream.write(uitoa(stats->retries));
+        hal.stream.write(",");
+        hal.stream.write(uitoa(stats->exceptions));
+        hal.stream.write(",");
+        hal.stream.write(uitoa(stats->coalesced));
+        hal.stream.write(",");
+        hal.stream.write(uitoa(stats->transactions ? stats->latency_sum / stats->transactions : 0));
+        hal.stream.write(",");
+        hal.stream.write(uitoa(stats->latency_max));
+        hal.stream.write("]" ASCII_EOL);
+    }
+}
+
+void modbus_sched_init (void)
+{
+    static bool init_ok = false;
+
+    if(!init_ok) {
+        init_ok = true;
+        on_execute_realtime = grbl.on_execute_realtime;
+        grbl.on_execute_realtime = onExecuteRealtime;
+    }
+}
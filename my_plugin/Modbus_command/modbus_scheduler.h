@@ -0,0 +1,102 @@
+/*
+
+  modbus_scheduler.h - prioritized Modbus transaction scheduler
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _MODBUS_SCHEDULER_H_
+#define _MODBUS_SCHEDULER_H_
+
+#include "grbl/modbus.h"
+
+#ifndef MODBUS_SCHED_QUEUE_SIZE
+#define MODBUS_SCHED_QUEUE_SIZE     8   // max. number of pending transactions
+#endif
+#ifndef MODBUS_SCHED_POLLS
+#define MODBUS_SCHED_POLLS          4   // max. number of background polls
+#endif
+#ifndef MODBUS_SCHED_DEVICES
+#define MODBUS_SCHED_DEVICES        4   // max. number of devices statistics are kept for
+#endif
+// Register read response ADU: address, function, byte count, 2 bytes per register and CRC.
+#define MODBUS_ADU_MAX_REGISTERS ((MODBUS_MAX_ADU_SIZE - 5) / 2)
+
+#ifndef MODBUS_SCHED_MAX_REGISTERS
+#define MODBUS_SCHED_MAX_REGISTERS  MODBUS_ADU_MAX_REGISTERS // max. number of registers in a single request, coalesced reads included
+#endif
+#ifndef MODBUS_SCHED_RETRIES
+#define MODBUS_SCHED_RETRIES        2   // number of retries on timeout
+#endif
+
+typedef enum {
+    ModbusPriority_Urgent = 0,  //!< jumps ahead of queued transactions, e.g. spindle stop
+    ModbusPriority_Normal,
+    ModbusPriority_Background   //!< only sent when nothing else is pending
+} modbus_priority_t;
+
+/*! \brief Pointer to function for receiving the response of a scheduled transaction.
+\param response pointer to a \a modbus_response_t struct, values are for the requested registers only.
+\param context the context pointer passed when the transaction was submitted.
+*/
+typedef void (*modbus_sched_response_ptr)(modbus_response_t *response, void *context);
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t timeouts;
+    uint32_t retries;
+    uint32_t exceptions;
+    uint32_t coalesced;     //!< number of reads merged into other requests
+    uint32_t latency_sum;   //!< milliseconds, from submit to response
+    uint32_t latency_max;   //!< milliseconds
+} modbus_sched_stats_t;
+
+/*! \brief Queue a transaction.
+\param device Modbus server address.
+\param function Modbus function.
+\param address register address.
+\param values pointer to values to write, may be NULL for reads.
+\param n_registers number of registers to read or write, max MODBUS_SCHED_MAX_REGISTERS and less for writes
+of multiple registers as the request ADU also holds the byte count and the register address and count.
+\param priority transaction priority.
+\param handler pointer to response handler, may be NULL.
+\param context pointer passed to the handler.
+\returns true if queued, false if the queue is full or the request is invalid.
+*/
+bool modbus_sched_submit (uint8_t device, modbus_function_t function, uint16_t address, uint16_t *values, uint16_t n_registers, modbus_priority_t priority, modbus_sched_response_ptr handler, void *context);
+
+/*! \brief Add a rate limited background read that is repeated every interval milliseconds.
+\returns true if added, false if no poll slot is available.
+*/
+bool modbus_sched_poll_add (uint8_t device, modbus_function_t function, uint16_t address, uint16_t n_registers, uint16_t interval, modbus_sched_response_ptr handler, void *context);
+
+/*! \brief Remove background reads added with the same handler and context. */
+void modbus_sched_poll_remove (modbus_sched_response_ptr handler, void *context);
+
+/*! \brief Get statistics for a device.
+\returns pointer to a \a modbus_sched_stats_t struct, NULL if no transactions has been sent to the device.
+*/
+modbus_sched_stats_t *modbus_sched_get_stats (uint8_t device);
+
+/*! \brief Output statistics for all devices to the current stream. */
+void modbus_sched_report_stats (void);
+
+void modbus_sched_init (void);
+
+#endif
@@ -23,7 +23,7 @@
 
 /*
 
-This plugin implements the $MODBUSCMD and $MODBUSDBG system commands.
+This plugin implements the $MODBUSCMD, $MODBUSDBG, $MODBUSDUMP and $MODBUSSTATS system commands.
 
 The following Modbus functions are supported with the following syntax:
 
@@ -44,6 +44,10 @@ Returns exception status
 Functions 15-16, write many:
 $MODBUSCMD=<modbus address>,<function>,<register address base>,<value>{,<value>{,<value>}}
 
+Functions 3-4, cached read:
+$MODBUSCMD=C,<modbus address>,<function>,<register address base>{,<number of registers>}
+Returns values from the register cache if not older than MODBUS_CACHE_MAX_AGE, on a miss the registers are read.
+
 Both decimal and hexadecimal arguments can be used. Some examples:
 
 $MODBUSCMD=1,4,0,2          // Read status register from a H100 VFD
@@ -52,12 +56,27 @@ $MODBUSCMD=1,6,0x0201,1000  // Set frequency register on a H100 VFD
 
 ---
 
-$MODBUSDBG - enable debug output, this outputs messages containing the transmitted and received data, an example:
+$MODBUSDBG - enable capture of transmitted and received data to a ring buffer of MODBUS_CAPTURE_FRAMES frames.
+
+$MODBUSDBG=0 - disable capture.
+
+$MODBUSDUMP - output and clear the captured frames, oldest first, an example:
 
-[MSG:TX: 01 03 21 03 00 01 7E 36]
-[MSG:RX: 01 03 02 00 00 B8 44]
+[MODBUSDUMP:1204331|TX: 01 03 21 03 00 01 7E 36]
+[MODBUSDUMP:1210786|RX: 01 03 02 00 00 B8 44]
 
-$MODBUSDBG=0 - disable debug output.
+The timestamp is in microseconds, or milliseconds if the driver does not provide a microseconds timer.
+If the ring overflows the oldest frames are dropped and the number of dropped frames is reported as [MODBUSDUMP:lost <n>].
+
+---
+
+$MODBUSSTATS - output statistics per device and for the register cache:
+
+[MODBUSSTATS:<device>,<transactions>,<timeouts>,<retries>,<exceptions>,<coalesced reads>,<avg latency ms>,<max latency ms>]
+[MODBUSCACHE:<hits>,<misses>,<stale>,<refreshes>,<cached registers>]
+
+Messages are sent via the transaction scheduler in modbus_scheduler.c, cached reads via modbus_cache.c.
+Both may be used by other plugins as well.
 
 */
 
@@ -65,46 +84,84 @@ $MODBUSDBG=0 - disable debug output.
 
 #include "grbl/hal.h"
 #include "grbl/modbus.h"
-#include "grbl/task.h"
+
+#include "modbus_scheduler.h"
+#include "modbus_cache.h"
+
+#ifndef MODBUS_CAPTURE_FRAMES
+#define MODBUS_CAPTURE_FRAMES 16 // number of frames in capture ring, must be a power of 2
+#endif
+#define MODBUS_CAPTURE_GAP    2  // milliseconds of silence ending a received frame when no transmit follows
+#define MODBUSCMD_MAX_REGISTERS 3 // max. number of registers read or written by $MODBUSCMD
+
+typedef struct {
+    uint32_t timestamp;
+    bool rx;
+    uint8_t len;
+    uint8_t adu[MODBUS_MAX_ADU_SIZE];
+} modbus_frame_t;
 
 static modbus_rtu_stream_t stream;
 
 static on_report_options_ptr on_report_options;
 
-struct {
-    uint_fast8_t idx;
-    uint8_t adu[MODBUS_MAX_ADU_SIZE];
-} modbus_rx;
+static struct {
+    volatile uint_fast8_t head;
+    volatile uint_fast8_t tail;
+    uint32_t rx_last;
+    uint32_t lost;
+    modbus_frame_t frame[MODBUS_CAPTURE_FRAMES];
+} capture = {0};
 
 // $MODBUSDBG
 
-static void modbus_rx_complete (void *data)
+// Frames are captured in place in the head slot, formatting is deferred to $MODBUSDUMP.
+
+static inline uint32_t capture_time (void)
 {
-    static char buf[3 * MODBUS_MAX_ADU_SIZE + 3] = "RX:";
+    return hal.get_micros ? hal.get_micros() : hal.get_elapsed_ticks();
+}
 
-    if(modbus_rx.idx) {
+static void capture_commit (void)
+{
+    uint_fast8_t next = (capture.head + 1) & (MODBUS_CAPTURE_FRAMES - 1);
 
-        uint_fast8_t idx;
-        char *p = buf + 3;
+    if(next == capture.tail) { // full, drop oldest frame
+        capture.tail = (capture.tail + 1) & (MODBUS_CAPTURE_FRAMES - 1);
+        capture.lost++;
+    }
 
-        for(idx = 0; idx < modbus_rx.idx; idx ++)
-            p += sprintf(p, " %02X", modbus_rx.adu[idx]);
+    capture.head = next;
+    capture.frame[next].len = 0;
+}
 
-        modbus_rx.idx = 0;
-        task_add_immediate(report_plain, buf);
-    }
+static inline void capture_rx_complete (void)
+{
+    if(capture.frame[capture.head].len)
+        capture_commit();
 }
 
 static int32_t modbus_read (void)
 {
     int32_t c = stream.read();
 
-    if(c != SERIAL_NO_DATA && modbus_rx.idx < MODBUS_MAX_ADU_SIZE) {
-        modbus_rx.adu[modbus_rx.idx++] = (uint8_t)c;
-        if(modbus_rx.idx > 3) {
-            task_delete(modbus_rx_complete, NULL);
-            task_add_delayed(modbus_rx_complete, NULL, 3);
+    if(c != SERIAL_NO_DATA) {
+
+        uint32_t ms = hal.get_elapsed_ticks();
+        modbus_frame_t *frame = &capture.frame[capture.head];
+
+        if(frame->len && (ms - capture.rx_last >= MODBUS_CAPTURE_GAP || frame->len == MODBUS_MAX_ADU_SIZE)) {
+            capture_commit();
+            frame = &capture.frame[capture.head];
+        }
+
+        if(frame->len == 0) {
+            frame->timestamp = capture_time();
+            frame->rx = true;
         }
+
+        frame->adu[frame->len++] = (uint8_t)c;
+        capture.rx_last = ms;
     }
 
     return c;
@@ -112,17 +169,19 @@ static int32_t modbus_read (void)
 
 static void modbus_write (const uint8_t *s, uint16_t len)
 {
-    static char buf[3 * MODBUS_MAX_ADU_SIZE + 3] = "TX:";
-
-    uint_fast8_t idx;
-    char *p = buf + 3;
+    modbus_frame_t *frame;
 
     stream.write(s, len);
 
-    for(idx = 0; idx < len; idx ++)
-        p += sprintf(p, " %02X", s[idx]);
+    capture_rx_complete();
+
+    frame = &capture.frame[capture.head];
+    frame->timestamp = capture_time();
+    frame->rx = false;
+    frame->len = len > MODBUS_MAX_ADU_SIZE ? MODBUS_MAX_ADU_SIZE : (uint8_t)len;
+    memcpy(frame->adu, s, frame->len);
 
-    task_add_immediate(report_plain, buf);
+    capture_commit();
 }
 
 static void modbus_set_direction (bool tx)
@@ -130,17 +189,15 @@ static void modbus_set_direction (bool tx)
     if(stream.set_direction)
         stream.set_direction(tx);
 
-    task_delete(modbus_rx_complete, NULL);
-
-    if(tx && modbus_rx.idx)
-        modbus_rx_complete(NULL);
+    if(tx)
+        capture_rx_complete();
 }
 
 static status_code_t modbus_debug (sys_state_t state, char *args)
 {
     modbus_rtu_stream_t *s;
 
-    if(*args == '0' && *(args + 1) == '\0') {
+    if(args && *args == '0' && *(args + 1) == '\0') {
         s = modbus_get_rtu_stream();
         if(s && s->read == modbus_read) {
             s->read = stream.read;
@@ -148,10 +205,14 @@ static status_code_t modbus_debug (sys_state_t state, char *args)
             s->set_direction = stream.set_direction;
             stream.read = NULL;
         }
-    } else if(*args == '\0' && stream.read == NULL && (s = modbus_get_rtu_stream())) {
+    } else if((args == NULL || *args == '\0') && stream.read == NULL && (s = modbus_get_rtu_stream())) {
 
         memcpy(&stream, s, sizeof(stream));
 
+        capture.head = capture.tail = 0;
+        capture.lost = 0;
+        capture.frame[0].len = 0;
+
         s->read = modbus_read;
         s->write = modbus_write;
         s->set_direction = modbus_set_direction;
@@ -160,9 +221,53 @@ static status_code_t modbus_debug (sys_state_t state, char *args)
     return Status_OK;
 }
 
+// $MODBUSDUMP
+
+static status_code_t modbus_dump (sys_state_t state, char *args)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    char buf[3 * MODBUS_MAX_ADU_SIZE + 1], *p;
+    uint_fast8_t idx;
+    modbus_frame_t *frame;
+
+    if(stream.read && hal.get_elapsed_ticks() - capture.rx_last >= MODBUS_CAPTURE_GAP)
+        capture_rx_complete();
+
+    while(capture.tail != capture.head) {
+
+        frame = &capture.frame[capture.tail];
+        p = buf;
+
+        for(idx = 0; idx < frame->len; idx++) {
+            *p++ = ' ';
+            *p++ = hex[frame->adu[idx] >> 4];
+            *p++ = hex[frame->adu[idx] & 0x0F];
+        }
+        *p = '\0';
+
+        hal.stream.write("[MODBUSDUMP:");
+        hal.stream.write(uitoa(frame->timestamp));
+        hal.stream.write(frame->rx ? "|RX:" : "|TX:");
+        hal.stream.write(buf);
+        hal.stream.write("]" ASCII_EOL);
+
+        capture.tail = (capture.tail + 1) & (MODBUS_CAPTURE_FRAMES - 1);
+    }
+
+    if(capture.lost) {
+        hal.stream.write("[MODBUSDUMP:lost ");
+        hal.stream.write(uitoa(capture.lost));
+        hal.stream.write("]" ASCII_EOL);
+        capture.lost = 0;
+    }
+
+    return Status_OK;
+}
+
 // $MODBUSCMD
 
-static void response_handler (modbus_response_t *response)
+static void response_handler (modbus_response_t *response, void *context)
 {
     char buf[100];
 
@@ -172,7 +277,7 @@ static void response_handler (modbus_response_t *response)
         sprintf(buf, "Modbus exception: %u", (uint16_t)response->exception);
     else {
         uint_fast8_t idx;
-        sprintf(buf, "Modbus: fn=%hu", response->function);
+        sprintf(buf, "%s: fn=%hu", context ? (char *)context : "Modbus", response->function);
         for(idx = 0; idx < response->num_values; idx++)
             sprintf(strchr(buf, '\0'), ",%hu(0x%0hx)", response->values[idx], response->values[idx]);
     }
@@ -183,25 +288,62 @@ static void response_handler (modbus_response_t *response)
 
 static status_code_t modbus_command (sys_state_t state, char *args)
 {
+    bool cached = false;
     status_code_t status;
-    int32_t argc, device, function, address, ivalues[3];
+    int argc;
+    long device, function, address, ivalues[MODBUSCMD_MAX_REGISTERS];
+
+    if(args && (*args == 'C' || *args == 'c') && *(args + 1) == ',') {
+        cached = true;
+        args += 2;
+    }
 
     if(!modbus_isup().ok)
         status = Status_BadNumberFormat;
-    else if((argc = sscanf(args, "%li,%li,%li,%li,%li", &device, &function, &address, &ivalues[0], &ivalues[1])) >= 2) {
+    else if((argc = sscanf(args, "%li,%li,%li,%li,%li,%li", &device, &function, &address, &ivalues[0], &ivalues[1], &ivalues[2])) >= 2) {
 
         const modbus_function_properties_t *fn = modbus_get_function_properties((modbus_function_t)function);
 
-        uint16_t values[3];
+        uint16_t values[MODBUSCMD_MAX_REGISTERS];
 
         values[0] = (uint16_t)ivalues[0];
         values[1] = (uint16_t)ivalues[1];
-        values[1] = (uint16_t)ivalues[2];
+        values[2] = (uint16_t)ivalues[2];
 
         if(fn == NULL || (function != ModBus_ReadExceptionStatus && argc < 3))
             status = Status_InvalidStatement;
+        else if(cached && !(fn->function == ModBus_ReadHoldingRegisters || fn->function == ModBus_ReadInputRegisters))
+            status = Status_InvalidStatement;
         else {
-            status = modbus_message((uint8_t)device, fn->function, (uint16_t)address, values, fn->single_register ? 1 : (fn->is_write ? argc - 3 : (argc == 3 ? 1 : values[0])), response_handler);
+
+            uint16_t n_registers = fn->single_register ? 1 : (fn->is_write ? argc - 3 : (argc == 3 ? 1 : values[0]));
+
+            if(n_registers > MODBUSCMD_MAX_REGISTERS)
+                return Status_InvalidStatement;
+
+            if(cached && modbus_cache_lookup((uint8_t)device, fn->function, (uint16_t)address, n_registers, values, MODBUS_CACHE_MAX_AGE)) {
+
+                modbus_response_t response = {
+                    .function = fn->function,
+                    .num_values = n_registers
+                };
+
+                memcpy(response.values, values, n_registers * sizeof(uint16_t));
+                response_handler(&response, (void *)"Modbus (cached)");
+
+                return Status_OK;
+            }
+
+            if(fn->is_write)
+                modbus_cache_invalidate((uint8_t)device, (uint16_t)address, n_registers);
+
+            // On a cache miss the read is done by the cache, the response refreshes it.
+            if(cached)
+                status = modbus_cache_fetch((uint8_t)device, fn->function, (uint16_t)address, n_registers,
+                                             response_handler, NULL) ? Status_OK : Status_InvalidStatement;
+            else
+                status = modbus_sched_submit((uint8_t)device, fn->function, (uint16_t)address, values, n_registers,
+                                              ModbusPriority_Normal, response_handler, NULL) ? Status_OK : Status_InvalidStatement;
         }
     } else
         status = Status_BadNumberFormat;
@@ -209,6 +351,16 @@ static status_code_t modbus_command (sys_state_t state, char *args)
     return status;
 }
 
+// $MODBUSSTATS
+
+static status_code_t modbus_stats (sys_state_t state, char *args)
+{
+    modbus_sched_report_stats();
+    modbus_cache_report_stats();
+
+    return Status_OK;
+}
+
 //
 
 static void onReportOptions (bool newopt)
@@ -218,14 +370,16 @@ static void onReportOptions (bool newopt)
     if(!newopt)
         report_plugin(modbus_isup().ok
                        ? "Modbus command"
-                       : "Modbus command (offline)", "0.01");
+                       : "Modbus command (offline)", "0.02");
 }
 
 void my_plugin_init (void)
 {
     static const sys_command_t command_list[] = {
         {"MODBUSCMD", modbus_command, { .allow_blocking = On }, { .str = "send Modbus message" } },
-        {"MODBUSDBG", modbus_debug, { .allow_blocking = On }, { .str = "send Modbus message" } }
+        {"MODBUSDBG", modbus_debug, { .allow_blocking = On }, { .str = "$MODBUSDBG[=0] - enable or disable Modbus traffic capture" } },
+        {"MODBUSDUMP", modbus_dump, { .noargs = On }, { .str = "output and clear captured Modbus traffic" } },
+        {"MODBUSSTATS", modbus_stats, { .noargs = On }, { .str = "output Modbus transaction statistics per device and cache statistics" } }
     };
 
     static sys_commands_t commands = {
@@ -237,4 +391,6 @@ void my_plugin_init (void)
     grbl.on_report_options = onReportOptions;
 
     system_register_commands(&commands);
+
+    modbus_sched_init();
 }
@@ -0,0 +1,117 @@
+/*
+
+  hal.h - host stand-in for the grblHAL core HAL, declares only what the Modbus command plugin uses
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _HAL_H_
+#define _HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define GRBL_BUILD 20250101
+
+#define ASCII_EOL "\r\n"
+
+#define SERIAL_NO_DATA -1
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#define On  1
+#define Off 0
+
+#define STATE_IDLE 0
+
+typedef uint_fast16_t sys_state_t;
+
+typedef enum {
+    Status_OK = 0,
+    Status_BadNumberFormat = 2,
+    Status_InvalidStatement = 3,
+    Status_Unhandled = 253
+} status_code_t;
+
+typedef enum {
+    Message_Plain = 0
+} message_type_t;
+
+typedef void (*stream_write_ptr)(const char *s);
+
+typedef struct {
+    stream_write_ptr write;
+} io_stream_t;
+
+typedef void (*on_execute_realtime_ptr)(sys_state_t state);
+typedef void (*on_report_options_ptr)(bool newopt);
+
+typedef struct {
+    io_stream_t stream;
+    uint32_t (*get_elapsed_ticks)(void);
+    uint32_t (*get_micros)(void);
+} grbl_hal_t;
+
+typedef struct {
+    on_execute_realtime_ptr on_execute_realtime;
+    on_report_options_ptr on_report_options;
+} grbl_t;
+
+extern grbl_hal_t hal;
+extern grbl_t grbl;
+
+typedef status_code_t (*sys_command_ptr)(sys_state_t state, char *args);
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t noargs         :1,
+                allow_blocking :1;
+    };
+} sysflags_t;
+
+typedef union {
+    const char *str;
+} sys_help_t;
+
+typedef struct {
+    const char *command;
+    sys_command_ptr execute;
+    sysflags_t flags;
+    sys_help_t help;
+} sys_command_t;
+
+typedef struct sys_commands_str {
+    uint8_t n_commands;
+    const sys_command_t *commands;
+    struct sys_commands_str *next;
+} sys_commands_t;
+
+void system_register_commands (sys_commands_t *commands);
+
+char *uitoa (uint32_t n);
+void report_message (const char *msg, message_type_t type);
+void report_plugin (const char *name, const char *version);
+
+#endif
@@ -0,0 +1,89 @@
+/*
+
+  modbus.h - host stand-in for the grblHAL core Modbus API, declares only what the Modbus command plugin uses
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _MODBUS_H_
+#define _MODBUS_H_
+
+#include "hal.h"
+
+#ifndef MODBUS_MAX_ADU_SIZE
+#define MODBUS_MAX_ADU_SIZE 32
+#endif
+
+typedef enum {
+    ModBus_ReadCoils = 1,
+    ModBus_ReadDiscreteInputs = 2,
+    ModBus_ReadHoldingRegisters = 3,
+    ModBus_ReadInputRegisters = 4,
+    ModBus_WriteCoil = 5,
+    ModBus_WriteRegister = 6,
+    ModBus_ReadExceptionStatus = 7,
+    ModBus_Diagnostics = 8,
+    ModBus_WriteCoils = 15,
+    ModBus_WriteRegisters = 16
+} modbus_function_t;
+
+typedef enum {
+    ModBus_NoException = 0,
+    ModBus_IllegalFunction = 1,
+    ModBus_IllegalDataAddress = 2,
+    ModBus_IllegalDataValue = 3,
+    ModBus_SlaveDeviceFailure = 4,
+    ModBus_Timeout = 0xFF
+} modbus_exception_t;
+
+typedef struct {
+    uint8_t device;
+    modbus_function_t function;
+    modbus_exception_t exception;
+    uint8_t num_values;
+    uint16_t values[(MODBUS_MAX_ADU_SIZE - 5) / 2];
+} modbus_response_t;
+
+typedef void (*modbus_response_ptr)(modbus_response_t *response);
+
+typedef struct {
+    modbus_function_t function;
+    bool single_register;
+    bool is_write;
+} modbus_function_properties_t;
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t ok :1;
+    };
+} modbus_status_t;
+
+typedef struct {
+    int32_t (*read)(void);
+    void (*write)(const uint8_t *s, uint16_t len);
+    void (*set_direction)(bool tx);
+} modbus_rtu_stream_t;
+
+status_code_t modbus_message (uint8_t device, modbus_function_t function, uint16_t address, uint16_t *values, uint16_t registers, modbus_response_ptr handler);
+modbus_status_t modbus_isup (void);
+const modbus_function_properties_t *modbus_get_function_properties (modbus_function_t function);
+modbus_rtu_stream_t *modbus_get_rtu_stream (void);
+
+#endif
@@ -0,0 +1,553 @@
+/*
+
+  host.c - host build of the Modbus command plugin, RTU bus on a pseudo terminal
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+The plugin talks to the RTU client below, which frames requests as RTU ADUs with CRC and writes them to
+the master side of a pseudo terminal. The simulated server reads the requests from the slave side in raw
+mode and writes the responses back, so requests and responses pass through the kernel byte by byte as
+on a serial line. Both ends are serviced from the realtime loop, the clock is the monotonic system clock.
+
+Like the core only one transaction can be in flight, modbus_message() fails while waiting for a response.
+Broadcasts (device 0) are not answered, the response handler is called when the request is sent.
+
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <time.h>
+
+#include "host.h"
+
+extern void my_plugin_init (void);
+
+grbl_hal_t hal;
+grbl_t grbl;
+host_server_t host_server;
+char host_output[4096];
+
+static int master = -1, slave = -1;
+static struct timespec t0;
+static sys_commands_t *commands = NULL;
+static modbus_rtu_stream_t rtu_stream;
+
+static struct {
+    bool busy;
+    bool broadcast;
+    uint8_t device;
+    modbus_function_t function;
+    modbus_response_ptr handler;
+    uint32_t sent;
+    uint_fast8_t rx_len;
+    uint8_t rx[MODBUS_MAX_ADU_SIZE];
+} client = {0};
+
+static struct {
+    uint_fast8_t rx_len;
+    uint8_t rx[MODBUS_MAX_ADU_SIZE + 16];
+    uint_fast8_t tx_len;
+    uint8_t tx[MODBUS_MAX_ADU_SIZE];
+    uint32_t tx_due;
+} server = {0};
+
+// Core stand-ins
+
+static uint32_t get_elapsed_ticks (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (uint32_t)((t.tv_sec - t0.tv_sec) * 1000 + (t.tv_nsec - t0.tv_nsec) / 1000000);
+}
+
+static void output (const char *s)
+{
+    strncat(host_output, s, sizeof(host_output) - strlen(host_output) - 1);
+}
+
+char *uitoa (uint32_t n)
+{
+    static char buf[12];
+
+    sprintf(buf, "%u", n);
+
+    return buf;
+}
+
+void report_message (const char *msg, message_type_t type)
+{
+    output("[MSG:");
+    output(msg);
+    output("]" ASCII_EOL);
+}
+
+void report_plugin (const char *name, const char *version)
+{
+}
+
+void system_register_commands (sys_commands_t *list)
+{
+    list->next = commands;
+    commands = list;
+}
+
+static void execute_realtime (sys_state_t state)
+{
+}
+
+static void report_options (bool newopt)
+{
+}
+
+// CRC-16/MODBUS
+
+static uint16_t crc16 (const uint8_t *buf, uint_fast8_t len)
+{
+    uint_fast8_t bit;
+    uint16_t crc = 0xFFFF;
+
+    while(len--) {
+        crc ^= *buf++;
+        for(bit = 0; bit < 8; bit++)
+            crc = crc & 1 ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+
+    return crc;
+}
+
+static uint_fast8_t add_crc (uint8_t *adu, uint_fast8_t len)
+{
+    uint16_t crc = crc16(adu, len);
+
+    adu[len++] = crc & 0xFF;
+    adu[len++] = crc >> 8;
+
+    return len;
+}
+
+static bool crc_ok (const uint8_t *adu, uint_fast8_t len)
+{
+    uint16_t crc = crc16(adu, len - 2);
+
+    return adu[len - 2] == (crc & 0xFF) && adu[len - 1] == (crc >> 8);
+}
+
+// RTU stream, the master side of the pseudo terminal
+
+static int32_t rtu_read (void)
+{
+    uint8_t c;
+
+    return read(master, &c, 1) == 1 ? (int32_t)c : SERIAL_NO_DATA;
+}
+
+static void rtu_write (const uint8_t *s, uint16_t len)
+{
+    if(write(master, s, len) != len)
+        fprintf(stderr, "pty write failed\n");
+}
+
+modbus_rtu_stream_t *modbus_get_rtu_stream (void)
+{
+    return &rtu_stream;
+}
+
+modbus_status_t modbus_isup (void)
+{
+    modbus_status_t status = { .ok = master >= 0 };
+
+    return status;
+}
+
+const modbus_function_properties_t *modbus_get_function_properties (modbus_function_t function)
+{
+    static const modbus_function_properties_t functions[] = {
+        { ModBus_ReadCoils, false, false },
+        { ModBus_ReadDiscreteInputs, false, false },
+        { ModBus_ReadHoldingRegisters, false, false },
+        { ModBus_ReadInputRegisters, false, false },
+        { ModBus_WriteCoil, true, true },
+        { ModBus_WriteRegister, true, true },
+        { ModBus_ReadExceptionStatus, true, false },
+        { ModBus_WriteCoils, false, true },
+        { ModBus_WriteRegisters, false, true }
+    };
+
+    uint_fast8_t idx;
+
+    for(idx = 0; idx < sizeof(functions) / sizeof(functions[0]); idx++) {
+        if(functions[idx].function == function)
+            return &functions[idx];
+    }
+
+    return NULL;
+}
+
+// RTU client
+
+status_code_t modbus_message (uint8_t device, modbus_function_t function, uint16_t address, uint16_t *values, uint16_t registers, modbus_response_ptr handler)
+{
+    uint8_t adu[MODBUS_MAX_ADU_SIZE];
+    uint_fast8_t len = 0, idx;
+
+    if(client.busy)
+        return Status_Unhandled;
+
+    adu[len++] = device;
+    adu[len++] = (uint8_t)function;
+
+    switch(function) {
+
+        case ModBus_ReadExceptionStatus:
+            break;
+
+        case ModBus_WriteCoil:
+        case ModBus_WriteRegister:
+            adu[len++] = address >> 8;
+            adu[len++] = address & 0xFF;
+            adu[len++] = function == ModBus_WriteCoil ? (values[0] ? 0xFF : 0) : values[0] >> 8;
+            adu[len++] = function == ModBus_WriteCoil ? 0 : values[0] & 0xFF;
+            break;
+
+        case ModBus_WriteRegisters:
+            if(9 + 2 * registers > MODBUS_MAX_ADU_SIZE)
+                return Status_InvalidStatement;
+            adu[len++] = address >> 8;
+            adu[len++] = address & 0xFF;
+            adu[len++] = registers >> 8;
+            adu[len++] = registers & 0xFF;
+            adu[len++] = registers * 2;
+            for(idx = 0; idx < registers; idx++) {
+                adu[len++] = values[idx] >> 8;
+                adu[len++] = values[idx] & 0xFF;
+            }
+            break;
+
+        default:
+            adu[len++] = address >> 8;
+            adu[len++] = address & 0xFF;
+            adu[len++] = registers >> 8;
+            adu[len++] = registers & 0xFF;
+            break;
+    }
+
+    len = add_crc(adu, len);
+
+    client.busy = true;
+    client.broadcast = device == 0;
+    client.device = device;
+    client.function = function;
+    client.handler = handler;
+    client.rx_len = 0;
+    client.sent = hal.get_elapsed_ticks();
+
+    rtu_stream.write(adu, len);
+
+    return Status_OK;
+}
+
+static void client_done (modbus_response_t *response)
+{
+    modbus_response_ptr handler = client.handler;
+
+    client.busy = false;
+
+    if(handler)
+        handler(response);
+}
+
+// Returns the expected length of the response in the receive buffer, 0 if not yet known.
+static uint_fast8_t response_length (void)
+{
+    if(client.rx_len < 3)
+        return 0;
+
+    if(client.rx[1] & 0x80)
+        return 5;
+
+    switch(client.rx[1]) {
+
+        case ModBus_ReadCoils:
+        case ModBus_ReadDiscreteInputs:
+        case ModBus_ReadHoldingRegisters:
+        case ModBus_ReadInputRegisters:
+            return 5 + client.rx[2];
+
+        case ModBus_ReadExceptionStatus:
+            return 5;
+
+        default:
+            return 8;
+    }
+}
+
+static void client_poll (void)
+{
+    int32_t c;
+    uint_fast8_t len, idx;
+    modbus_response_t response = {0};
+
+    if(!client.busy)
+        return;
+
+    response.device = client.device;
+    response.function = client.function;
+
+    if(client.broadcast) {
+        client_done(&response);
+        return;
+    }
+
+    while((c = rtu_stream.read()) != SERIAL_NO_DATA) {
+        if(client.rx_len < sizeof(client.rx))
+            client.rx[client.rx_len++] = (uint8_t)c;
+    }
+
+    if((len = response_length()) && client.rx_len >= len) {
+
+        if(!crc_ok(client.rx, len) || client.rx[0] != client.device || (client.rx[1] & 0x7F) != client.function)
+            response.exception = ModBus_SlaveDeviceFailure;
+        else if(client.rx[1] & 0x80)
+            response.exception = (modbus_exception_t)client.rx[2];
+        else if(client.function == ModBus_ReadHoldingRegisters || client.function == ModBus_ReadInputRegisters) {
+            response.num_values = client.rx[2] / 2;
+            for(idx = 0; idx < response.num_values; idx++)
+                response.values[idx] = (client.rx[3 + idx * 2] << 8) | client.rx[4 + idx * 2];
+        } else if(client.function == ModBus_ReadExceptionStatus) {
+            response.num_values = 1;
+            response.values[0] = client.rx[2];
+        }
+
+        client_done(&response);
+
+    } else if(hal.get_elapsed_ticks() - client.sent >= HOST_TIMEOUT) {
+        response.exception = ModBus_Timeout;
+        client_done(&response);
+    }
+}
+
+// Simulated server, the slave side of the pseudo terminal
+
+// Returns the length of the request in the receive buffer, 0 if not yet known.
+static uint_fast8_t request_length (void)
+{
+    if(server.rx_len < 2)
+        return 0;
+
+    switch(server.rx[1]) {
+
+        case ModBus_ReadExceptionStatus:
+            return 4;
+
+        case ModBus_WriteCoils:
+        case ModBus_WriteRegisters:
+            return server.rx_len < 7 ? 0 : 9 + server.rx[6];
+
+        default:
+            return 8;
+    }
+}
+
+static uint_fast8_t server_exception (uint8_t *adu, modbus_exception_t exception)
+{
+    adu[1] |= 0x80;
+    adu[2] = (uint8_t)exception;
+
+    return 3;
+}
+
+// Executes the request in the receive buffer and builds the response in tx, returns the response length.
+static uint_fast8_t server_execute (void)
+{
+    uint8_t *adu = server.tx;
+    uint_fast8_t len, idx;
+    uint16_t address = (server.rx[2] << 8) | server.rx[3], count = (server.rx[4] << 8) | server.rx[5];
+
+    adu[0] = server.rx[0];
+    adu[1] = server.rx[1];
+
+    host_server.last_device = server.rx[0];
+    host_server.last_function = server.rx[1];
+    host_server.last_address = address;
+    host_server.last_count = server.rx[1] == ModBus_WriteRegister ? 1 : count;
+
+    switch(server.rx[1]) {
+
+        case ModBus_ReadHoldingRegisters:
+        case ModBus_ReadInputRegisters:
+            if(count == 0 || 5 + count * 2 > MODBUS_MAX_ADU_SIZE)
+                return server_exception(adu, ModBus_IllegalDataValue);
+            if(address + count > HOST_REGISTERS)
+                return server_exception(adu, ModBus_IllegalDataAddress);
+            len = 2;
+            adu[len++] = count * 2;
+            for(idx = 0; idx < count; idx++) {
+                adu[len++] = host_server.registers[address + idx] >> 8;
+                adu[len++] = host_server.registers[address + idx] & 0xFF;
+            }
+            return len;
+
+        case ModBus_WriteRegister:
+            if(address >= HOST_REGISTERS)
+                return server_exception(adu, ModBus_IllegalDataAddress);
+            host_server.registers[address] = count;
+            memcpy(adu, server.rx, 6);
+            return 6;
+
+        case ModBus_WriteRegisters:
+            if(address + count > HOST_REGISTERS)
+                return server_exception(adu, ModBus_IllegalDataAddress);
+            for(idx = 0; idx < count; idx++)
+                host_server.registers[address + idx] = (server.rx[7 + idx * 2] << 8) | server.rx[8 + idx * 2];
+            memcpy(adu, server.rx, 6);
+            return 6;
+
+        case ModBus_ReadExceptionStatus:
+            adu[2] = 0;
+            return 3;
+
+        default:
+            return server_exception(adu, ModBus_IllegalFunction);
+    }
+}
+
+static void server_poll (void)
+{
+    uint8_t c;
+    uint_fast8_t len;
+
+    if(server.tx_len && (int32_t)(hal.get_elapsed_ticks() - server.tx_due) >= 0) {
+        if(write(slave, server.tx, server.tx_len) != server.tx_len)
+            fprintf(stderr, "pty write failed\n");
+        server.tx_len = 0;
+    }
+
+    while(read(slave, &c, 1) == 1) {
+        if(server.rx_len < sizeof(server.rx))
+            server.rx[server.rx_len++] = c;
+    }
+
+    if((len = request_length()) && server.rx_len >= len) {
+
+        if(!crc_ok(server.rx, len))
+            host_server.crc_errors++;
+        else {
+            host_server.requests++;
+            if(server.rx[0] && server.rx[0] != host_server.silent_device) {
+                server.tx_len = add_crc(server.tx, server_execute());
+                server.tx_due = hal.get_elapsed_ticks() + host_server.delay;
+            } else if(server.rx[0] == 0)
+                server_execute();
+        }
+
+        // A client sends the next request only after the response or a timeout, the buffer holds one request.
+        server.rx_len = 0;
+    }
+}
+
+// Test interface
+
+void host_run (uint32_t ms)
+{
+    uint32_t start = hal.get_elapsed_ticks();
+
+    do {
+        server_poll();
+        client_poll();
+        grbl.on_execute_realtime(STATE_IDLE);
+        usleep(100);
+    } while(hal.get_elapsed_ticks() - start < ms);
+}
+
+bool host_run_until (volatile uint32_t *counter, uint32_t count, uint32_t timeout)
+{
+    uint32_t start = hal.get_elapsed_ticks();
+
+    while(*counter < count) {
+        if(hal.get_elapsed_ticks() - start >= timeout)
+            return false;
+        host_run(0);
+    }
+
+    return true;
+}
+
+status_code_t host_command (const char *command, const char *args)
+{
+    static char buf[256];
+
+    uint_fast8_t idx;
+    sys_commands_t *list = commands;
+
+    host_output[0] = '\0';
+
+    while(list) {
+        for(idx = 0; idx < list->n_commands; idx++) {
+            if(!strcmp(list->commands[idx].command, command)) {
+                if(args)
+                    strcpy(buf, args);
+                return list->commands[idx].execute(STATE_IDLE, args ? buf : NULL);
+            }
+        }
+        list = list->next;
+    }
+
+    return Status_Unhandled;
+}
+
+void host_init (void)
+{
+    struct termios tio;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    hal.get_elapsed_ticks = get_elapsed_ticks;
+    hal.stream.write = output;
+
+    grbl.on_execute_realtime = execute_realtime;
+    grbl.on_report_options = report_options;
+
+    if((master = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(master) || unlockpt(master) ||
+        (slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0) {
+        perror("cannot open pseudo terminal");
+        exit(2);
+    }
+
+    // Raw mode, the line discipline must not translate or buffer the binary frames.
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+    rtu_stream.read = rtu_read;
+    rtu_stream.write = rtu_write;
+
+    my_plugin_init();
+}
@@ -0,0 +1,68 @@
+/*
+
+  host.h - host build of the Modbus command plugin, RTU bus on a pseudo terminal
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _HOST_H_
+#define _HOST_H_
+
+#include "grbl/hal.h"
+#include "grbl/modbus.h"
+
+/// Response timeout of the RTU client, milliseconds.
+#define HOST_TIMEOUT    50
+
+/// Number of registers of the simulated server, higher addresses are answered with an exception.
+#define HOST_REGISTERS  1024
+
+/// Simulated RTU server on the far end of the pseudo terminal, all devices share the register table.
+/// Function 3 and 4 read, 6 and 16 write the table.
+typedef struct {
+    uint16_t registers[HOST_REGISTERS];
+    uint8_t silent_device;      ///< device that does not respond, 0 for none
+    uint32_t delay;             ///< milliseconds from request to response
+    uint32_t requests;          ///< number of valid requests received, broadcasts included
+    uint32_t crc_errors;        ///< number of requests received with a bad CRC
+    uint8_t last_device;
+    uint8_t last_function;
+    uint16_t last_address;
+    uint16_t last_count;
+} host_server_t;
+
+extern host_server_t host_server;
+
+/// Output written to the current stream and by report_message(), cleared by host_command().
+extern char host_output[4096];
+
+/// Open the pseudo terminal and register the plugin.
+void host_init (void);
+
+/// Run the realtime loop for the given number of milliseconds.
+void host_run (uint32_t ms);
+
+/// Run the realtime loop until *counter reaches count.
+/// @returns false on timeout
+bool host_run_until (volatile uint32_t *counter, uint32_t count, uint32_t timeout);
+
+/// Execute a system command registered by the plugin, e.g. host_command("MODBUSCMD", "1,3,0").
+status_code_t host_command (const char *command, const char *args);
+
+#endif
@@ -0,0 +1,154 @@
+/*
+
+  test_cache.c - register cache tests against the simulated RTU server
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host.h"
+#include "modbus_cache.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) if(!(cond)) { failures++; fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); }
+
+static void reset (void)
+{
+    host_server.requests = 0;
+    host_server.delay = 0;
+    host_server.silent_device = 0;
+}
+
+// A $MODBUSCMD cached read on a miss is answered by a single read that also refreshes the cache.
+static void test_command (void)
+{
+    reset();
+    host_server.registers[40] = 1234;
+    host_server.delay = 5;
+
+    CHECK(host_command("MODBUSCMD", "C,1,3,40") == Status_OK, "$MODBUSCMD: cached read rejected");
+    host_run(30);
+    CHECK(host_server.requests == 1, "$MODBUSCMD: %u requests on a miss, expected 1", host_server.requests);
+    CHECK(strstr(host_output, "Modbus: fn=3,1234(0x4d2)"), "$MODBUSCMD: value not reported from the device\n%s", host_output);
+
+    CHECK(host_command("MODBUSCMD", "C,1,3,40") == Status_OK, "$MODBUSCMD: cached read rejected");
+    CHECK(strstr(host_output, "Modbus (cached): fn=3,1234(0x4d2)"), "$MODBUSCMD: value not reported from the cache\n%s", host_output);
+    host_run(10);
+    CHECK(host_server.requests == 1, "$MODBUSCMD: %u requests on a hit, expected 1", host_server.requests);
+}
+
+// A refresh in flight when the register is invalidated must not mark the old value as valid.
+static void test_invalidate (void)
+{
+    uint16_t value;
+
+    reset();
+    host_server.registers[50] = 1;
+    host_server.delay = 10;
+
+    CHECK(!modbus_cache_read(1, ModBus_ReadHoldingRegisters, 50, 1, &value, 1000), "invalidate: hit on empty cache");
+    host_run(3);
+
+    host_server.registers[50] = 2;
+    modbus_cache_invalidate(1, 50, 1);
+    host_run(30);
+
+    CHECK(host_server.requests == 1, "invalidate: %u requests, expected 1", host_server.requests);
+    CHECK(!modbus_cache_lookup(1, ModBus_ReadHoldingRegisters, 50, 1, &value, 1000), "invalidate: value %u read before the invalidate is valid", value);
+
+    CHECK(!modbus_cache_read(1, ModBus_ReadHoldingRegisters, 50, 1, &value, 1000), "invalidate: hit after invalidate");
+    host_run(30);
+    CHECK(modbus_cache_lookup(1, ModBus_ReadHoldingRegisters, 50, 1, &value, 1000) && value == 2, "invalidate: new value not cached");
+}
+
+// Watched registers recover from an invalidate by the next poll that was queued after it.
+static void test_watch (void)
+{
+    uint16_t value;
+
+    reset();
+    host_server.registers[60] = 10;
+
+    CHECK(modbus_cache_watch(2, ModBus_ReadInputRegisters, 60, 1, 40), "watch: not added");
+    host_run(30);
+    CHECK(modbus_cache_lookup(2, ModBus_ReadInputRegisters, 60, 1, &value, 40) && value == 10, "watch: value not cached");
+
+    host_server.registers[60] = 20;
+    modbus_cache_invalidate(2, 60, 1);
+    CHECK(!modbus_cache_lookup(2, ModBus_ReadInputRegisters, 60, 1, &value, 40), "watch: hit after invalidate");
+
+    host_run(60);
+    CHECK(modbus_cache_lookup(2, ModBus_ReadInputRegisters, 60, 1, &value, 40) && value == 20, "watch: new value not cached");
+}
+
+static uint32_t cached_registers (void)
+{
+    char *line;
+    unsigned int hits, misses, stale, refreshes, registers = 0;
+
+    host_command("MODBUSSTATS", NULL);
+    if((line = strstr(host_output, "[MODBUSCACHE:")))
+        sscanf(line, "[MODBUSCACHE:%u,%u,%u,%u,%u]", &hits, &misses, &stale, &refreshes, &registers);
+
+    return registers;
+}
+
+static void fetched (modbus_response_t *response, void *context)
+{
+}
+
+// A read that cannot be queued must not add cache entries, adding them could evict valid entries.
+static void test_no_refresh (void)
+{
+    uint_fast16_t idx;
+    uint16_t value, values[8];
+    uint32_t registers;
+
+    reset();
+    host_server.silent_device = 5;
+
+    // Fill the scheduler queue and the refresh slots with reads that do not complete.
+    for(idx = 0; idx < MODBUS_SCHED_QUEUE_SIZE + MODBUS_SCHED_POLLS && modbus_cache_fetch(5, ModBus_ReadHoldingRegisters, 200 + idx, 1, fetched, NULL); idx++);
+    for(idx = 0; idx < MODBUS_SCHED_POLLS && modbus_cache_watch(5, ModBus_ReadInputRegisters, 200 + idx, 1, 1000); idx++);
+
+    registers = cached_registers();
+    CHECK(registers + 8 > MODBUS_CACHE_REGISTERS, "no refresh: %u cached registers, the read will not evict", registers);
+
+    CHECK(!modbus_cache_read(1, ModBus_ReadHoldingRegisters, 300, 8, values, 1000), "no refresh: hit on empty cache");
+    CHECK(cached_registers() == registers, "no refresh: %u cached registers, expected %u", cached_registers(), registers);
+    CHECK(modbus_cache_lookup(1, ModBus_ReadHoldingRegisters, 40, 1, &value, 60000) && value == 1234, "no refresh: valid entry evicted");
+}
+
+int main (int argc, char **argv)
+{
+    host_init();
+
+    test_command();
+    test_invalidate();
+    test_watch();
+    test_no_refresh();
+
+    if(failures == 0)
+        printf("all cache tests passed\n");
+
+    return failures ? 1 : 0;
+}
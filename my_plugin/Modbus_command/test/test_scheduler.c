@@ -0,0 +1,354 @@
+/*
+
+  test_scheduler.c - transaction scheduler tests against the simulated RTU server
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host.h"
+#include "modbus_scheduler.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) if(!(cond)) { failures++; fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); }
+
+// Response recorder, the context is the index of the submitted transaction.
+#define N_RESULTS 16
+
+static volatile uint32_t n_responses;
+static uint_fast8_t order[N_RESULTS];
+static modbus_response_t results[N_RESULTS];
+
+static void record (modbus_response_t *response, void *context)
+{
+    uint_fast8_t idx = (uint_fast8_t)(uintptr_t)context;
+
+    memcpy(&results[idx], response, sizeof(modbus_response_t));
+    order[n_responses++] = idx;
+}
+
+static bool submit (uint_fast8_t idx, uint8_t device, modbus_function_t function, uint16_t address, uint16_t *values, uint16_t n_registers, modbus_priority_t priority)
+{
+    return modbus_sched_submit(device, function, address, values, n_registers, priority, record, (void *)(uintptr_t)idx);
+}
+
+static void reset (void)
+{
+    n_responses = 0;
+    memset(results, 0, sizeof(results));
+    host_server.requests = 0;
+    host_server.delay = 0;
+    host_server.silent_device = 0;
+}
+
+static bool values_ok (uint_fast8_t idx, uint16_t address, uint16_t n_registers)
+{
+    uint_fast8_t i;
+    bool ok = results[idx].exception == ModBus_NoException && results[idx].num_values == n_registers;
+
+    for(i = 0; ok && i < n_registers; i++)
+        ok = results[idx].values[i] == host_server.registers[address + i];
+
+    return ok;
+}
+
+static void test_read_write (void)
+{
+    uint16_t values[MODBUS_SCHED_MAX_REGISTERS];
+
+    reset();
+
+    CHECK(submit(0, 1, ModBus_ReadHoldingRegisters, 10, NULL, 2, ModbusPriority_Normal), "read: not queued");
+    CHECK(host_run_until(&n_responses, 1, 500), "read: no response");
+    CHECK(values_ok(0, 10, 2), "read: wrong values");
+
+    values[0] = 0x1234;
+    values[1] = 0xABCD;
+    CHECK(submit(1, 1, ModBus_WriteRegisters, 100, values, 2, ModbusPriority_Normal), "write: not queued");
+    CHECK(host_run_until(&n_responses, 2, 500), "write: no response");
+    CHECK(results[1].exception == ModBus_NoException && host_server.registers[100] == 0x1234 && host_server.registers[101] == 0xABCD,
+           "write: registers not written");
+    CHECK(host_server.crc_errors == 0, "%u requests with bad CRC", host_server.crc_errors);
+}
+
+// The request size is limited by the ADU, not by the three registers of $MODBUSCMD.
+static void test_max_registers (void)
+{
+    uint16_t values[MODBUS_SCHED_MAX_REGISTERS + 1] = {0};
+    uint16_t max_write = (MODBUS_MAX_ADU_SIZE - 9) / 2;
+
+    reset();
+
+    CHECK(MODBUS_SCHED_MAX_REGISTERS > 3, "max registers: %u, expected more than 3 for a %u byte ADU", MODBUS_SCHED_MAX_REGISTERS, MODBUS_MAX_ADU_SIZE);
+    CHECK(submit(0, 1, ModBus_ReadInputRegisters, 200, NULL, MODBUS_SCHED_MAX_REGISTERS, ModbusPriority_Normal), "max registers: read not queued");
+    CHECK(host_run_until(&n_responses, 1, 500), "max registers: no response");
+    CHECK(values_ok(0, 200, MODBUS_SCHED_MAX_REGISTERS), "max registers: wrong values");
+
+    CHECK(!submit(1, 1, ModBus_ReadInputRegisters, 200, NULL, MODBUS_SCHED_MAX_REGISTERS + 1, ModbusPriority_Normal), "max registers: oversized read queued");
+    CHECK(submit(1, 1, ModBus_WriteRegisters, 300, values, max_write, ModbusPriority_Normal), "max registers: write of %u registers not queued", max_write);
+    CHECK(!submit(2, 1, ModBus_WriteRegisters, 300, values, max_write + 1, ModbusPriority_Normal), "max registers: oversized write queued");
+    CHECK(host_run_until(&n_responses, 2, 500) && results[1].exception == ModBus_NoException, "max registers: write failed");
+}
+
+// Reads queued while the bus is busy are coalesced into a single request.
+static void test_coalesce (void)
+{
+    modbus_sched_stats_t *stats = modbus_sched_get_stats(2);
+    uint32_t coalesced = stats ? stats->coalesced : 0;
+
+    reset();
+    host_server.delay = 10;
+
+    CHECK(submit(0, 2, ModBus_ReadHoldingRegisters, 10, NULL, 1, ModbusPriority_Normal), "coalesce: not queued");
+    CHECK(submit(1, 2, ModBus_ReadHoldingRegisters, 20, NULL, 2, ModbusPriority_Normal), "coalesce: not queued");
+    CHECK(submit(2, 2, ModBus_ReadHoldingRegisters, 22, NULL, 2, ModbusPriority_Normal), "coalesce: not queued");
+    CHECK(submit(3, 2, ModBus_ReadHoldingRegisters, 21, NULL, 1, ModbusPriority_Normal), "coalesce: not queued");
+    CHECK(host_run_until(&n_responses, 4, 500), "coalesce: %u responses, expected 4", n_responses);
+
+    CHECK(host_server.requests == 2, "coalesce: %u requests, expected 2", host_server.requests);
+    CHECK(host_server.last_address == 20 && host_server.last_count == 4, "coalesce: last request %u,%u, expected 20,4", host_server.last_address, host_server.last_count);
+    CHECK(values_ok(0, 10, 1) && values_ok(1, 20, 2) && values_ok(2, 22, 2) && values_ok(3, 21, 1), "coalesce: wrong values");
+
+    stats = modbus_sched_get_stats(2);
+    CHECK(stats && stats->coalesced - coalesced == 2, "coalesce: %u reads coalesced, expected 2", stats ? stats->coalesced - coalesced : 0);
+}
+
+// Urgent transactions are sent first, background last.
+static void test_priority (void)
+{
+    reset();
+    host_server.delay = 5;
+
+    submit(0, 1, ModBus_ReadHoldingRegisters, 0, NULL, 1, ModbusPriority_Normal);
+    submit(1, 1, ModBus_ReadHoldingRegisters, 0, NULL, 1, ModbusPriority_Background);
+    submit(2, 1, ModBus_ReadHoldingRegisters, 50, NULL, 1, ModbusPriority_Normal);
+    submit(3, 2, ModBus_ReadHoldingRegisters, 0, NULL, 1, ModbusPriority_Urgent);
+
+    CHECK(host_run_until(&n_responses, 4, 500), "priority: %u responses, expected 4", n_responses);
+    CHECK(order[0] == 0 && order[1] == 3 && order[2] == 2 && order[3] == 1, "priority: order %u %u %u %u, expected 0 3 2 1", order[0], order[1], order[2], order[3]);
+}
+
+// Timeouts are retried, exceptions are not.
+static void test_errors (void)
+{
+    modbus_sched_stats_t *stats;
+
+    reset();
+    host_server.silent_device = 4;
+
+    CHECK(submit(0, 4, ModBus_ReadHoldingRegisters, 0, NULL, 1, ModbusPriority_Normal), "timeout: not queued");
+    CHECK(host_run_until(&n_responses, 1, HOST_TIMEOUT * (MODBUS_SCHED_RETRIES + 2)), "timeout: no response");
+    CHECK(results[0].exception == ModBus_Timeout, "timeout: exception %u, expected timeout", results[0].exception);
+    CHECK(host_server.requests == MODBUS_SCHED_RETRIES + 1, "timeout: %u requests, expected %u", host_server.requests, MODBUS_SCHED_RETRIES + 1);
+
+    stats = modbus_sched_get_stats(4);
+    CHECK(stats && stats->timeouts == 1 && stats->retries == MODBUS_SCHED_RETRIES, "timeout: statistics wrong");
+
+    reset();
+
+    CHECK(submit(1, 1, ModBus_ReadHoldingRegisters, HOST_REGISTERS, NULL, 1, ModbusPriority_Normal), "exception: not queued");
+    CHECK(host_run_until(&n_responses, 1, 500), "exception: no response");
+    CHECK(results[1].exception == ModBus_IllegalDataAddress, "exception: %u, expected %u", results[1].exception, ModBus_IllegalDataAddress);
+    CHECK(host_server.requests == 1, "exception: %u requests, expected 1", host_server.requests);
+}
+
+// Direct use of modbus_message() by the tests, the context is a counter.
+static volatile uint32_t n_direct;
+
+static void direct (modbus_response_t *response)
+{
+    n_direct++;
+}
+
+// A request that cannot be sent because the bus is not available is retried, then fails as a timeout.
+static void test_bus_busy (void)
+{
+    modbus_sched_stats_t *stats = modbus_sched_get_stats(4);
+    uint32_t retries = stats ? stats->retries : 0, timeouts = stats ? stats->timeouts : 0;
+
+    reset();
+    n_direct = 0;
+    host_server.silent_device = 4;
+
+    CHECK(modbus_message(4, ModBus_ReadHoldingRegisters, 0, NULL, 1, direct) == Status_OK, "bus busy: direct request failed");
+    CHECK(submit(0, 4, ModBus_ReadHoldingRegisters, 0, NULL, 1, ModbusPriority_Normal), "bus busy: not queued");
+    CHECK(host_run_until(&n_responses, 1, HOST_TIMEOUT / 2), "bus busy: no response");
+    CHECK(results[0].exception == ModBus_Timeout, "bus busy: exception %u, expected timeout", results[0].exception);
+
+    stats = modbus_sched_get_stats(4);
+    CHECK(stats && stats->retries - retries == MODBUS_SCHED_RETRIES && stats->timeouts - timeouts == 1, "bus busy: statistics wrong");
+
+    // The transaction is dequeued, nothing is sent when the bus is free again.
+    CHECK(host_run_until(&n_direct, 1, HOST_TIMEOUT * 2), "bus busy: direct request not completed");
+    host_run(20);
+    CHECK(n_responses == 1 && host_server.requests == 1, "bus busy: %u responses, %u requests, expected 1 and 1", n_responses, host_server.requests);
+}
+
+// Transactions/s for four clients reading one register each per round, e.g. VFD status, frequency, current and load.
+#define BENCH_ROUNDS 50
+
+static uint32_t bench_serial (void)
+{
+    uint_fast16_t round;
+    uint_fast8_t client;
+    uint32_t start = hal.get_elapsed_ticks();
+
+    n_direct = 0;
+
+    // One request at a time, the next is sent on the poll following the response.
+    for(round = 0; round < BENCH_ROUNDS; round++) {
+        for(client = 0; client < 4; client++) {
+            uint32_t count = n_direct + 1;
+            while(modbus_message(1, ModBus_ReadHoldingRegisters, 10 + client, NULL, 1, direct) != Status_OK)
+                host_run(0);
+            if(!host_run_until(&n_direct, count, 500))
+                return 0;
+        }
+    }
+
+    return n_direct * 1000 / max(hal.get_elapsed_ticks() - start, 1);
+}
+
+static void bench_response (modbus_response_t *response, void *context)
+{
+    n_responses++;
+}
+
+static uint32_t bench_scheduler (void)
+{
+    uint_fast16_t round;
+    uint_fast8_t client;
+    uint32_t start = hal.get_elapsed_ticks();
+
+    n_responses = 0;
+
+    for(round = 0; round < BENCH_ROUNDS; round++) {
+        for(client = 0; client < 4; client++)
+            modbus_sched_submit(1, ModBus_ReadHoldingRegisters, 10 + client, NULL, 1, ModbusPriority_Normal, bench_response, NULL);
+        if(!host_run_until(&n_responses, (round + 1) * 4, 500))
+            return 0;
+    }
+
+    return n_responses * 1000 / max(hal.get_elapsed_ticks() - start, 1);
+}
+
+static void test_throughput (void)
+{
+    uint32_t serial, scheduled, serial_requests;
+
+    reset();
+    host_server.delay = 2;
+
+    serial = bench_serial();
+    serial_requests = host_server.requests;
+    host_server.requests = 0;
+    scheduled = bench_scheduler();
+
+    printf("throughput: serial modbus_message() %u transactions/s, %u requests, scheduler %u transactions/s, %u requests\n",
+            serial, serial_requests, scheduled, host_server.requests);
+
+    CHECK(serial && scheduled, "throughput: transactions not completed");
+    CHECK(scheduled > serial, "throughput: scheduler %u transactions/s, serial %u", scheduled, serial);
+    CHECK(host_server.requests < serial_requests, "throughput: %u requests, serial %u", host_server.requests, serial_requests);
+}
+
+// Broadcasts are counted as device 0 and must not take a new statistics slot each time.
+static void test_stats (void)
+{
+    uint_fast8_t i;
+    uint16_t value = 42;
+    modbus_sched_stats_t *stats;
+    char *line;
+
+    reset();
+
+    for(i = 0; i < 3; i++) {
+        CHECK(submit(i, 0, ModBus_WriteRegister, 500, &value, 1, ModbusPriority_Normal), "broadcast: not queued");
+        CHECK(host_run_until(&n_responses, i + 1, 500), "broadcast: no response");
+    }
+
+    CHECK(host_server.registers[500] == 42, "broadcast: register not written");
+
+    stats = modbus_sched_get_stats(0);
+    CHECK(stats && stats->transactions == 3, "broadcast: %u transactions, expected 3", stats ? stats->transactions : 0);
+
+    // Devices 1, 2, 4 and 0 are in use, all are reported.
+    host_command("MODBUSSTATS", NULL);
+    for(i = 0, line = host_output; (line = strstr(line, "[MODBUSSTATS:")); line++, i++);
+    CHECK(i == 4 && strstr(host_output, "[MODBUSSTATS:0,3,"), "stats: %u devices reported, expected 4\n%s", i, host_output);
+}
+
+// Background polls are rate limited by their interval.
+static void test_poll (void)
+{
+    reset();
+
+    CHECK(modbus_sched_poll_add(1, ModBus_ReadInputRegisters, 0, 2, 20, record, (void *)0), "poll: not added");
+    host_run(210);
+    modbus_sched_poll_remove(record, (void *)0);
+
+    CHECK(n_responses >= 8 && n_responses <= 12, "poll: %u responses in 210 ms, expected about 11", n_responses);
+
+    host_run(50);
+    CHECK(n_responses <= 12, "poll: responses after removal");
+}
+
+// $MODBUSCMD is limited to three registers.
+static void test_command (void)
+{
+    host_server.registers[7] = 77;
+
+    CHECK(host_command("MODBUSCMD", "1,3,5,4") == Status_InvalidStatement, "$MODBUSCMD: 4 registers accepted");
+    CHECK(host_command("MODBUSCMD", "1,3,5,3") == Status_OK, "$MODBUSCMD: 3 registers rejected");
+    host_run(20);
+    CHECK(strstr(host_output, ",77(0x4d)"), "$MODBUSCMD: value not reported\n%s", host_output);
+
+    CHECK(host_command("MODBUSCMD", "1,16,600,1,2,3") == Status_OK, "$MODBUSCMD: write of 3 registers rejected");
+    host_run(20);
+    CHECK(host_server.registers[600] == 1 && host_server.registers[601] == 2 && host_server.registers[602] == 3, "$MODBUSCMD: registers not written");
+}
+
+int main (int argc, char **argv)
+{
+    uint_fast16_t i;
+
+    host_init();
+
+    for(i = 0; i < HOST_REGISTERS; i++)
+        host_server.registers[i] = (uint16_t)(i * 7 + 3);
+
+    test_read_write();
+    test_max_registers();
+    test_coalesce();
+    test_priority();
+    test_errors();
+    test_bus_busy();
+    test_stats();
+    test_poll();
+    test_command();
+    test_throughput();
+
+    if(failures == 0)
+        printf("all scheduler tests passed\n");
+
+    return failures ? 1 : 0;
+}
@@ -19,29 +19,136 @@
 #include "grbl/hal.h"
 #include "grbl/task.h"
 
-static uint32_t ao_enabled = 0, ao_changed = 0;
-static uint32_t do_enabled = 0, do_changed = 0, do_state = 0;
-static float ao_state[N_AUX_AOUT_MAX] = {0};
+#ifndef BINARY_REPORT_ENABLE
+#define BINARY_REPORT_ENABLE 0 // set to 1 to add field to the binary status report, requires binary_report.c
+#endif
+
+#if BINARY_REPORT_ENABLE
+#include "binary_report.h"
+#endif
+
+#ifndef AUX_DOUT_MAX
+#define AUX_DOUT_MAX 64
+#endif
+#ifndef AUX_AOUT_MAX
+#define AUX_AOUT_MAX N_AUX_AOUT_MAX
+#endif
+
+#define BITSET_WORDS(n) (((n) + 31) / 32)
+
+typedef struct {
+    uint32_t enabled[BITSET_WORDS(AUX_DOUT_MAX)];
+    uint32_t changed[BITSET_WORDS(AUX_DOUT_MAX)];
+    uint32_t state[BITSET_WORDS(AUX_DOUT_MAX)];
+    uint8_t digit[AUX_DOUT_MAX];    // offset of the state digit in text
+    char text[AUX_DOUT_MAX][8];     // ";P<port>,<state>", only the state digit is updated on change
+} do_journal_t;
+
+typedef struct {
+    uint32_t enabled[BITSET_WORDS(AUX_AOUT_MAX)];
+    uint32_t changed[BITSET_WORDS(AUX_AOUT_MAX)];
+    int32_t tenths[AUX_AOUT_MAX];   // value at reported resolution
+    float value[AUX_AOUT_MAX];
+    char text[AUX_AOUT_MAX][8];     // ";E<port>,", the value is formatted when reported
+} ao_journal_t;
+
+static do_journal_t do_journal = {0};
+static ao_journal_t ao_journal = {0};
 
 static on_port_out_ptr on_port_out;
 static on_realtime_report_ptr on_realtime_report;
 static on_report_options_ptr on_report_options;
 
+static inline void bitset_set (uint32_t *bitset, uint_fast16_t bit)
+{
+    bitset[bit >> 5] |= (1UL << (bit & 0x1F));
+}
+
+static inline void bitset_clear (uint32_t *bitset, uint_fast16_t bit)
+{
+    bitset[bit >> 5] &= ~(1UL << (bit & 0x1F));
+}
+
+static inline bool bitset_test (const uint32_t *bitset, uint_fast16_t bit)
+{
+    return !!(bitset[bit >> 5] & (1UL << (bit & 0x1F)));
+}
+
+static void bitset_set_range (uint32_t *bitset, uint_fast16_t n_bits)
+{
+    uint_fast16_t idx = 0;
+
+    for(; n_bits >= 32; n_bits -= 32)
+        bitset[idx++] = 0xFFFFFFFF;
+
+    if(n_bits)
+        bitset[idx] = (1UL << n_bits) - 1;
+}
+
+static bool bitset_any (const uint32_t *bitset, uint_fast16_t words)
+{
+    while(words) {
+        if(bitset[--words])
+            return true;
+    }
+
+    return false;
+}
+
+// Outputs the changed ports and clears the changed bits.
+static void report_changed (stream_write_ptr stream_write, uint32_t *changed, uint_fast16_t words, void (*write_port)(stream_write_ptr stream_write, uint_fast16_t port, bool add_sep))
+{
+    bool add_sep = false;
+    uint_fast16_t idx, port;
+    uint32_t bits;
+
+    for(idx = 0; idx < words; idx++) {
+        if((bits = changed[idx])) {
+            changed[idx] = 0;
+            do {
+                port = (idx << 5) + __builtin_ctz(bits);
+                bits &= bits - 1;
+                write_port(stream_write, port, add_sep);
+                add_sep = true;
+            } while(bits);
+        }
+    }
+}
+
+static void write_do (stream_write_ptr stream_write, uint_fast16_t port, bool add_sep)
+{
+    stream_write(do_journal.text[port] + !add_sep);
+}
+
+static void write_ao (stream_write_ptr stream_write, uint_fast16_t port, bool add_sep)
+{
+    stream_write(ao_journal.text[port] + !add_sep);
+    stream_write(ftoa(ao_journal.value[port], 1));
+}
+
+// NOTE: called from the stepper interrupt for synchronized outputs (M62/M63),
+//       uitoa() and ftoa() are not reentrant and must not be used here.
 void onPortOut (uint8_t port, io_port_type_t type, float value)
 {
-    if(type == Port_Digital) {
-        uint8_t bit = 1 << port;
-        if(!!(do_state & bit) != (value == 1.0f)) {
-            do_changed |= bit;
+    if(type == Port_Digital && port < AUX_DOUT_MAX) {
+        if(bitset_test(do_journal.state, port) != (value != 0.0f)) {
             if(value == 0.0f)
-                do_state &= ~(1 << port);
+                bitset_clear(do_journal.state, port);
             else
-                do_state |= (1 << port);
+                bitset_set(do_journal.state, port);
+            if(bitset_test(do_journal.enabled, port)) {
+                do_journal.text[port][do_journal.digit[port]] = value == 0.0f ? '0' : '1';
+                bitset_set(do_journal.changed, port);
+            }
         }
-    } else if(type == Port_Analog) {
-        if(value != ao_state[port]) {
-            ao_changed |= (1 << port);
-            ao_state[port] = value;
+    } else if(type == Port_Analog && port < AUX_AOUT_MAX) {
+        // Compare at reported resolution, changes that would not be visible are not reported.
+        int32_t tenths = (int32_t)lroundf(value * 10.0f);
+        ao_journal.value[port] = value;
+        if(tenths != ao_journal.tenths[port]) {
+            ao_journal.tenths[port] = tenths;
+            if(bitset_test(ao_journal.enabled, port))
+                bitset_set(ao_journal.changed, port);
         }
     }
 
@@ -55,74 +162,59 @@ static void onRealtimeReport (stream_write_ptr stream_write, report_tracking_fla
         on_realtime_report(stream_write, report);
 
     if(report.all) {
-        ao_changed = ao_enabled;
-        do_changed = do_enabled;
+        memcpy(ao_journal.changed, ao_journal.enabled, sizeof(ao_journal.changed));
+        memcpy(do_journal.changed, do_journal.enabled, sizeof(do_journal.changed));
     }
 
-    if(!(ao_changed || do_changed))
+    if(!(bitset_any(ao_journal.changed, BITSET_WORDS(AUX_AOUT_MAX)) || bitset_any(do_journal.changed, BITSET_WORDS(AUX_DOUT_MAX))))
         return;
 
-    uint8_t port;
-    bool add_port = false;
-    char buf[20];
-
     stream_write("|AUX:");
 
-    if(ao_changed) {
-
-        port = 0;
-
-        do {
-            if(ao_changed & 1) {
-                strcpy(buf, add_port ? ";E" : "E");
-                strcat(buf, uitoa(port));
-                strcat(buf, ",");
-                strcat(buf, ftoa(ao_state[port], 1));
-                add_port = true;
-                stream_write(buf);
-            }
-            port++;
-        } while(ao_changed >>= 1);
-    }
-
-    if(do_changed) {
+    report_changed(stream_write, ao_journal.changed, BITSET_WORDS(AUX_AOUT_MAX), write_ao);
+    report_changed(stream_write, do_journal.changed, BITSET_WORDS(AUX_DOUT_MAX), write_do);
+}
 
-        port = 0;
-        add_port = false;
+#if BINARY_REPORT_ENABLE
 
-        do {
-            if(do_changed & 1) {
-                strcpy(buf, add_port ? ";P" : "P");
-                strcat(buf, uitoa(port));
-                strcat(buf, ",");
-                strcat(buf, uitoa(!!(do_state & (1 << port))));
-                add_port = true;
-                stream_write(buf);
-            }
-            port++;
-        } while(do_changed >>= 1);
-    }
+static void fill_aux_out (uint8_t *data)
+{
+    memcpy(data, do_journal.state, sizeof(do_journal.state));
 }
 
+#endif
+
 static void onReportOptions (bool newopt)
 {
     on_report_options(newopt);
 
     if(!newopt)
-        report_plugin("Aux port state", "0.01");
+        report_plugin("Aux port state", "0.03");
 }
 
+// Port prefixes are formatted here, in the foreground, as onPortOut() may be called from an interrupt.
 static void setup_ports (void *data)
 {
-    uint8_t n_ports;
-
-    n_ports = ioports_unclaimed(Port_Digital, Port_Output);
-    while(n_ports--)
-        do_enabled |= (do_enabled << 1) | 1;
+    uint8_t port, n_ports;
+
+    n_ports = min(ioports_unclaimed(Port_Digital, Port_Output), AUX_DOUT_MAX);
+    for(port = 0; port < n_ports; port++) {
+        char *text = do_journal.text[port];
+        strcpy(text, ";P");
+        strcat(text, uitoa(port));
+        strcat(text, ",");
+        do_journal.digit[port] = strlen(text);
+        text[do_journal.digit[port]] = bitset_test(do_journal.state, port) ? '1' : '0';
+    }
+    bitset_set_range(do_journal.enabled, n_ports);
 
-    n_ports = ioports_unclaimed(Port_Analog, Port_Output);
-    while(n_ports--)
-        ao_enabled |= (ao_enabled << 1) | 1;
+    n_ports = min(ioports_unclaimed(Port_Analog, Port_Output), AUX_AOUT_MAX);
+    for(port = 0; port < n_ports; port++) {
+        strcpy(ao_journal.text[port], ";E");
+        strcat(ao_journal.text[port], uitoa(port));
+        strcat(ao_journal.text[port], ",");
+    }
+    bitset_set_range(ao_journal.enabled, n_ports);
 }
 
 void my_plugin_init (void)
@@ -137,4 +229,16 @@ void my_plugin_init (void)
     grbl.on_port_out = onPortOut;
 
     task_run_on_startup(setup_ports, NULL);
+
+#if BINARY_REPORT_ENABLE
+    static binary_field_t aux_out = {
+        .id = BinaryField_AuxOut,
+        .format = BinaryFormat_U32,
+        .count = BITSET_WORDS(AUX_DOUT_MAX),
+        .name = "AUX",
+        .fill = fill_aux_out
+    };
+
+    binary_report_register(&aux_out);
+#endif
 }
@@ -20,14 +20,62 @@
   NOTE: be sure to set the RTC before switching to RTC output.
 
   When synchrounous mode is active delay reset until buffered motions has been completed.
+
+  Trace capture, samples machine position, feed rate and spindle state from the stepper interrupt into a RAM ring buffer
+  with microsecond timestamps. Sampling only takes place when steps are output.
+
+  $TRACE=<rate> to start capture, <rate> is 1 - 10000 samples per second.
+  $TRACE=0 to stop capture.
+  $TRACE=C to stop capture and output samples in CSV format: microseconds,<position in steps>...,feed rate,spindle state.
+  $TRACE=B to stop capture and output samples in binary format, little endian: 0xA7 <record size> <sample count (uint16)> <records>...
+    Each record is packed: microseconds (uint32), <position in steps (int32)>..., feed rate (IEEE 754 float), spindle state (uint8).
+  $TRACE to output capture status.
+
+  NOTE: requires hal.get_micros().
 */
 
 #include <math.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "grbl/hal.h"
-
+#include "grbl/gcode.h"
+#include "grbl/stepper.h"
+
+#ifndef BINARY_REPORT_ENABLE
+#define BINARY_REPORT_ENABLE 0 // set to 1 to add field to the binary status report, requires binary_report.c
+#endif
+
+#if BINARY_REPORT_ENABLE
+#include "binary_report.h"
+#endif
+
+#ifndef TRACE_SAMPLES
+#define TRACE_SAMPLES 512
+#endif
+
+typedef struct {
+    uint32_t us;
+    int32_t position[N_AXIS];
+    float feed_rate;
+    uint8_t spindle;
+} trace_sample_t;
+
+#define TRACE_RECORD_SIZE (4 + N_AXIS * 4 + 4 + 1) // binary output record size, no padding
+
+typedef struct {
+    volatile bool active;
+    uint16_t head;
+    uint16_t count;
+    uint32_t period_us;
+    uint32_t last_us;
+    uint32_t start_us;
+    trace_sample_t samples[TRACE_SAMPLES];
+} trace_t;
+
+static trace_t trace = {0};
+static stepper_pulse_start_ptr pulse_start;
 static uint32_t offset = 0;
 static bool mcode_sync = true, use_rtc = false;
 static on_realtime_report_ptr on_realtime_report;
@@ -125,16 +173,184 @@ static void onRealtimeReport (stream_write_ptr stream_write, report_tracking_fla
         on_realtime_report(stream_write, report);
 }
 
+#if BINARY_REPORT_ENABLE
+
+static void fill_timestamp (uint8_t *data)
+{
+    uint32_t ts = hal.get_elapsed_ticks() - offset;
+
+    memcpy(data, &ts, sizeof(uint32_t));
+}
+
+#endif
+
+// Trace capture
+
+static void stepperPulseStart (stepper_t *stepper)
+{
+    uint32_t us;
+
+    pulse_start(stepper);
+
+    us = hal.get_micros();
+
+    if(trace.active && us - trace.last_us >= trace.period_us) {
+
+        trace_sample_t *sample = &trace.samples[trace.head];
+
+        trace.last_us = us;
+        sample->us = us - trace.start_us;
+        memcpy(sample->position, sys.position, sizeof(sample->position));
+        sample->feed_rate = st_get_realtime_rate();
+        sample->spindle = gc_state.modal.spindle.state.value;
+
+        trace.head = (trace.head + 1) % TRACE_SAMPLES;
+        if(trace.count < TRACE_SAMPLES)
+            trace.count++;
+    }
+}
+
+static void trace_stop (void)
+{
+    trace.active = false;
+
+    if(hal.stepper.pulse_start == stepperPulseStart)
+        hal.stepper.pulse_start = pulse_start;
+}
+
+static void trace_start (uint32_t rate)
+{
+    trace_stop();
+
+    trace.head = trace.count = 0;
+    trace.period_us = 1000000UL / rate;
+    trace.start_us = trace.last_us = hal.get_micros();
+
+    // Hooked only while capturing, drivers may swap the handler on settings changes.
+    pulse_start = hal.stepper.pulse_start;
+    hal.stepper.pulse_start = stepperPulseStart;
+
+    trace.active = true;
+}
+
+static inline trace_sample_t *trace_sample (uint_fast16_t idx)
+{
+    return &trace.samples[(trace.head + TRACE_SAMPLES - trace.count + idx) % TRACE_SAMPLES];
+}
+
+static void trace_dump_csv (void)
+{
+    uint_fast8_t axis;
+    uint_fast16_t idx;
+    char buf[16];
+
+    for(idx = 0; idx < trace.count; idx++) {
+
+        trace_sample_t *sample = trace_sample(idx);
+
+        hal.stream.write(uitoa(sample->us));
+        for(axis = 0; axis < N_AXIS; axis++) {
+            sprintf(buf, ",%ld", (long)sample->position[axis]);
+            hal.stream.write(buf);
+        }
+        hal.stream.write(",");
+        hal.stream.write(ftoa(sample->feed_rate, 1));
+        hal.stream.write(",");
+        hal.stream.write(uitoa(sample->spindle));
+        hal.stream.write(ASCII_EOL);
+    }
+}
+
+static uint8_t *trace_put (uint8_t *p, uint32_t value)
+{
+    *p++ = value & 0xFF;
+    *p++ = (value >> 8) & 0xFF;
+    *p++ = (value >> 16) & 0xFF;
+    *p++ = value >> 24;
+
+    return p;
+}
+
+// Fields are written explicitly, little endian and without padding, see the README for the layout.
+static void trace_dump_binary (void)
+{
+    uint_fast8_t axis;
+    uint_fast16_t idx;
+    uint8_t data[TRACE_RECORD_SIZE], *p;
+    uint8_t header[4] = { 0xA7, TRACE_RECORD_SIZE, trace.count & 0xFF, trace.count >> 8 };
+
+    hal.stream.write_n(header, sizeof(header));
+
+    for(idx = 0; idx < trace.count; idx++) {
+
+        trace_sample_t *sample = trace_sample(idx);
+        union {
+            float f;
+            uint32_t u;
+        } feed_rate = { .f = sample->feed_rate };
+
+        p = trace_put(data, sample->us);
+        for(axis = 0; axis < N_AXIS; axis++)
+            p = trace_put(p, (uint32_t)sample->position[axis]);
+        p = trace_put(p, feed_rate.u);
+        *p = sample->spindle;
+
+        hal.stream.write_n(data, TRACE_RECORD_SIZE);
+    }
+}
+
+static status_code_t trace_command (sys_state_t state, char *args)
+{
+    char *end;
+    uint32_t rate;
+    status_code_t status = Status_OK;
+
+    if(hal.get_micros == NULL)
+        status = Status_InvalidStatement;
+    else if(args == NULL) {
+        hal.stream.write("[TRACE:");
+        hal.stream.write(trace.active ? uitoa(1000000UL / trace.period_us) : "0");
+        hal.stream.write(",");
+        hal.stream.write(uitoa(trace.count));
+        hal.stream.write("]" ASCII_EOL);
+    } else if(!strcmp(args, "C") || !strcmp(args, "B")) {
+        trace_stop();
+        if(*args == 'C')
+            trace_dump_csv();
+        else if(hal.stream.write_n)
+            trace_dump_binary();
+        else
+            status = Status_InvalidStatement;
+    } else if((rate = strtoul(args, &end, 10)) <= 10000 && end != args && *end == '\0') {
+        if(rate)
+            trace_start(rate);
+        else
+            trace_stop();
+    } else
+        status = Status_BadNumberFormat;
+
+    return status;
+}
+
 static void onReportOptions (bool newopt)
 {
     on_report_options(newopt);
 
     if(!newopt)
-        report_plugin("RT timestamp", "0.04");
+        report_plugin("RT timestamp", "0.05");
 }
 
 void my_plugin_init (void)
 {
+    static const sys_command_t command_list[] = {
+        {"TRACE", trace_command, { .allow_blocking = On }, { .str = "$TRACE[=<rate>|0|C|B] - start, stop or output position trace" } }
+    };
+
+    static sys_commands_t commands = {
+        .n_commands = sizeof(command_list) / sizeof(sys_command_t),
+        .commands = command_list
+    };
+
     on_report_options = grbl.on_report_options;
     grbl.on_report_options = onReportOptions;
 
@@ -146,4 +362,18 @@ void my_plugin_init (void)
     grbl.user_mcode.check = check;
     grbl.user_mcode.validate = validate;
     grbl.user_mcode.execute = execute;
+
+    system_register_commands(&commands);
+
+#if BINARY_REPORT_ENABLE
+    static binary_field_t timestamp = {
+        .id = BinaryField_Timestamp,
+        .format = BinaryFormat_U32,
+        .count = 1,
+        .name = "TS",
+        .fill = fill_timestamp
+    };
+
+    binary_report_register(&timestamp);
+#endif
 }
@@ -0,0 +1,477 @@
+/*
+  binary_report.c - binary, length-prefixed real time status report frame
+
+  Part of grblHAL
+
+  Public domain.
+  This code is is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  A frame is sent when the BINARY_REPORT_CMD real time command is received, senders that do not
+  send it will only see the normal ASCII reports.
+
+  Frame layout:
+  0xA5 <payload length> <sequence number> [<field id> <field data>]... <checksum>
+  Field data is fixed size and little endian, the checksum is XOR of all bytes between the sync byte and the checksum.
+
+  Clients may subscribe to fields with $BSRSUB=<interval>,<id>[,<id>...], delta frames with the 0xA6 sync byte
+  are then pushed at most every <interval> milliseconds, containing only the subscribed fields that has changed
+  more than the field threshold since last pushed. $BSRSUB=0 cancels the subscription, $BSRSUB lists the fields.
+
+  $BSR outputs a frame in ASCII format for debugging.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_report.h"
+
+#include "grbl/state_machine.h"
+#include "grbl/stepper.h"
+
+static bool init_ok = false;
+static volatile bool frame_requested = false;
+static uint8_t payload_size = 0, sequence = 0;
+static uint8_t shadow[BINARY_REPORT_MAX_SIZE]; // last pushed field data, indexed by field offset
+static uint16_t push_interval = 0;
+static binary_field_t *fields = NULL;
+static on_unknown_realtime_cmd_ptr on_unknown_realtime_cmd;
+static on_execute_realtime_ptr on_execute_realtime;
+static on_report_options_ptr on_report_options;
+
+static const uint8_t format_size[] = { 1, 2, 4, 4 };
+
+static inline uint_fast8_t field_size (binary_field_t *field)
+{
+    return format_size[field->format] * field->count;
+}
+
+static binary_field_t *field_get (uint8_t id)
+{
+    binary_field_t *field = fields;
+
+    while(field && field->id != id)
+        field = field->next;
+
+    return field;
+}
+
+// Built in fields
+
+static void fill_state (uint8_t *data)
+{
+    uint16_t state = (uint16_t)state_get();
+
+    memcpy(data, &state, sizeof(uint16_t));
+}
+
+static void fill_position (uint8_t *data)
+{
+    memcpy(data, sys.position, sizeof(int32_t) * N_AXIS);
+}
+
+static void fill_ticks (uint8_t *data)
+{
+    uint32_t ticks = hal.get_elapsed_ticks();
+
+    memcpy(data, &ticks, sizeof(uint32_t));
+}
+
+static void fill_feed (uint8_t *data)
+{
+    uint32_t feed = (uint32_t)st_get_realtime_rate();
+
+    memcpy(data, &feed, sizeof(uint32_t));
+}
+
+static void fill_probe (uint8_t *data)
+{
+    *data = hal.probe.get_state ? hal.probe.get_state().value & 0x03 : 0;
+}
+
+//
+
+static uint_fast8_t build_frame (uint8_t *frame)
+{
+    uint8_t checksum = 0;
+    uint_fast8_t idx = 3, i;
+    binary_field_t *field = fields;
+
+    frame[0] = BINARY_REPORT_SYNC;
+    frame[1] = payload_size;
+    frame[2] = sequence++;
+
+    while(field) {
+        frame[idx++] = field->id;
+        field->fill(&frame[idx]);
+        idx += field_size(field);
+        field = field->next;
+    }
+
+    for(i = 1; i < idx; i++)
+        checksum ^= frame[i];
+
+    frame[idx++] = checksum;
+
+    return idx;
+}
+
+static void write_frame (uint8_t *frame, uint_fast8_t length)
+{
+    uint_fast8_t idx;
+
+    if(hal.stream.write_n)
+        hal.stream.write_n(frame, length);
+    else for(idx = 0; idx < length; idx++)
+        hal.stream.write_char(frame[idx]);
+}
+
+static void send_frame (void)
+{
+    uint8_t frame[BINARY_REPORT_MAX_SIZE + 4];
+
+    write_frame(frame, build_frame(frame));
+}
+
+// Returns true if any value of the field has changed more than the threshold since last pushed.
+static bool field_changed (binary_field_t *field, uint8_t *data)
+{
+    uint_fast8_t i;
+    uint8_t *last = &shadow[field->offset];
+
+    if(!field->valid)
+        return true;
+
+    if(field->threshold == 0)
+        return memcmp(data, last, field_size(field)) != 0;
+
+    for(i = 0; i < field->count; i++) {
+
+        uint32_t delta;
+
+        switch(field->format) {
+
+            case BinaryFormat_U8:
+                delta = (uint32_t)abs((int32_t)data[i] - (int32_t)last[i]);
+                break;
+
+            case BinaryFormat_U16:
+                {
+                    uint16_t v, l;
+                    memcpy(&v, &data[i * 2], sizeof(uint16_t));
+                    memcpy(&l, &last[i * 2], sizeof(uint16_t));
+                    delta = (uint32_t)abs((int32_t)v - (int32_t)l);
+                }
+                break;
+
+            default:
+                {
+                    uint32_t v, l;
+                    memcpy(&v, &data[i * 4], sizeof(uint32_t));
+                    memcpy(&l, &last[i * 4], sizeof(uint32_t));
+                    delta = field->format == BinaryFormat_I32
+                             ? ((int32_t)v > (int32_t)l ? v - l : l - v)
+                             : (v > l ? v - l : l - v);
+                }
+                break;
+        }
+
+        if(delta > field->threshold)
+            return true;
+    }
+
+    return false;
+}
+
+static void push_delta (void)
+{
+    uint8_t frame[BINARY_REPORT_MAX_SIZE + 4], checksum = 0;
+    uint_fast8_t idx = 3, i;
+    binary_field_t *field = fields;
+
+    frame[0] = BINARY_REPORT_SYNC_DELTA;
+
+    while(field) {
+        if(field->subscribed) {
+            field->fill(&frame[idx + 1]);
+            if(field_changed(field, &frame[idx + 1])) {
+                frame[idx] = field->id;
+                memcpy(&shadow[field->offset], &frame[idx + 1], field_size(field));
+                field->valid = true;
+                idx += 1 + field_size(field);
+            }
+        }
+        field = field->next;
+    }
+
+    if(idx > 3) {
+
+        frame[1] = idx - 3;
+        frame[2] = sequence++;
+
+        for(i = 1; i < idx; i++)
+            checksum ^= frame[i];
+
+        frame[idx++] = checksum;
+
+        write_frame(frame, idx);
+    }
+}
+
+static bool onUnknownRealtimeCmd (char c)
+{
+    if((uint8_t)c == BINARY_REPORT_CMD) {
+        frame_requested = true;
+        return true;
+    }
+
+    return on_unknown_realtime_cmd && on_unknown_realtime_cmd(c);
+}
+
+static void onExecuteRealtime (sys_state_t state)
+{
+    static uint32_t last_ms;
+
+    if(frame_requested) {
+        frame_requested = false;
+        send_frame();
+    }
+
+    if(push_interval) {
+        uint32_t ms = hal.get_elapsed_ticks();
+        if(ms - last_ms >= push_interval) {
+            last_ms = ms;
+            push_delta();
+        }
+    }
+
+    on_execute_realtime(state);
+}
+
+// $BSR - decodes a frame to ASCII, as a host would do.
+
+static status_code_t decode_frame (sys_state_t state, char *args)
+{
+    uint8_t frame[BINARY_REPORT_MAX_SIZE + 4], checksum = 0;
+    uint_fast8_t idx = 3, i, length = build_frame(frame);
+    binary_field_t *field;
+
+    for(i = 1; i < length; i++)
+        checksum ^= frame[i];
+
+    hal.stream.write("[BSR:");
+    hal.stream.write(uitoa(frame[1]));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(frame[2]));
+    hal.stream.write(checksum ? ",bad checksum" : ",ok");
+
+    while(idx < length - 1 && (field = field_get(frame[idx++]))) {
+
+        hal.stream.write("|");
+        hal.stream.write(field->name);
+        hal.stream.write(":");
+
+        for(i = 0; i < field->count; i++) {
+
+            union {
+                uint8_t u8;
+                uint16_t u16;
+                uint32_t u32;
+                int32_t i32;
+            } value;
+
+            memcpy(&value, &frame[idx], format_size[field->format]);
+            idx += format_size[field->format];
+
+            if(i)
+                hal.stream.write(",");
+
+            switch(field->format) {
+
+                case BinaryFormat_U8:
+                    hal.stream.write(uitoa(value.u8));
+                    break;
+
+                case BinaryFormat_U16:
+                    hal.stream.write(uitoa(value.u16));
+                    break;
+
+                case BinaryFormat_U32:
+                    hal.stream.write(uitoa(value.u32));
+                    break;
+
+                case BinaryFormat_I32:
+                    if(value.i32 < 0)
+                        hal.stream.write("-");
+                    hal.stream.write(uitoa(value.i32 < 0 ? -(uint32_t)value.i32 : (uint32_t)value.i32));
+                    break;
+            }
+        }
+    }
+
+    hal.stream.write("]" ASCII_EOL);
+
+    return Status_OK;
+}
+
+// $BSRSUB=<interval>,<id>[,<id>...]
+
+static status_code_t subscribe (sys_state_t state, char *args)
+{
+    char *end, *ids;
+    uint32_t value;
+    uint16_t interval;
+    binary_field_t *field = fields;
+
+    if(args == NULL) {
+
+        hal.stream.write("[BSRSUB:");
+        hal.stream.write(uitoa(push_interval));
+
+        while(field) {
+            hal.stream.write("|");
+            hal.stream.write(uitoa(field->id));
+            hal.stream.write(":");
+            hal.stream.write(field->name);
+            if(field->subscribed)
+                hal.stream.write("*");
+            field = field->next;
+        }
+
+        hal.stream.write("]" ASCII_EOL);
+
+        return Status_OK;
+    }
+
+    value = strtoul(args, &end, 10);
+    if(end == args || value > 65535 || (*end != '\0' && *end != ','))
+        return Status_BadNumberFormat;
+
+    interval = (uint16_t)value;
+    ids = end;
+
+    // Validate the ids before changing the subscription.
+    while(*end == ',') {
+        value = strtoul(end + 1, &end, 10);
+        if((*end != '\0' && *end != ',') || value > 255 || field_get((uint8_t)value) == NULL)
+            return Status_InvalidStatement;
+    }
+
+    for(field = fields; field; field = field->next)
+        field->subscribed = field->valid = false;
+
+    while(*ids == ',')
+        field_get((uint8_t)strtoul(ids + 1, &ids, 10))->subscribed = true;
+
+    push_interval = interval;
+
+    return Status_OK;
+}
+
+static void onReportOptions (bool newopt)
+{
+    on_report_options(newopt);
+
+    if(!newopt)
+        report_plugin("Binary status report", "0.02");
+}
+
+static void binary_report_init (void)
+{
+    static const sys_command_t command_list[] = {
+        {"BSR", decode_frame, { .noargs = On }, { .str = "output binary status report frame in ASCII format" } },
+        {"BSRSUB", subscribe, { .noargs = Off }, { .str = "$BSRSUB=<interval>,<id>[,<id>...] - subscribe to delta status reports, 0 to cancel" } }
+    };
+
+    static sys_commands_t commands = {
+        .n_commands = sizeof(command_list) / sizeof(sys_command_t),
+        .commands = command_list
+    };
+
+    static binary_field_t state = {
+        .id = BinaryField_State,
+        .format = BinaryFormat_U16,
+        .count = 1,
+        .name = "State",
+        .fill = fill_state
+    };
+
+    static binary_field_t position = {
+        .id = BinaryField_Position,
+        .format = BinaryFormat_I32,
+        .count = N_AXIS,
+        .name = "MPos",
+        .fill = fill_position,
+        .threshold = BINARY_REPORT_POSITION_THRESHOLD
+    };
+
+    static binary_field_t ticks = {
+        .id = BinaryField_Ticks,
+        .format = BinaryFormat_U32,
+        .count = 1,
+        .name = "Ticks",
+        .fill = fill_ticks
+    };
+
+    static binary_field_t feed = {
+        .id = BinaryField_Feed,
+        .format = BinaryFormat_U32,
+        .count = 1,
+        .name = "Feed",
+        .fill = fill_feed
+    };
+
+    static binary_field_t probe = {
+        .id = BinaryField_Probe,
+        .format = BinaryFormat_U8,
+        .count = 1,
+        .name = "Probe",
+        .fill = fill_probe
+    };
+
+    init_ok = true;
+
+    on_unknown_realtime_cmd = grbl.on_unknown_realtime_cmd;
+    grbl.on_unknown_realtime_cmd = onUnknownRealtimeCmd;
+
+    on_execute_realtime = grbl.on_execute_realtime;
+    grbl.on_execute_realtime = onExecuteRealtime;
+
+    on_report_options = grbl.on_report_options;
+    grbl.on_report_options = onReportOptions;
+
+    system_register_commands(&commands);
+
+    binary_report_register(&state);
+    binary_report_register(&position);
+    binary_report_register(&ticks);
+    binary_report_register(&feed);
+    binary_report_register(&probe);
+}
+
+bool binary_report_register (binary_field_t *field)
+{
+    binary_field_t *last;
+
+    if(!init_ok)
+        binary_report_init();
+
+    if(field->fill == NULL || field_get(field->id) || payload_size + 1 + field_size(field) > BINARY_REPORT_MAX_SIZE)
+        return false;
+
+    field->next = NULL;
+    field->offset = payload_size + 1;
+    field->subscribed = field->valid = false;
+    payload_size += 1 + field_size(field);
+
+    if((last = fields) == NULL)
+        fields = field;
+    else {
+        while(last->next)
+            last = last->next;
+        last->next = field;
+    }
+
+    return true;
+}
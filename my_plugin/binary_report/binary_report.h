@@ -0,0 +1,71 @@
+/*
+  binary_report.h - binary, length-prefixed real time status report frame
+
+  Part of grblHAL
+
+  Public domain.
+  This code is is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#ifndef _BINARY_REPORT_H_
+#define _BINARY_REPORT_H_
+
+#include "grbl/hal.h"
+
+#ifndef BINARY_REPORT_CMD
+#define BINARY_REPORT_CMD       0xB0    // real time command requesting a frame, must be in the 0x80 - 0xBF range
+#endif
+#ifndef BINARY_REPORT_MAX_SIZE
+#define BINARY_REPORT_MAX_SIZE  128     // max. payload size, bytes
+#endif
+
+#ifndef BINARY_REPORT_POSITION_THRESHOLD
+#define BINARY_REPORT_POSITION_THRESHOLD 0  // min. position change in steps before a delta report is pushed
+#endif
+
+#define BINARY_REPORT_SYNC      0xA5
+#define BINARY_REPORT_SYNC_DELTA 0xA6   // delta report, only changed fields are included
+
+// Field ids, 0x01 - 0x0F are reserved for the built in fields.
+#define BinaryField_State       0x01    // uint16, sys_state_t
+#define BinaryField_Position    0x02    // int32 * N_AXIS, machine position in steps
+#define BinaryField_Ticks       0x03    // uint32, milliseconds since startup
+#define BinaryField_Feed        0x04    // uint32, current feed rate in mm/min
+#define BinaryField_Probe       0x05    // uint8, probe state, bit 0 triggered, bit 1 connected
+#define BinaryField_Load        0x10    // uint32, MCU load count
+#define BinaryField_Timestamp   0x11    // uint32, milliseconds since timestamp reset
+#define BinaryField_AuxOut      0x12    // uint32[], digital aux output states, bit per port, port 0 in bit 0 of the first word
+
+typedef enum {
+    BinaryFormat_U8 = 0,
+    BinaryFormat_U16,
+    BinaryFormat_U32,
+    BinaryFormat_I32
+} binary_format_t;
+
+/// Fills the fixed size field data, values are little endian.
+typedef void (*binary_field_fill_ptr)(uint8_t *data);
+
+typedef struct binary_field {
+    uint8_t id;
+    binary_format_t format;
+    uint8_t count;                  //!< number of values of format type
+    const char *name;               //!< used by the ASCII decoder
+    binary_field_fill_ptr fill;
+    uint32_t threshold;             //!< min. change of a value before the field is pushed in a delta report, 0 for any change
+    struct binary_field *next;
+    // Private, set by the report code
+    uint8_t offset;
+    bool subscribed;
+    bool valid;
+} binary_field_t;
+
+/*! \brief Add a field to the frame, the binary report channel is initialized on the first call.
+\param field pointer to a \a binary_field_t struct, must be in static memory.
+\returns true if added, false if the frame would exceed BINARY_REPORT_MAX_SIZE or the id is taken.
+*/
+bool binary_report_register (binary_field_t *field);
+
+#endif
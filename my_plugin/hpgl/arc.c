@@ -3,23 +3,34 @@
 #include "hpgl.h"
 #include "arc.h"
 #include "scale.h"
+#include "stats.h"
 
 static int16_t arc_step;
 static uint_fast8_t is_wedge = 0;
 static float arc_stepangle, arc_xc, arc_yc, arc_a0, arc_r, arc_phi;
 
-static bool arc_cfg (user_point_t user_loc)
+static bool arc_cfg (float xc, float yc, float phi, float stepangle)
 {
-    arc_phi = hpgl_state.numpad[2] * M_PI / 180.0f;
-
-    arc_stepangle = fabsf(hpgl_state.numpad[3]);
+    // Sweep is limited to one revolution and chord angle to 0.5 - 180 degrees, as on the HP plotters
+    if(phi > 360.0f)
+        phi = 360.0f;
+    else if(phi < -360.0f)
+        phi = -360.0f;
+
+    arc_phi = phi * M_PI / 180.0f;
+
+    arc_stepangle = fabsf(stepangle);
+    if(arc_stepangle < 0.5f)
+        arc_stepangle = 0.5f;
+    else if(arc_stepangle > 180.0f)
+        arc_stepangle = 180.0f;
     if (arc_phi < -0.0f)
         arc_stepangle = -arc_stepangle;
     arc_stepangle *= M_PI / 180.0f;
 
     arc_step = 0;
-    arc_xc = hpgl_state.numpad[0];
-    arc_yc = hpgl_state.numpad[1];
+    arc_xc = xc;
+    arc_yc = yc;
     arc_a0 = atan2f(hpgl_state.user_loc.y - arc_yc, hpgl_state.user_loc.x - arc_xc);
     if (arc_a0 < -0.0f)
         arc_a0 += 2.0f * M_PI;
@@ -29,46 +40,45 @@ static bool arc_cfg (user_point_t user_loc)
     //printf_P(PSTR("AA: (%f,%f) r=%f stepangle=%f a0=%f aend=%f\n"),
     //  arc_xc, arc_yc, arc_r, arc_stepangle, arc_a0*180/M_PI, (arc_a0+arc_phi)*180/M_PI);
 
-    return arc_phi != 0.0f && arc_r != 0.0f;
+    if(arc_phi != 0.0f && arc_r != 0.0f) {
+        hpgl_stats.arcs++;
+        return true;
+    }
+
+    return false;
 }
 
 
-bool arc_init (void)
+bool arc_init (const float *param)
 {
     is_wedge = 0;
-    return arc_cfg(hpgl_state.user_loc);
+    return arc_cfg(param[0], param[1], param[2], param[3]);
 }
 
-bool circle_init (hpgl_point_t *target)
+bool circle_init (const float *param, hpgl_point_t *target)
 {
-    user_point_t d;
+    user_point_t d, center = hpgl_state.user_loc;
 
     is_wedge = 0;
-    d.x = hpgl_state.user_loc.x + hpgl_state.numpad[0];
+    d.x = hpgl_state.user_loc.x + param[0];
     d.y = hpgl_state.user_loc.y;
 
-    hpgl_state.numpad[2] = 360.0f;
-    hpgl_state.numpad[3] = hpgl_state.numpad[1];
-    hpgl_state.numpad[0] = hpgl_state.user_loc.x;
-    hpgl_state.numpad[1] = hpgl_state.user_loc.y;
-
     userscale(d, target, &hpgl_state.user_loc);
 
-    return arc_cfg(d);
+    return arc_cfg(center.x, center.y, 360.0f, param[1]);
 }
 
-bool wedge_init (void)
+bool wedge_init (const float *param)
 {
+    user_point_t center = hpgl_state.user_loc;
+
     is_wedge = 2;
-    float r = hpgl_state.numpad[0];
-    arc_phi = hpgl_state.numpad[1] * M_PI / 180.0f;
+    arc_phi = param[1] * M_PI / 180.0f;
 
-    hpgl_state.numpad[0] = hpgl_state.user_loc.x;
-    hpgl_state.numpad[1] = hpgl_state.user_loc.y;
-    hpgl_state.user_loc.y += r * sinf(arc_phi);
-    hpgl_state.user_loc.x += r * cosf(arc_phi);
+    hpgl_state.user_loc.y += param[0] * sinf(arc_phi);
+    hpgl_state.user_loc.x += param[0] * cosf(arc_phi);
 
-    return arc_cfg(hpgl_state.user_loc);
+    return arc_cfg(center.x, center.y, param[2], param[3]);
 }
 
 bool arc_next (hpgl_point_t *target)
@@ -79,8 +89,8 @@ bool arc_next (hpgl_point_t *target)
     if(is_wedge == 2) {
 
         is_wedge = 1;
-        d.x = hpgl_state.numpad[0];
-        d.y = hpgl_state.numpad[1];
+        d.x = arc_xc;
+        d.y = arc_yc;
 
     } else {
 
@@ -104,13 +114,15 @@ bool arc_next (hpgl_point_t *target)
 
     if(is_wedge == 3) {
         cont = false;
-        d.x = hpgl_state.numpad[0];
-        d.y = hpgl_state.numpad[1];
+        d.x = arc_xc;
+        d.y = arc_yc;
     }
 
     //printf_P(PSTR("ARC SPAN: (%6.1f %6.1f)-(%6.1f %6.1f)\n"), user_loc.x, user_loc.y, xd, yd);    
 
     userscale(d, target, &hpgl_state.user_loc);
 
+    hpgl_stats.chords++;
+
     return cont;//arc_step < arc_steps ? 1 : 0;
 }
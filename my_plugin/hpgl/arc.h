@@ -3,15 +3,15 @@
 
 #include "hpgl.h"
 
-/// Initialize the arc based on current location and scratchpad data.
-/// @see numpad
+/// Initialize the arc based on current location and command parameters.
+/// @param param xc, yc, angle, chord angle
 /// @see user_loc
 /// @returns 0 if the arc is degenerate (0 degrees or R=0)
-bool arc_init (void);
+bool arc_init (const float *param);
 
-bool wedge_init (void);
+bool wedge_init (const float *param);
 
-bool circle_init (hpgl_point_t *target);
+bool circle_init (const float *param, hpgl_point_t *target);
 
 /// Calculate the next chord. 
 /// @param x next x in absolute stepper coordinates
@@ -1,7 +1,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-// https://educatech.in/c-program-to-implement-sutherland-hodgemann-polygon-clipping-algorithm/
+#include "clip.h"
+#include "config.h"
+
+#include "grbl/hal.h"
+
+// https://en.wikipedia.org/wiki/Cohen%E2%80%93Sutherland_algorithm
 
 enum {
     TOP = 0x1,
@@ -12,13 +17,36 @@ enum {
 
 typedef uint_fast8_t outcode;
 
-float xwmin,xwmax,ywmin,ywmax;
+static int32_t xwmin = 0, xwmax = 0, ywmin = 0, ywmax = 0;
+
+void clip_set_window (void)
+{
+    int32_t t;
+
+    if(hpgl_state.iw_pad[0] > hpgl_state.iw_pad[2]) {
+        t = hpgl_state.iw_pad[0];
+        hpgl_state.iw_pad[0] = hpgl_state.iw_pad[2];
+        hpgl_state.iw_pad[2] = t;
+    }
+
+    if(hpgl_state.iw_pad[1] > hpgl_state.iw_pad[3]) {
+        t = hpgl_state.iw_pad[1];
+        hpgl_state.iw_pad[1] = hpgl_state.iw_pad[3];
+        hpgl_state.iw_pad[3] = t;
+    }
+
+    xwmin = hpgl_state.iw_pad[0] = max(hpgl_state.iw_pad[0], 0);
+    ywmin = hpgl_state.iw_pad[1] = max(hpgl_state.iw_pad[1], 0);
+    xwmax = hpgl_state.iw_pad[2] = min(hpgl_state.iw_pad[2], (int32_t)hpgl_settings.max_x);
+    ywmax = hpgl_state.iw_pad[3] = min(hpgl_state.iw_pad[3], (int32_t)hpgl_settings.max_y);
+}
 
-outcode CompOutCode(float x, float y)
+static outcode CompOutCode (int32_t x, int32_t y)
 {
     outcode code = 0;
+
     if(y > ywmax)
-        code |=TOP;
+        code |= TOP;
     else if(y < ywmin)
         code |= BOTTOM;
 
@@ -30,52 +58,97 @@ outcode CompOutCode(float x, float y)
     return code;
 }
 
-void clip (float x0, float y0, float x1, float y1)
+// Returns a + b * c / d rounded to nearest, d != 0.
+static inline int32_t intersect (int32_t a, int32_t b, int32_t c, int32_t d)
+{
+    int64_t n = (int64_t)b * c;
+
+    if(d < 0) {
+        n = -n;
+        d = -d;
+    }
+
+    return a + (int32_t)((n >= 0 ? n + d / 2 : n - d / 2) / d);
+}
+
+bool clip_inside (hpgl_point_t p)
+{
+    return CompOutCode(p.x, p.y) == 0;
+}
+
+clip_result_t clip_line (hpgl_point_t *p0, hpgl_point_t *p1)
 {
-    outcode outcode0,outcode1,outcodeOut;
-    bool accept = false, done = false;
+    int32_t x0 = p0->x, y0 = p0->y, x1 = p1->x, y1 = p1->y;
+    outcode outcode0, outcode1, outcodeOut;
+    uint_fast8_t iterations = 8; // guard against rounding ping-pong in corners
+
     outcode0 = CompOutCode(x0, y0);
     outcode1 = CompOutCode(x1, y1);
 
+    if(!(outcode0 | outcode1))
+        return Clip_Accepted;
+
     do {
-        if(!(outcode0 | outcode1)) {
-            accept = true;
-            done = true;
+        if(outcode0 & outcode1)
+            return Clip_Rejected;
+
+        int32_t x, y;
+
+        outcodeOut = outcode0 ? outcode0 : outcode1;
+
+        if(outcodeOut & TOP) {
+            x = intersect(x0, x1 - x0, ywmax - y0, y1 - y0);
+            y = ywmax;
+        } else if(outcodeOut & BOTTOM) {
+            x = intersect(x0, x1 - x0, ywmin - y0, y1 - y0);
+            y = ywmin;
+        } else if(outcodeOut & RIGHT) {
+            y = intersect(y0, y1 - y0, xwmax - x0, x1 - x0);
+            x = xwmax;
+        } else {
+            y = intersect(y0, y1 - y0, xwmin - x0, x1 - x0);
+            x = xwmin;
         }
-        else if(!(done = !!(outcode0 & outcode1))) {
-
-            float x, y;
-
-            outcodeOut = outcode0 ? outcode0 : outcode1;
-
-            if(outcodeOut & TOP) {
-                x = x0 + (x1 - x0) * (ywmax - y0) / (y1 - y0);
-                y = ywmax;
-            } else if(outcodeOut & BOTTOM) {
-                x = x0 + (x1 - x0) * (ywmin - y0) / (y1 - y0);
-                y = ywmin;
-            } else if(outcodeOut & RIGHT) {
-                y = y0 + (y1 - y0) * (xwmax - x0) / (x1 - x0);
-                x = xwmax;
-            } else {
-                y = y0 + (y1 - y0) * (xwmin -x0) / (x1 - x0);
-                x = xwmin;
-            }
-            if(outcodeOut == outcode0) {
-                x0 = x;
-                y0 = y;
-                outcode0 = CompOutCode(x0,y0);
-            } else {
-                x1 = x;
-                y1 = y;
-                outcode1 = CompOutCode(x1,y1);
-            }
+
+        if(outcodeOut == outcode0) {
+            x0 = x;
+            y0 = y;
+            outcode0 = CompOutCode(x0, y0);
+        } else {
+            x1 = x;
+            y1 = y;
+            outcode1 = CompOutCode(x1, y1);
         }
-    } while(!done);
-/*
-    if(accept)
-    line(x0,y0,x1,y1);
-    outtextxy(150,20,"POLYGON AFTER CLIPPING");
-    rectangle(xwmin,ywmin,xwmax,ywmax);
-    */
+    } while((outcode0 | outcode1) && --iterations);
+
+    if(outcode0 | outcode1)
+        return Clip_Rejected;
+
+    p0->x = (hpgl_coord_t)x0;
+    p0->y = (hpgl_coord_t)y0;
+    p1->x = (hpgl_coord_t)x1;
+    p1->y = (hpgl_coord_t)y1;
+
+    return Clip_Clipped;
+}
+
+void output_window (void)
+{
+    hal.stream.write(uitoa(xwmin));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(ywmin));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(xwmax));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(ywmax));
+    hal.stream.write(hpgl_state.term);
+}
+
+void output_hardclip (void)
+{
+    hal.stream.write("0,0,");
+    hal.stream.write(uitoa(hpgl_settings.max_x));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_settings.max_y));
+    hal.stream.write(hpgl_state.term);
 }
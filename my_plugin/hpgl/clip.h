@@ -0,0 +1,27 @@
+#ifndef _CLIP_H
+#define _CLIP_H
+
+#include "hpgl.h"
+
+typedef enum {
+    Clip_Rejected = 0,  ///< Segment is completely outside the window
+    Clip_Accepted,      ///< Segment is completely inside the window
+    Clip_Clipped        ///< One or both endpoints moved to the window edge
+} clip_result_t;
+
+/// Set clip window from hpgl_state.iw_pad, the window is limited to the hard-clip limits.
+void clip_set_window (void);
+
+/// Check if a point is inside the clip window.
+bool clip_inside (hpgl_point_t p);
+
+/// Cohen-Sutherland line clipping against the clip window, integer math only.
+/// @param p0   start point, moved to the window edge if outside
+/// @param p1   end point, moved to the window edge if outside
+/// @returns    clip result
+clip_result_t clip_line (hpgl_point_t *p0, hpgl_point_t *p1);
+
+void output_window (void);
+void output_hardclip (void);
+
+#endif
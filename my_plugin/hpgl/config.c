@@ -0,0 +1,135 @@
+/// \file config.c
+/// Plotter settings handling, calibration and limits can be changed without rebuilding the firmware.
+///
+/// NOTE: the settings are $450 - $458 (Setting_UserDefined_0 - 8), the same as used by the
+/// Macros_bound_to_aux_inputs plugin. The two plugins cannot be enabled at the same time.
+
+#include "config.h"
+#include "clip.h"
+#include "motori.h"
+
+#include "grbl/hal.h"
+#include "grbl/nvs_buffer.h"
+
+hpgl_settings_t hpgl_settings;
+hpgl_scale_t hpgl_scale = {
+    .mm_per_unit_x = 0.025f,
+    .mm_per_unit_y = 0.025f
+};
+
+static nvs_address_t nvs_address;
+
+static const setting_group_detail_t hpgl_groups [] = {
+    { Group_Root, Group_UserSettings, "HPGL"}
+};
+
+static const setting_detail_t hpgl_setting_details[] = {
+    { Setting_UserDefined_0, Group_UserSettings, "HPGL X units per mm", "units/mm", Format_Decimal, "##0.000", "1", "1000", Setting_NonCore, &hpgl_settings.units_per_mm_x, NULL, NULL },
+    { Setting_UserDefined_1, Group_UserSettings, "HPGL Y units per mm", "units/mm", Format_Decimal, "##0.000", "1", "1000", Setting_NonCore, &hpgl_settings.units_per_mm_y, NULL, NULL },
+    { Setting_UserDefined_2, Group_UserSettings, "HPGL X hard-clip limit", "units", Format_Int16, "####0", "100", "32767", Setting_NonCore, &hpgl_settings.max_x, NULL, NULL },
+    { Setting_UserDefined_3, Group_UserSettings, "HPGL Y hard-clip limit", "units", Format_Int16, "####0", "100", "32767", Setting_NonCore, &hpgl_settings.max_y, NULL, NULL },
+    { Setting_UserDefined_4, Group_UserSettings, "HPGL pen down feed rate", "mm/min", Format_Decimal, "####0", "1", "100000", Setting_NonCore, &hpgl_settings.feed_rate_down, NULL, NULL },
+    { Setting_UserDefined_5, Group_UserSettings, "HPGL pen up feed rate", "mm/min", Format_Decimal, "####0", "0", "100000", Setting_NonCore, &hpgl_settings.feed_rate_up, NULL, NULL },
+    { Setting_UserDefined_6, Group_UserSettings, "HPGL pen down delay", "milliseconds", Format_Int16, "###0", "0", "5000", Setting_NonCore, &hpgl_settings.pen_down_delay, NULL, NULL },
+    { Setting_UserDefined_7, Group_UserSettings, "HPGL pen settle delay", "milliseconds", Format_Int16, "###0", "0", "5000", Setting_NonCore, &hpgl_settings.pen_lift_delay, NULL, NULL },
+    { Setting_UserDefined_8, Group_UserSettings, "HPGL chord angle", "degrees", Format_Decimal, "##0.0", "0.5", "180", Setting_NonCore, &hpgl_settings.chord_angle, NULL, NULL }
+};
+
+#ifndef NO_SETTINGS_DESCRIPTIONS
+
+static const setting_descr_t hpgl_settings_descr[] = {
+    { Setting_UserDefined_0, "Plotter units per mm of X travel, nominal is 40 units/mm. Adjust to calibrate the plot size." },
+    { Setting_UserDefined_1, "Plotter units per mm of Y travel, nominal is 40 units/mm. Adjust to calibrate the plot size." },
+    { Setting_UserDefined_2, "X hard-clip limit in plotter units, moves are clipped to this limit and it is reported by OH." },
+    { Setting_UserDefined_3, "Y hard-clip limit in plotter units, moves are clipped to this limit and it is reported by OH." },
+    { Setting_UserDefined_4, "Default pen down feed rate, used until changed by VS." },
+    { Setting_UserDefined_5, "Pen up feed rate. Set to 0 to use rapid motion for pen up moves." },
+    { Setting_UserDefined_6, "Delay before the pen is lowered." },
+    { Setting_UserDefined_7, "Delay after the pen is raised or lowered to let it settle." },
+    { Setting_UserDefined_8, "Default chord angle for arcs and circles, used when an arc or circle command does not specify one." }
+};
+
+#endif
+
+// Recalculate derived values so that the motion path does not have to divide.
+// If the hard-clip limits are changed the input window is reset to the new limits.
+#if GRBL_BUILD >= 20231120
+static void hpgl_settings_changed (settings_t *settings, settings_changed_flags_t changed)
+#else
+static void hpgl_settings_changed (settings_t *settings)
+#endif
+{
+    static uint16_t max_x = 0, max_y = 0;
+
+    hpgl_scale.mm_per_unit_x = 1.0f / hpgl_settings.units_per_mm_x;
+    hpgl_scale.mm_per_unit_y = 1.0f / hpgl_settings.units_per_mm_y;
+
+    if(max_x != hpgl_settings.max_x || max_y != hpgl_settings.max_y) {
+        max_x = hpgl_settings.max_x;
+        max_y = hpgl_settings.max_y;
+        hpgl_state.iw_pad[0] = hpgl_state.iw_pad[1] = 0;
+        hpgl_state.iw_pad[2] = max_x;
+        hpgl_state.iw_pad[3] = max_y;
+        clip_set_window();
+    }
+}
+
+static void hpgl_settings_save (void)
+{
+    hal.nvs.memcpy_to_nvs(nvs_address, (uint8_t *)&hpgl_settings, sizeof(hpgl_settings_t), true);
+}
+
+static void hpgl_settings_defaults (void)
+{
+    hpgl_settings.units_per_mm_x = 40.0f;
+    hpgl_settings.units_per_mm_y = 40.0f;
+    hpgl_settings.max_x = MAX_X;
+    hpgl_settings.max_y = MAX_Y;
+    hpgl_settings.feed_rate_down = 1000.0f;
+    hpgl_settings.feed_rate_up = 0.0f;
+    hpgl_settings.pen_down_delay = PEN_DOWN_DELAY;
+    hpgl_settings.pen_lift_delay = PEN_LIFT_DELAY;
+    hpgl_settings.chord_angle = 5.0f;
+}
+
+static void hpgl_settings_restore (void)
+{
+    hpgl_settings_defaults();
+
+    hal.nvs.memcpy_to_nvs(nvs_address, (uint8_t *)&hpgl_settings, sizeof(hpgl_settings_t), true);
+}
+
+static void hpgl_settings_load (void)
+{
+    if(hal.nvs.memcpy_from_nvs((uint8_t *)&hpgl_settings, nvs_address, sizeof(hpgl_settings_t), true) != NVS_TransferResult_OK)
+        hpgl_settings_restore();
+
+#if GRBL_BUILD >= 20231120
+    hpgl_settings_changed(NULL, (settings_changed_flags_t){0});
+#else
+    hpgl_settings_changed(NULL);
+#endif
+}
+
+void hpgl_settings_init (void)
+{
+    static setting_details_t setting_details = {
+        .groups = hpgl_groups,
+        .n_groups = sizeof(hpgl_groups) / sizeof(setting_group_detail_t),
+        .settings = hpgl_setting_details,
+        .n_settings = sizeof(hpgl_setting_details) / sizeof(setting_detail_t),
+    #ifndef NO_SETTINGS_DESCRIPTIONS
+        .descriptions = hpgl_settings_descr,
+        .n_descriptions = sizeof(hpgl_settings_descr) / sizeof(setting_descr_t),
+    #endif
+        .on_changed = hpgl_settings_changed,
+        .save = hpgl_settings_save,
+        .load = hpgl_settings_load,
+        .restore = hpgl_settings_restore
+    };
+
+    if((nvs_address = nvs_alloc(sizeof(hpgl_settings_t))))
+        settings_register(&setting_details);
+    else
+        hpgl_settings_defaults();
+}
@@ -0,0 +1,31 @@
+#ifndef _CONFIG_H
+#define _CONFIG_H
+
+#include "hpgl.h"
+
+/// Plotter settings, stored in non volatile storage (NVS).
+typedef struct {
+    float units_per_mm_x;   ///< plotter units per mm of travel, calibration
+    float units_per_mm_y;
+    uint16_t max_x;         ///< hard-clip limits in plotter units
+    uint16_t max_y;
+    float feed_rate_down;   ///< default pen down feed rate, mm/min
+    float feed_rate_up;     ///< pen up feed rate, mm/min. 0 for rapid motion
+    uint16_t pen_down_delay;///< delay before lowering the pen, milliseconds
+    uint16_t pen_lift_delay;///< pen settle delay, milliseconds
+    float chord_angle;      ///< default chord tolerance for arcs and circles, degrees
+} hpgl_settings_t;
+
+/// Values derived from the settings, recalculated on settings changes.
+typedef struct {
+    float mm_per_unit_x;
+    float mm_per_unit_y;
+} hpgl_scale_t;
+
+extern hpgl_settings_t hpgl_settings;
+extern hpgl_scale_t hpgl_scale;
+
+/// Allocate NVS storage and register the settings with the core.
+void hpgl_settings_init (void);
+
+#endif
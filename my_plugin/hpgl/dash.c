@@ -0,0 +1,134 @@
+/// \file dash.c
+/// Line type (LT) patterns, splits pen down vectors into dashes and gaps.
+
+#include <math.h>
+
+#include "dash.h"
+
+// Gaps shorter than the threshold are deliberately plotted with the pen down: they are narrower than
+// the pen tip and a lift costs a pen settle delay. This is bounded by the percentage of the pattern
+// length that may be plotted this way so that short patterns do not turn into solid lines.
+#ifndef HPGL_DASH_LIFT_THRESHOLD
+#define HPGL_DASH_LIFT_THRESHOLD 4 // plotter units
+#endif
+#ifndef HPGL_DASH_MERGE_MAX
+#define HPGL_DASH_MERGE_MAX 10 // percent of the pattern length
+#endif
+
+#define DASH_MAX_SEGMENTS 6
+
+// Segment lengths in percent of the pattern length, alternating dash and gap.
+// Pattern 0, dots at the end of each vector, is handled separately.
+static const struct {
+    uint8_t segments;
+    uint8_t length[DASH_MAX_SEGMENTS];
+} patterns[] = {
+    { 2, { 0, 100 } },
+    { 2, { 50, 50 } },
+    { 2, { 70, 30 } },
+    { 4, { 80, 10, 0, 10 } },
+    { 4, { 70, 10, 10, 10 } },
+    { 6, { 50, 10, 10, 10, 10, 10 } }
+};
+
+static uint8_t type = LINETYPE_SOLID, segments, seg;
+static bool dot_pending, lift[DASH_MAX_SEGMENTS];
+static float length[DASH_MAX_SEGMENTS], seg_left;
+static float org_x, org_y, ux, uy, vector_length, travelled;
+
+void dash_configure (void)
+{
+    type = hpgl_state.pattern_type;
+
+    if(type != LINETYPE_SOLID && type != 0) {
+
+        float pattern_length = hypotf((float)(hpgl_state.ip_pad[2] - hpgl_state.ip_pad[0]),
+                                      (float)(hpgl_state.ip_pad[3] - hpgl_state.ip_pad[1])) * hpgl_state.pattern_length / 100.0f;
+
+        if(pattern_length < 1.0f)
+            type = LINETYPE_SOLID;
+        else {
+            uint_fast8_t i, merged = 0;
+            segments = patterns[type - 1].segments;
+            for(i = 0; i < segments; i++) {
+                length[i] = pattern_length * (float)patterns[type - 1].length[i] / 100.0f;
+                if((lift[i] = !!(i & 0b1)) && length[i] < (float)HPGL_DASH_LIFT_THRESHOLD &&
+                     merged + patterns[type - 1].length[i] <= HPGL_DASH_MERGE_MAX) {
+                    lift[i] = false;
+                    merged += patterns[type - 1].length[i];
+                }
+            }
+        }
+    }
+
+    dash_restart();
+}
+
+bool dash_enabled (void)
+{
+    return type != LINETYPE_SOLID;
+}
+
+void dash_restart (void)
+{
+    seg = 0;
+    seg_left = length[0];
+}
+
+void dash_begin (hpgl_point_t from, hpgl_point_t to)
+{
+    org_x = (float)from.x;
+    org_y = (float)from.y;
+    ux = (float)(to.x - from.x);
+    uy = (float)(to.y - from.y);
+    travelled = 0.0f;
+    dot_pending = type == 0;
+
+    if((vector_length = hypotf(ux, uy)) > 0.0f) {
+        ux /= vector_length;
+        uy /= vector_length;
+    }
+}
+
+bool dash_next (hpgl_point_t *point, bool *pen_down)
+{
+    if(type == 0) {
+
+        // Move to the end point with the pen up, then plot a dot.
+        if(travelled < vector_length) {
+            travelled = vector_length;
+            *pen_down = false;
+        } else if(dot_pending) {
+            dot_pending = false;
+            *pen_down = true;
+        } else
+            return false;
+
+    } else {
+
+        float step;
+
+        if(travelled >= vector_length)
+            return false;
+
+        step = vector_length - travelled;
+        if(step > seg_left)
+            step = seg_left;
+
+        travelled += step;
+        seg_left -= step;
+
+        *pen_down = !lift[seg];
+
+        if(seg_left <= 0.0f) {
+            if(++seg == segments)
+                seg = 0;
+            seg_left = length[seg];
+        }
+    }
+
+    point->x = (hpgl_coord_t)lroundf(org_x + ux * travelled);
+    point->y = (hpgl_coord_t)lroundf(org_y + uy * travelled);
+
+    return true;
+}
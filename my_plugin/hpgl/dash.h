@@ -0,0 +1,29 @@
+#ifndef _DASH_H
+#define _DASH_H
+
+#include "hpgl.h"
+
+/// Configure the line pattern from hpgl_state.pattern_type, hpgl_state.pattern_length and P1/P2.
+/// Restarts the pattern.
+void dash_configure (void);
+
+/// Check if a line pattern is active.
+bool dash_enabled (void);
+
+/// Restart the pattern at the first dash, called when the pen is lowered.
+void dash_restart (void);
+
+/// Start splitting a pen down vector into dashes and gaps, the pattern phase is carried over from the previous vector.
+/// @param from start point in plotter coordinates
+/// @param to   end point in plotter coordinates
+void dash_begin (hpgl_point_t from, hpgl_point_t to);
+
+/// Get the next dash or gap of the vector set up by dash_begin().
+/// Gaps shorter than HPGL_DASH_LIFT_THRESHOLD are returned as dashes as long as these make up no more
+/// than HPGL_DASH_MERGE_MAX percent of the pattern.
+/// @param point    output: end point of the segment
+/// @param pen_down output: true for a dash, false for a gap
+/// @returns false when the vector is completed
+bool dash_next (hpgl_point_t *point, bool *pen_down);
+
+#endif
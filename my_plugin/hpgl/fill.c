@@ -0,0 +1,220 @@
+/// \file fill.c
+/// Polygon buffer and scanline fill, uses an active edge table so only the intersections
+/// of the current scanline are kept in memory.
+
+#include <stdlib.h>
+
+#include "fill.h"
+
+typedef struct {
+    hpgl_coord_t x;
+    hpgl_coord_t y;
+    bool start;         ///< first vertex of a subpolygon
+} vertex_t;
+
+typedef struct {
+    uint16_t lo;        ///< vertex with lowest y
+    uint16_t hi;        ///< vertex with highest y
+} edge_t;
+
+static bool mode = false;
+static uint_fast16_t n_vertices = 0;
+static vertex_t vertex[HPGL_POLYGON_SIZE];
+static edge_t edge[HPGL_POLYGON_SIZE];
+static uint16_t active[HPGL_POLYGON_SIZE];
+static uint16_t xe[HPGL_POLYGON_SIZE];    ///< edge of each intersection in xs
+static float xs[HPGL_POLYGON_SIZE];
+
+static void add_vertex (hpgl_point_t point, bool start)
+{
+    // Replace a subpolygon start with no edges
+    if(n_vertices && vertex[n_vertices - 1].start && start)
+        n_vertices--;
+
+    vertex[n_vertices].x = point.x;
+    vertex[n_vertices].y = point.y;
+    vertex[n_vertices++].start = start;
+}
+
+void polygon_begin (hpgl_point_t start)
+{
+    mode = true;
+    n_vertices = 0;
+    add_vertex(start, true);
+}
+
+void polygon_close (hpgl_point_t start)
+{
+    if(n_vertices < HPGL_POLYGON_SIZE)
+        add_vertex(start, true);
+}
+
+void polygon_end (void)
+{
+    mode = false;
+}
+
+bool polygon_mode (void)
+{
+    return mode;
+}
+
+bool polygon_add (hpgl_point_t point, bool pen_down)
+{
+    if(n_vertices == HPGL_POLYGON_SIZE)
+        return false;
+
+    if(pen_down && point.x == vertex[n_vertices - 1].x && point.y == vertex[n_vertices - 1].y)
+        return true;
+
+    add_vertex(point, !pen_down);
+
+    return true;
+}
+
+// Returns index of the last vertex in the subpolygon starting at first
+static uint_fast16_t subpolygon_end (uint_fast16_t first)
+{
+    while(++first < n_vertices && !vertex[first].start);
+
+    return first - 1;
+}
+
+static inline hpgl_point_t point (uint_fast16_t idx)
+{
+    hpgl_point_t p = { .x = vertex[idx].x, .y = vertex[idx].y };
+
+    return p;
+}
+
+void polygon_edge (fill_line_ptr line)
+{
+    uint_fast16_t first = 0, last, i;
+
+    while(first < n_vertices) {
+        if((last = subpolygon_end(first)) > first) {
+            for(i = first; i < last; i++)
+                line(point(i), point(i + 1));
+            line(point(last), point(first));
+        }
+        first = last + 1;
+    }
+}
+
+static int cmp_edge (const void *a, const void *b)
+{
+    return (int)vertex[((const edge_t *)a)->lo].y - (int)vertex[((const edge_t *)b)->lo].y;
+}
+
+static inline void add_edge (uint_fast16_t *n, uint_fast16_t a, uint_fast16_t b)
+{
+    if(vertex[a].y != vertex[b].y) { // horizontal edges do not intersect scanlines
+        edge[*n].lo = vertex[a].y < vertex[b].y ? a : b;
+        edge[*n].hi = vertex[a].y < vertex[b].y ? b : a;
+        (*n)++;
+    }
+}
+
+// Returns true if the pen can be kept down from the end of a span on edge e0 to the start of a span on
+// edge e1 on the next scanline: both are on the same edge or on edges meeting at a vertex outside the
+// connecting move, so the move follows the polygon outline without leaving the polygon.
+static bool joinable (uint_fast16_t e0, uint_fast16_t e1, hpgl_point_t p0, hpgl_point_t p1, bool right)
+{
+    int64_t cross;
+    uint_fast16_t v = edge[e0].hi;
+
+    if(e0 == e1)
+        return true;
+
+    if(v != edge[e1].lo)
+        return false;
+
+    // Negative if the vertex is to the right of the move from p0 to p1
+    cross = (int64_t)(p1.x - p0.x) * (vertex[v].y - p0.y) - (int64_t)(p1.y - p0.y) * (vertex[v].x - p0.x);
+
+    return right ? cross <= 0 : cross >= 0;
+}
+
+void polygon_fill (hpgl_coord_t spacing, fill_line_ptr line)
+{
+    bool reverse = false;
+    int32_t y, ymax;
+    uint_fast16_t n_edges = 0, n_active = 0, next = 0, first = 0, last, i, j, a, b, prev_edge = 0;
+    hpgl_point_t from, to, prev;
+
+    if(spacing < 1)
+        spacing = 1;
+
+    // Build edge table sorted on lowest y
+    while(first < n_vertices) {
+        if((last = subpolygon_end(first)) > first) {
+            for(i = first; i < last; i++)
+                add_edge(&n_edges, i, i + 1);
+            add_edge(&n_edges, last, first);
+        }
+        first = last + 1;
+    }
+
+    if(n_edges == 0)
+        return;
+
+    qsort(edge, n_edges, sizeof(edge_t), cmp_edge);
+
+    for(i = 0, ymax = vertex[edge[0].hi].y; i < n_edges; i++) {
+        if(vertex[edge[i].hi].y > ymax)
+            ymax = vertex[edge[i].hi].y;
+    }
+
+    for(y = vertex[edge[0].lo].y + spacing / 2; y < ymax; y += spacing) {
+
+        // Add edges starting at or below the scanline
+        while(next < n_edges && vertex[edge[next].lo].y <= y)
+            active[n_active++] = next++;
+
+        // Remove edges ending at or below the scanline and calculate intersections, sorted on x
+        for(i = j = 0; i < n_active; i++) {
+
+            edge_t *e = &edge[active[i]];
+
+            if(vertex[e->hi].y > y) {
+
+                uint_fast16_t k = j;
+                float x = (float)vertex[e->lo].x + (float)(y - vertex[e->lo].y) * (float)(vertex[e->hi].x - vertex[e->lo].x) /
+                           (float)(vertex[e->hi].y - vertex[e->lo].y);
+
+                active[j] = active[i];
+                while(k && xs[k - 1] > x) {
+                    xs[k] = xs[k - 1];
+                    xe[k] = xe[k - 1];
+                    k--;
+                }
+                xs[k] = x;
+                xe[k] = active[i];
+                j++;
+            }
+        }
+        n_active = j;
+
+        // Output spans between pairs of intersections, alternating direction. The first span is joined
+        // to the last span of the previous scanline with a pen down move if they share the polygon edge,
+        // the pen is lifted only between disjoint spans.
+        from.y = to.y = (hpgl_coord_t)y;
+        for(i = 0; i + 1 < n_active; i += 2) {
+            j = reverse ? n_active - (n_active & 1) - 2 - i : i;
+            a = reverse ? j + 1 : j;
+            b = reverse ? j : j + 1;
+            from.x = (hpgl_coord_t)(xs[a] + 0.5f);
+            to.x = (hpgl_coord_t)(xs[b] + 0.5f);
+            if(i == 0 && prev_edge && joinable(prev_edge - 1, xe[a], prev, from, reverse))
+                line(prev, from);
+            line(from, to);
+            prev = to;
+            prev_edge = xe[b] + 1;
+        }
+
+        if(n_active < 2)
+            prev_edge = 0;
+
+        reverse = !reverse;
+    }
+}
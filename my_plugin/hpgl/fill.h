@@ -0,0 +1,39 @@
+#ifndef _FILL_H
+#define _FILL_H
+
+#include "hpgl.h"
+
+#ifndef HPGL_POLYGON_SIZE
+#define HPGL_POLYGON_SIZE 128 // max. number of vertices in polygon buffer
+#endif
+
+typedef void (*fill_line_ptr)(hpgl_point_t from, hpgl_point_t to);
+
+/// Enter polygon mode (PM0), clears the polygon buffer.
+/// @param start pen location, first vertex of the polygon
+void polygon_begin (hpgl_point_t start);
+
+/// Close the current subpolygon (PM1), the next subpolygon starts at the pen location.
+void polygon_close (hpgl_point_t start);
+
+/// Exit polygon mode (PM2), the polygon is kept in the buffer for FP and EP.
+void polygon_end (void);
+
+bool polygon_mode (void);
+
+/// Add a vertex to the polygon buffer, pen up moves start a new subpolygon.
+/// @returns false on buffer overflow
+bool polygon_add (hpgl_point_t point, bool pen_down);
+
+/// Outline the subpolygons in the buffer (EP).
+void polygon_edge (fill_line_ptr line);
+
+/// Fill the polygon in the buffer with horizontal hatch lines using the even-odd rule (FP).
+/// Hatch lines are generated one scanline at a time and alternate in direction, a span is joined to the
+/// span on the previous scanline with a pen down move when both end on the same polygon edge or on edges
+/// meeting at a convex vertex.
+/// @param spacing  distance between hatch lines in plotter units
+/// @param line     called for each hatch line
+void polygon_fill (hpgl_coord_t spacing, fill_line_ptr line);
+
+#endif
@@ -0,0 +1,289 @@
+/// \file gcode.c
+/// HPGL to G-code converter, runs the HPGL engine with output to a file instead of to the planner.
+/// The generated G-code is modal compressed: motion mode, feed rate and unchanged axis words are only
+/// output when changed.
+/// When pen change is enabled (HPGL_PENS > 0) the file is plotted in one pass per pen used so that each pen
+/// is only picked up once, the first pass is a dry run for finding which pens are used.
+
+#include <string.h>
+
+#include "hpgl.h"
+#include "motori.h"
+#include "gcode.h"
+#include "config.h"
+
+#include "grbl/vfs.h"
+
+#if HPGL_PENS > 31
+#error "Max. 31 pens supported by the G-code converter!"
+#endif
+
+static vfs_file_t *file;
+static uint32_t n_lines;
+static struct {
+    bool rapid;
+    bool motion_valid;
+    bool pos_valid;
+    float feed_rate;
+    hpgl_point_t pos;
+} modal;
+
+static struct {
+    bool scan;              ///< dry run, find pens used
+    bool tool;              ///< pen picked up in this pass
+    uint_fast16_t pen;      ///< pen plotted in this pass
+    uint32_t used;          ///< bitmask of pens used
+    uint32_t changes;       ///< number of pen changes in plot order
+    hpgl_point_t pos;       ///< position, also tracked for other pens
+} pass;
+
+static inline bool pass_active (void)
+{
+#if HPGL_PENS
+    return !pass.scan && get_pen() == pass.pen;
+#else
+    return true;
+#endif
+}
+
+static void gcode_write (const char *line)
+{
+    vfs_puts(line, file);
+    n_lines++;
+}
+
+static bool gcode_move (hpgl_point_t point, bool rapid, float feed_rate)
+{
+    char buf[50] = "";
+
+    pass.pos = point;
+
+    if(pass.scan && get_pen_status() == Pen_Down)
+        pass.used |= (1u << get_pen());
+
+    if(!pass_active())
+        return true;
+
+    if(modal.pos_valid && point.x == modal.pos.x && point.y == modal.pos.y)
+        return true;
+
+    if(!modal.motion_valid || modal.rapid != rapid) {
+        strcpy(buf, rapid ? "G0" : "G1");
+        modal.rapid = rapid;
+        modal.motion_valid = true;
+    }
+
+    if(!modal.pos_valid || point.x != modal.pos.x) {
+        strcat(buf, "X");
+        strcat(buf, ftoa((float)point.x * hpgl_scale.mm_per_unit_x, 3));
+    }
+
+    if(!modal.pos_valid || point.y != modal.pos.y) {
+        strcat(buf, "Y");
+        strcat(buf, ftoa((float)point.y * hpgl_scale.mm_per_unit_y, 3));
+    }
+
+    if(!rapid && feed_rate != modal.feed_rate) {
+        strcat(buf, "F");
+        strcat(buf, ftoa(feed_rate, 0));
+        modal.feed_rate = feed_rate;
+    }
+
+    strcat(buf, "\n");
+    gcode_write(buf);
+
+    modal.pos = point;
+    modal.pos_valid = true;
+
+    return true;
+}
+
+static void gcode_pen (pen_status_t state)
+{
+    char buf[20];
+
+    if(!pass_active())
+        return;
+
+    if(state == Pen_Down) {
+        // Position may have changed while plotting with other pens
+        if(!modal.pos_valid || modal.pos.x != pass.pos.x || modal.pos.y != pass.pos.y)
+            gcode_move(pass.pos, true, 0.0f);
+        gcode_write("M3S1000\n");
+        strcpy(buf, "G4P");
+        strcat(buf, ftoa((float)(hpgl_settings.pen_down_delay + hpgl_settings.pen_lift_delay) / 1000.0f, 3));
+    } else {
+        gcode_write("M5\n");
+        strcpy(buf, "G4P");
+        strcat(buf, ftoa((float)hpgl_settings.pen_lift_delay / 1000.0f, 3));
+    }
+
+    strcat(buf, "\n");
+    gcode_write(buf);
+}
+
+static bool gcode_tool (uint_fast16_t pen)
+{
+    char buf[12];
+
+    if(pass.scan)
+        pass.changes++;
+    else if(pen == pass.pen && !pass.tool) {
+        strcpy(buf, "M6T");
+        strcat(buf, uitoa(pen));
+        strcat(buf, "\n");
+        gcode_write(buf);
+        pass.tool = true;
+        modal.pos_valid = modal.motion_valid = false;
+    }
+
+    return true;
+}
+
+static void gcode_sync (void)
+{
+    // NOOP
+}
+
+static const hpgl_output_t gcode_output = {
+    .live = false,
+    .move = gcode_move,
+    .pen = gcode_pen,
+    .tool = gcode_tool,
+    .sync = gcode_sync
+};
+
+// Run the HPGL engine on the input file, n_bytes may be NULL.
+static bool convert_pass (char *name, uint32_t *n_bytes)
+{
+    char buf[64];
+    size_t n, i;
+    vfs_file_t *in;
+    enum {
+        Esc_None = 0,
+        Esc_Start,      ///< ESC received, expecting .
+        Esc_Command,    ///< ESC. received, expecting command character
+        Esc_Parameters  ///< ESC.@, ESC.H, ESC.I, ESC.M or ESC.N, parameters up to and including :
+    } esc = Esc_None;
+
+    if((in = vfs_open(name, "r")) == NULL)
+        return false;
+
+    pass.tool = false;
+    hpgl_set_output(&gcode_output);
+    plotter_init();
+
+    while((n = vfs_read(buf, 1, sizeof(buf), in))) {
+        if(n_bytes)
+            *n_bytes += n;
+        for(i = 0; i < n; i++) {
+            // Skip device control instructions, these are only meaningful for live input.
+            if(buf[i] == ASCII_ESC)
+                esc = Esc_Start;
+            else switch(esc) {
+
+                case Esc_Start:
+                    esc = buf[i] == '.' ? Esc_Command : Esc_None;
+                    break;
+
+                case Esc_Command:
+                    esc = buf[i] && strchr("@HIMN", buf[i]) ? Esc_Parameters : Esc_None;
+                    break;
+
+                case Esc_Parameters:
+                    if(buf[i] == ':')
+                        esc = Esc_None;
+                    break;
+
+                default:
+                    if(buf[i] != ASCII_CAN)
+                        do_stuff(buf[i]);
+                    break;
+            }
+        }
+    }
+
+    pen_control(Pen_Up);
+
+    vfs_close(in);
+
+    return true;
+}
+
+status_code_t hpgl_to_gcode (sys_state_t state, char *args)
+{
+    char *outname;
+    uint32_t n_bytes = 0, ms;
+    bool ok;
+#if HPGL_PENS
+    uint_fast16_t pens = 0;
+#endif
+
+    if(args == NULL || (outname = strchr(args, ',')) == NULL)
+        return Status_InvalidStatement;
+
+    // The converter shares the engine state with the live session.
+    if(hpgl_session_active())
+        return Status_IdleError;
+
+    *outname++ = '\0';
+
+    if((file = vfs_open(outname, "w")) == NULL)
+        return Status_FileOpenFailed;
+
+    ms = hal.get_elapsed_ticks();
+    n_lines = 0;
+    memset(&modal, 0, sizeof(modal));
+    memset(&pass, 0, sizeof(pass));
+
+    gcode_write("G21G90G17\n");
+
+#if HPGL_PENS
+    pass.scan = true;
+    if((ok = convert_pass(args, &n_bytes))) {
+        pass.scan = false;
+        for(pass.pen = 0; ok && pass.pen <= HPGL_PENS; pass.pen++) {
+            if(pass.used & (1u << pass.pen)) {
+                if(pass.pen)
+                    pens++;
+                ok = convert_pass(args, NULL);
+            }
+        }
+        if(pens)
+            gcode_write("M6T0\n");
+    }
+#else
+    ok = convert_pass(args, &n_bytes);
+#endif
+
+    gcode_write("M2\n");
+
+    hpgl_set_output(NULL);
+
+    vfs_close(file);
+
+    if(!ok)
+        return Status_FileOpenFailed;
+
+    ms = hal.get_elapsed_ticks() - ms;
+
+    hal.stream.write("[MSG:HPGL ");
+    hal.stream.write(uitoa(n_bytes));
+    hal.stream.write(" bytes -> ");
+    hal.stream.write(uitoa(n_lines));
+    hal.stream.write(" lines in ");
+    hal.stream.write(uitoa(ms));
+    hal.stream.write(" ms, ");
+    hal.stream.write(uitoa(ms ? (uint32_t)((uint64_t)n_bytes * 1000 / ms) : n_bytes));
+    hal.stream.write(" bytes/s");
+#if HPGL_PENS
+    hal.stream.write(", ");
+    hal.stream.write(uitoa(pens));
+    hal.stream.write(" pen changes (");
+    hal.stream.write(uitoa(pass.changes));
+    hal.stream.write(" in plot order)");
+#endif
+    hal.stream.write("]" ASCII_EOL);
+
+    return Status_OK;
+}
@@ -0,0 +1,9 @@
+#ifndef _GCODE_H
+#define _GCODE_H
+
+#include "grbl/hal.h"
+
+/// $HPGL2GCODE=<hpgl file>,<gcode file> - convert HPGL file to G-code.
+status_code_t hpgl_to_gcode (sys_state_t state, char *args);
+
+#endif
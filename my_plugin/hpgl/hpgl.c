@@ -4,6 +4,9 @@
 
 #include "hpgl.h"
 #include "scale.h"
+#include "clip.h"
+#include "dash.h"
+#include "config.h"
 
 #include "grbl/hal.h"
 #include "grbl/nuts_bolts.h"
@@ -12,12 +15,11 @@ extern const char *const charset0[256];
 extern const char *const charset173[256];
 
 static const hpgl_state_t defaults = {
-    .chord_angle = 5.0f,
     .pen_thickness = .3f,
     .plot_relative = false,
     .etxchar = ASCII_ETX, // ^C
     .term = ASCII_EOL,
-    .pattern_type = 0,
+    .pattern_type = LINETYPE_SOLID,
     .pattern_length = 4.0f,
 #ifdef HPGL_A3
     .character_size.width = 0.187f,
@@ -35,14 +37,6 @@ static const hpgl_state_t defaults = {
     .last_error = ERR_None,
     .errmask = 0,
     .alertmask = 223,
-    .ip_pad[0] = 0,
-    .ip_pad[1] = 0,
-    .ip_pad[2] = MAX_X,
-    .ip_pad[3] = MAX_Y,
-    .sc_pad[0] = 0,
-    .sc_pad[1] = MAX_X,
-    .sc_pad[2] = 0,
-    .sc_pad[3] = MAX_Y,
     .user_loc.x = 0.0f,
     .user_loc.y = 0.0f,
     .flags.initialized = On,
@@ -54,9 +48,11 @@ extern pen_status_t get_pen_status (void);
 hpgl_state_t hpgl_state;
 hpgl_char_ptr hpgl_char;
 
-static hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb);
+static const hpgl_command_record_t *hpgl_char_inp (char c);
 
 static char scratchpad[SCRATCHPAD_SIZE];
+static uint_fast8_t record_idx = 0;
+static hpgl_command_record_t records[HPGL_COMMAND_RECORDS], *record = &records[0];
 
 __attribute__((weak)) void alert_led (bool on)
 {
@@ -69,9 +65,17 @@ void hpgl_init (void)
 
     memcpy(&hpgl_state, &defaults, sizeof(hpgl_state_t));
 
+    // Default chord tolerance and hard-clip limits are from settings
+    hpgl_state.chord_angle = hpgl_settings.chord_angle;
+    hpgl_state.iw_pad[2] = hpgl_settings.max_x;
+    hpgl_state.iw_pad[3] = hpgl_settings.max_y;
+
     hpgl_set_error(hpgl_state.last_error);
 
+    translate_init_ip();
     translate_init_sc();
+    clip_set_window();
+    dash_configure();
 
     hpgl_state.comm.enable_dtr = stream_get_flags(hal.stream).rts_handshake;
 }
@@ -80,6 +84,12 @@ static void hpgl_defaults (void)
 {
     memcpy(&hpgl_state, &defaults, offsetof(hpgl_state_t, ip_pad));
 
+    hpgl_state.chord_angle = hpgl_settings.chord_angle;
+    hpgl_state.iw_pad[2] = hpgl_settings.max_x;
+    hpgl_state.iw_pad[3] = hpgl_settings.max_y;
+
+    clip_set_window();
+    dash_configure();
     hpgl_set_error(hpgl_state.last_error);
 }
 
@@ -112,7 +122,7 @@ bool is_numeric (char c, uint_fast8_t idx)
 
 bool is_whitespace (char c)
 {
-    return c == ' ' || c == '\n' || c == '\r' || c == 't';
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
 }
 
 bool is_command_char (char c)
@@ -170,7 +180,7 @@ hpgl_command_t get_instruction (char c)
     return instruction;
 }
 
-hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
+static hpgl_command_t parse_char (char c, hpgl_point_t *target, uint8_t *lb)
 {
     static uint_fast8_t si, numpad_idx;
     static hpgl_command_t command = CMD_CONT;
@@ -185,19 +195,14 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
     if(is_labeling) {
         if((is_labeling = c != hpgl_state.etxchar)) {
-
             *lb = c;
-
-            if(hpgl_state.comm.monitor_on && hpgl_state.comm.monitor_on)
-                hal.stream.write_char(c);
-
             return command;
         }
         return command = CMD_CONT;
     }
 
-    if(is_labelterminator) { // DT: Set text terminator
-        hpgl_state.etxchar = c;
+    if(is_labelterminator) { // DT: Set text terminator, restore default if not a valid terminator
+        hpgl_state.etxchar = c == ';' || c == '\0' || c == ASCII_LF || c == ASCII_ESC ? ASCII_ETX : c;
         is_labelterminator = false;
         return command = CMD_CONT;
     }
@@ -228,7 +233,7 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
             numpad_idx = 4;
             do {
-                hpgl_state.numpad[--numpad_idx] = 0.0f;
+                record->param[--numpad_idx] = 0.0f;
             } while(numpad_idx);
         }
     } else if(get_parameter(&c, &si)) {
@@ -239,8 +244,8 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
         scratchpad[si] = '\0';
         si = 0;
 
-        if(numpad_idx < sizeof(hpgl_state.numpad)) {
-            read_float(scratchpad, &si, &hpgl_state.numpad[numpad_idx++]);
+        if(numpad_idx < sizeof(record->param) / sizeof(float)) {
+            read_float(scratchpad, &si, &record->param[numpad_idx++]);
             si = 0;
         }
 
@@ -257,7 +262,7 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
             case CMD_AA:
                 cmd = CMD_AA;
                 if (numpad_idx == 3)
-                    hpgl_state.numpad[3] = hpgl_state.chord_angle;
+                    record->param[3] = hpgl_state.chord_angle;
                 cmd = command;
                 break;
 
@@ -267,13 +272,13 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                     hpgl_set_error(ERR_WrongParams);
                 } else {
                     if (numpad_idx == 3)
-                        hpgl_state.numpad[3] = hpgl_state.chord_angle;
+                        record->param[3] = hpgl_state.chord_angle;
                     user_point_t f, offset = { 0.0f, 0.0f };
-                    f.x = hpgl_state.numpad[0];
-                    f.y = hpgl_state.numpad[1];
+                    f.x = record->param[0];
+                    f.y = record->param[1];
                     userscalerelative(f, target, &offset);
-                    hpgl_state.numpad[0] = hpgl_state.user_loc.x + offset.x;
-                    hpgl_state.numpad[1] = hpgl_state.user_loc.y + offset.y;
+                    record->param[0] = hpgl_state.user_loc.x + offset.x;
+                    record->param[1] = hpgl_state.user_loc.y + offset.y;
                     target->x = target->y = -1;
                     cmd = command;
                 }
@@ -281,11 +286,11 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
             case CMD_CA: // CA: Designate alternate character set
                 if(numpad_idx == 0) {
-                    hpgl_state.numpad[0] = 0.0f;
+                    record->param[0] = 0.0f;
                     numpad_idx = 1;
                 }
                 if(numpad_idx == 1) {
-                    hpgl_state.charset_alt = hpgl_state.numpad[0] == 0.0f ? &charset0[0] : &charset173[0];
+                    hpgl_state.charset_alt = record->param[0] == 0.0f ? &charset0[0] : &charset173[0];
                     if(hpgl_state.use_alt_charset)
                         hpgl_state.charset = hpgl_state.charset_alt;
                 } else {
@@ -297,7 +302,7 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
             case CMD_CI: // CI: Circle - radius [,Degrees per step]
                 if(numpad_idx > 0) {
                     if(numpad_idx == 1)
-                        hpgl_state.numpad[1] = hpgl_state.chord_angle;
+                        record->param[1] = hpgl_state.chord_angle;
                     userscale(hpgl_state.user_loc, target, &hpgl_state.user_loc);
                     cmd = command;
                 } else {
@@ -308,21 +313,21 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
             case CMD_CP: // CP: Character Plot
                 if(numpad_idx == 0) {
-                    hpgl_state.numpad[0] = NAN;
-                    hpgl_state.numpad[1] = NAN;
+                    record->param[0] = NAN;
+                    record->param[1] = NAN;
                 }
                 if(numpad_idx == 1)
-                    hpgl_state.numpad[1] = 0.0f;
+                    record->param[1] = 0.0f;
                 cmd = command;
                 break;
 
             case CMD_CS: // CA: Designate standard character set
                 if(numpad_idx == 0) {
-                    hpgl_state.numpad[0] = 0.0f;
+                    record->param[0] = 0.0f;
                     numpad_idx = 1;
                 }
                 if(numpad_idx == 1) {
-                    hpgl_state.charset_std = hpgl_state.numpad[0] == 0.0f ? &charset0[0] : &charset173[0];
+                    hpgl_state.charset_std = record->param[0] == 0.0f ? &charset0[0] : &charset173[0];
                     if(!hpgl_state.use_alt_charset)
                         hpgl_state.charset = hpgl_state.charset_std;
                 } else {
@@ -336,21 +341,21 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 cmd = command;
                 break;
 
-            case CMD_DI: // DI: Absolute text direction // numpad contains sin(theta), cos(theta)
+            case CMD_DI: // DI: Absolute text direction // param contains sin(theta), cos(theta)
                 if(numpad_idx == 0) {
-                    hpgl_state.numpad[0] = 1.0f;
-                    hpgl_state.numpad[1] = 0.0f;
+                    record->param[0] = 1.0f;
+                    record->param[1] = 0.0f;
                     numpad_idx = 2;
                 }
                 if(numpad_idx >= 2) {
-                // fabs(hpgl_state.numpad[0] + hpgl_state.numpad[1]) > 0.0004f
+                // fabs(record->param[0] + record->param[1]) > 0.0004f
                 }
                 cmd = command;
                 break;
 
             case CMD_DV: // DV: Vertical label direction
                 if(numpad_idx == 1) {
-                    hpgl_state.text_vertical = truncf(hpgl_state.numpad[0]) != 0.0f;
+                    hpgl_state.text_vertical = truncf(record->param[0]) != 0.0f;
                 } else {
                     cmd = CMD_ERR;
                     hpgl_set_error(ERR_WrongParams);
@@ -358,13 +363,14 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 break;
 
             case CMD_EA: // EA: Edge Absolute
+            case CMD_RA: // RA: Fill Rectangle Absolute
                 if(numpad_idx < 2) {
                     cmd = CMD_ERR;
                     hpgl_set_error(ERR_WrongParams);
                 } else {
                     user_point_t f;
-                    f.x = hpgl_state.numpad[0];
-                    f.y = hpgl_state.numpad[1];
+                    f.x = record->param[0];
+                    f.y = record->param[1];
                     userscale(f, target, NULL);
                     if(numpad_idx > 2)
                         hpgl_set_error(ERR_WrongParams);
@@ -373,13 +379,14 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 break;
 
             case CMD_ER: // ER: Edge Relative
+            case CMD_RR: // RR: Fill Rectangle Relative
                 if(numpad_idx < 2) {
                     cmd = CMD_ERR;
                     hpgl_set_error(ERR_WrongParams);
                 } else {
                     user_point_t f;
-                    f.x = hpgl_state.user_loc.x + hpgl_state.numpad[0];
-                    f.y = hpgl_state.user_loc.y + hpgl_state.numpad[1];
+                    f.x = hpgl_state.user_loc.x + record->param[0];
+                    f.y = hpgl_state.user_loc.y + record->param[1];
                     userscale(f, target, NULL);
                     if(numpad_idx > 2)
                         hpgl_set_error(ERR_WrongParams);
@@ -389,8 +396,8 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
             case CMD_ES: // ES: Extra Space
                 if(numpad_idx == 0) {
-                    hpgl_state.numpad[0] = 0.0f;
-                    hpgl_state.numpad[1] = 0.0f;
+                    record->param[0] = 0.0f;
+                    record->param[1] = 0.0f;
                     numpad_idx = 2;
                 } else {
 // TODO:
@@ -400,20 +407,26 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 }
                 break;
 
+            case CMD_EP: // EP: Edge Polygon
+            case CMD_FP: // FP: Fill Polygon, even-odd fill rule only
+                cmd = command;
+                break;
+
             case CMD_EW: // EW: Edge Wedge
+            case CMD_WG: // WG: Fill Wedge
                 if(numpad_idx > 0) {
                     if(numpad_idx < 3) {
                         cmd = CMD_ERR;
                         hpgl_set_error(ERR_WrongParams);
                     } else {
                         if (numpad_idx == 3)
-                            hpgl_state.numpad[3] = hpgl_state.chord_angle;
+                            record->param[3] = hpgl_state.chord_angle;
 /*                        user_point_t f, offset = { 0.0f, 0.0f };
-                        f.x = hpgl_state.numpad[0];
-                        f.y = hpgl_state.numpad[1];
+                        f.x = record->param[0];
+                        f.y = record->param[1];
                         userscalerelative(f, target, &offset);
-                        hpgl_state.numpad[0] = hpgl_state.user_loc.x + offset.x;
-                        hpgl_state.numpad[1] = hpgl_state.user_loc.y + offset.y;
+                        record->param[0] = hpgl_state.user_loc.x + offset.x;
+                        record->param[1] = hpgl_state.user_loc.y + offset.y;
                         target->x = target->y = -1; */
                         cmd = command;
                     }
@@ -421,8 +434,8 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 break;
 
               case CMD_IM: // IM: Input Mask
-                if(numpad_idx > 0 && hpgl_state.numpad[0] < 256.0f) {
-                    hpgl_state.alertmask = truncf(hpgl_state.numpad[0]);
+                if(numpad_idx > 0 && record->param[0] < 256.0f) {
+                    hpgl_state.alertmask = truncf(record->param[0]);
                     alert_led(!!(hpgl_state.errmask & hpgl_state.alertmask));
                 }
                 break;
@@ -440,7 +453,7 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                     uint_fast8_t i = numpad_idx;
                     do {
                         i--;
-                        valid = hpgl_state.numpad[i] >= 0.0f && (int32_t)truncf(hpgl_state.numpad[i]) <= (i & 0b1 ? MAX_Y : MAX_X);
+                        valid = record->param[i] >= 0.0f && (int32_t)truncf(record->param[i]) <= (i & 0b1 ? hpgl_settings.max_y : hpgl_settings.max_x);
                     } while(i && valid);
 
                     if(valid) {
@@ -448,7 +461,7 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                         user_point_t ip = range_P1P2();
 
                         for (i = 0; i < numpad_idx; i++)
-                            hpgl_state.ip_pad[i] = (int32_t)truncf(hpgl_state.numpad[i]);
+                            hpgl_state.ip_pad[i] = (int32_t)truncf(record->param[i]);
 
                         if(numpad_idx == 2) {
                             hpgl_state.ip_pad[2] = hpgl_state.ip_pad[0] + ip.x; // clip!
@@ -456,9 +469,25 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                         }
                     }
                 }
+                dash_configure();
                 cmd = command;
                 break;
 
+            case CMD_IW: // IW: Input Window
+                if(numpad_idx == 0) {
+                    hpgl_state.iw_pad[0] = hpgl_state.iw_pad[1] = 0;
+                    hpgl_state.iw_pad[2] = hpgl_settings.max_x;
+                    hpgl_state.iw_pad[3] = hpgl_settings.max_y;
+                } else if(numpad_idx == 4) {
+                    for (uint_fast8_t i = 0; i < 4; i++)
+                        hpgl_state.iw_pad[i] = (int32_t)truncf(record->param[i]);
+                }
+                if((cmd = numpad_idx == 0 || numpad_idx == 4 ? command : CMD_ERR) == CMD_ERR)
+                    hpgl_set_error(ERR_WrongParams);
+                else
+                    clip_set_window();
+                break;
+
             case CMD_LB: // LB: Label character
                 // scanning text
                 cmd = CMD_LB;
@@ -474,16 +503,16 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
             case CMD_LT: // LT: Line Type
                 if(numpad_idx == 0) {
-                    hpgl_state.pattern_type = 0;
+                    hpgl_state.pattern_type = LINETYPE_SOLID;
                     hpgl_state.pattern_length = 4.0f;
                     cmd = command;
-                } else if((cmd = fabsf(hpgl_state.numpad[0]) >= 128.0f ? CMD_ERR : command) == command) {
-                    hpgl_state.numpad[0] = truncf(hpgl_state.numpad[0]);
-                    if(hpgl_state.numpad[0] <= 6.0f)
-                        hpgl_state.pattern_type = hpgl_state.numpad[0] <= 0.0f ? 0 : (uint8_t)hpgl_state.numpad[0];
+                } else if((cmd = fabsf(record->param[0]) >= 128.0f ? CMD_ERR : command) == command) {
+                    record->param[0] = truncf(record->param[0]);
+                    if(record->param[0] <= 6.0f)
+                        hpgl_state.pattern_type = record->param[0] <= 0.0f ? 0 : (uint8_t)record->param[0];
                     if(numpad_idx > 1) {
-                       if(hpgl_state.numpad[1] >= 0.0f && hpgl_state.numpad[1] < 128.0f)
-                           hpgl_state.pattern_length = hpgl_state.numpad[1];
+                       if(record->param[1] >= 0.0f && record->param[1] < 128.0f)
+                           hpgl_state.pattern_length = record->param[1];
                        else
                            cmd = CMD_ERR;
                     } else
@@ -491,6 +520,7 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 }
                 if(cmd == CMD_ERR)
                     hpgl_set_error(ERR_BadParam);
+                dash_configure();
                 break;
 
             case CMD_OA: // OA: Output Actual Position and Pen Status
@@ -525,7 +555,7 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 break;
 
             case CMD_OO: // OO: Output Options
-                hal.stream.write("0,0,0,0,1,0,0,0"); // TODO: set second parameter to 1 if pen change is supported
+                hal.stream.write(HPGL_PENS ? "0,1,0,0,1,0,0,0" : "0,0,0,0,1,0,0,0");
                 hal.stream.write(hpgl_state.term);
                 break;
 
@@ -541,13 +571,12 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 hpgl_state.flags.initialized = Off;
                 break;
 
+            case CMD_OH: // OH: Output Hard-clip Limits
+                output_hardclip();
+                break;
+
             case CMD_OW: // OW: Output Window
-            case CMD_OH: // OH: Output Hard-clip Limits TODO: implement clip
-                hal.stream.write("0,0,");
-                hal.stream.write(uitoa(MAX_X));
-                hal.stream.write(",");
-                hal.stream.write(uitoa(MAX_Y));
-                hal.stream.write(hpgl_state.term);
+                output_window();
                 break;
 
             case CMD_PA:
@@ -562,8 +591,8 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                     case 2:
                         {
                             user_point_t f;
-                            f.x = hpgl_state.numpad[0];
-                            f.y = hpgl_state.numpad[1];
+                            f.x = record->param[0];
+                            f.y = record->param[1];
                             if(hpgl_state.plot_relative)
                                 userscalerelative(f, target, &hpgl_state.user_loc);
                             else
@@ -579,17 +608,27 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                 }
                 break;
 
+            case CMD_PM: // PM: Polygon Mode
+                if(numpad_idx == 0)
+                    record->param[0] = 0.0f;
+                if(record->param[0] < 0.0f || record->param[0] > 2.0f) {
+                    cmd = CMD_ERR;
+                    hpgl_set_error(ERR_BadParam);
+                } else
+                    cmd = command;
+                break;
+
             case CMD_PT: // PT: pen thickness
                 cmd = command;
                 if(numpad_idx == 0)
                     hpgl_state.pen_thickness = 0.3f;
                 else {
  
-                    if(hpgl_state.numpad[0] < 0.1f || hpgl_state.numpad[0] > 5.0f) {
+                    if(record->param[0] < 0.1f || record->param[0] > 5.0f) {
                         cmd = CMD_ERR;
                         hpgl_set_error(ERR_BadParam);
                     } else
-                        hpgl_state.pen_thickness = hpgl_state.numpad[0];
+                        hpgl_state.pen_thickness = record->param[0];
  
                     if(cmd != CMD_ERR && numpad_idx > 1) {
                         cmd = CMD_ERR;
@@ -608,7 +647,7 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
                     translate_init_sc();
                 else if(numpad_idx == 4) {
                     for (uint_fast8_t i = 0; i < 4; i++)
-                        hpgl_state.sc_pad[i] = (int32_t)truncf(hpgl_state.numpad[i]);
+                        hpgl_state.sc_pad[i] = (int32_t)truncf(record->param[i]);
                     translate_scale();
                 }
                 cmd = numpad_idx == 0 || numpad_idx == 4 ? command : CMD_ERR;
@@ -616,15 +655,15 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
             case CMD_SI: // SI: Absolute character size
                 if(numpad_idx == 0) {
-                    hpgl_state.numpad[0] = 0.187f;
-                    hpgl_state.numpad[1] = 0.269f;
+                    record->param[0] = 0.187f;
+                    record->param[1] = 0.269f;
                     numpad_idx = 2;
                 }
                 if((cmd = (numpad_idx == 1 ? CMD_ERR : command)) == CMD_ERR)
                     hpgl_set_error(ERR_WrongParams);
                 else {
-                    hpgl_state.character_size.width = hpgl_state.numpad[0];
-                    hpgl_state.character_size.height = hpgl_state.numpad[1];
+                    hpgl_state.character_size.width = record->param[0];
+                    hpgl_state.character_size.height = record->param[1];
                     if(numpad_idx > 2)
                         hpgl_set_error(ERR_WrongParams);
                 }
@@ -632,23 +671,23 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
             case CMD_SP: // SP: Select Pen
                 if(numpad_idx == 0)
-                    hpgl_state.numpad[0] = 0.0f;
+                    record->param[0] = 0.0f;
                 hpgl_state.pen_thickness = 0.3; // only if pen changed...
                 cmd = command;
                 break;
 
             case CMD_SR: // SR: Relative character size
                 if(numpad_idx == 0) {
-                    hpgl_state.numpad[0] = 0.75f;
-                    hpgl_state.numpad[1] = 1.5f;
+                    record->param[0] = 0.75f;
+                    record->param[1] = 1.5f;
                     numpad_idx = 2;
                 }
                 if((cmd = (numpad_idx == 1 ? CMD_ERR : command)) == CMD_ERR)
                     hpgl_set_error(ERR_WrongParams);
                 else {
                     user_point_t range = range_P1P2();
-                    hpgl_state.character_size.width = range.x * hpgl_state.numpad[0] / 100.0f;
-                    hpgl_state.character_size.height = range.y * hpgl_state.numpad[1] / 100.0f;
+                    hpgl_state.character_size.width = range.x * record->param[0] / 100.0f;
+                    hpgl_state.character_size.height = range.y * record->param[1] / 100.0f;
                     if(numpad_idx > 2)
                         hpgl_set_error(ERR_WrongParams);
                 }
@@ -676,3 +715,36 @@ hpgl_command_t hpgl_char_inp (char c, hpgl_point_t *target, uint8_t *lb)
 
     return cmd;
 }
+
+static const hpgl_command_record_t *hpgl_char_inp (char c)
+{
+    uint8_t lb;
+    hpgl_command_record_t *parsed = record;
+
+    parsed->cmd = parse_char(c, &parsed->target, &lb);
+
+    if(parsed->cmd == CMD_LB) {
+        // Collect label characters, the span is passed on when the terminator is received or it is full.
+        if(lb)
+            parsed->label[parsed->label_length++] = lb;
+        if(parsed->label_length < HPGL_LABEL_SPAN - 1)
+            return NULL;
+    } else if(parsed->cmd == CMD_CONT) {
+        if(parsed->label_length == 0)
+            return NULL;
+        parsed->cmd = CMD_LB;
+    }
+
+    if(parsed->label_length) {
+        parsed->label[parsed->label_length] = '\0';
+        if(hpgl_state.comm.monitor_on)
+            hal.stream.write(parsed->label);
+    }
+
+    // Hand the record over to the executor and continue parsing into the next one.
+    record = &records[record_idx = (record_idx + 1) & (HPGL_COMMAND_RECORDS - 1)];
+    memset(record->param, 0, sizeof(record->param));
+    record->label_length = 0;
+
+    return parsed;
+}
@@ -10,7 +10,12 @@
 #define HPGL_DEVICE_IDENTIFICATION "HP7574A"
 #endif
 
+#ifndef HPGL_PENS
+#define HPGL_PENS 0 // Number of pens in carousel, pens are changed by M6 tool changes. 0 to disable.
+#endif
+
 #define SCRATCHPAD_SIZE 64
+#define LINETYPE_SOLID 255
 
 #define MAX_X_A4    11040
 #define MAX_Y_A4    7721
@@ -50,7 +55,7 @@ typedef enum {
     ERR_Unused1,
     ERR_UnknownCharset,
     ERR_PosOverflow,
-    ERR_Unused2,
+    ERR_BufferOverflow,
     Err_WheelsUp
 } hpgl_error_t;
 
@@ -68,17 +73,20 @@ typedef enum {
     CMD_CI = 'C' << 8 | 'I',    ///< CI: Circle
     CMD_CP = 'C' << 8 | 'P',    ///< CP: Character plot
     CMD_CS = 'C' << 8 | 'S',    ///< CS: Designate standard character set
-    CMD_DI = 'D' << 8 | 'I',    ///< DI: Label direction: numpad[0]=sin(theta), numpad[1]=cos(theta)
+    CMD_DI = 'D' << 8 | 'I',    ///< DI: Label direction: param[0]=sin(theta), param[1]=cos(theta)
     CMD_DF = 'D' << 8 | 'F',    ///< DF: Set default values
     CMD_DT = 'D' << 8 | 'T',    ///< DT: Set text terminator
     CMD_DV = 'D' << 8 | 'V',    ///< DV: Vertical label direction
     CMD_EA = 'E' << 8 | 'A',    ///< EA: Rectangle absolute
+    CMD_EP = 'E' << 8 | 'P',    ///< EP: Edge polygon
     CMD_ER = 'E' << 8 | 'R',    ///< EV: Rectangle relative
     CMD_ES = 'E' << 8 | 'S',    ///< ES: Extra Space
     CMD_EW = 'E' << 8 | 'W',    ///< EW: Edge Wedge
+    CMD_FP = 'F' << 8 | 'P',    ///< FP: Fill polygon
     CMD_IN = 'I' << 8 | 'N',    ///< IN: Initialize
     CMD_IM = 'I' << 8 | 'M',    ///< IM: Input Mask
     CMD_IP = 'I' << 8 | 'P',    ///< IP: Initialize plotter
+    CMD_IW = 'I' << 8 | 'W',    ///< IW: Input Window
     CMD_LB = 'L' << 8 | 'B',    ///< LB: Label text
     CMD_LT = 'L' << 8 | 'T',    ///< LT: Line type
 
@@ -98,9 +106,12 @@ typedef enum {
  
     CMD_PA = 'P' << 8 | 'A',    ///< PA: Move to returned coordinates
     CMD_PD = 'P' << 8 | 'D',    ///< PD: Pen down
+    CMD_PM = 'P' << 8 | 'M',    ///< PM: Polygon mode
     CMD_PR = 'P' << 8 | 'R',    ///< PR: Nove to relative position
     CMD_PT = 'P' << 8 | 'T',    ///< PT: Pen thickness
     CMD_PU = 'P' << 8 | 'U',    ///< PU: Pen up
+    CMD_RA = 'R' << 8 | 'A',    ///< RA: Fill rectangle absolute
+    CMD_RR = 'R' << 8 | 'R',    ///< RR: Fill rectangle relative
     CMD_SA = 'S' << 8 | 'A',    ///< SA: Select alternate character set
     CMD_SC = 'S' << 8 | 'C',    ///< SC: Scale
     CMD_SI = 'S' << 8 | 'I',    ///< SI: Absolute character size
@@ -108,6 +119,7 @@ typedef enum {
     CMD_SR = 'S' << 8 | 'R',    ///< SR: Relative character size
     CMD_SS = 'S' << 8 | 'S',    ///< SS: Select standard character set
     CMD_VS = 'V' << 8 | 'S',    ///< VS: Velocity Select: 0 = fastest (nonstandard)
+    CMD_WG = 'W' << 8 | 'G',    ///< WG: Fill wedge
     CMD_SEEK0 = 'H' << 8 | 'S'  ///< Locate home position
 } hpgl_command_t;
 
@@ -141,6 +153,25 @@ typedef struct {
     float height;
 } char_size_t;
 
+#ifndef HPGL_COMMAND_RECORDS
+#define HPGL_COMMAND_RECORDS 2 // must be a power of 2
+#endif
+
+#ifndef HPGL_LABEL_SPAN
+#define HPGL_LABEL_SPAN 32 // max. number of label characters passed to the executor in one record
+#endif
+
+/// Parsed command as returned by hpgl_char().
+/// The parser fills the next record in a ring, so a returned record stays valid
+/// until HPGL_COMMAND_RECORDS - 1 further commands have been parsed.
+typedef struct {
+    hpgl_command_t cmd;
+    hpgl_point_t target;    ///< destination, -1 if no data
+    float param[4];
+    uint8_t label_length;   ///< number of characters in label span (see CMD_LB)
+    char label[HPGL_LABEL_SPAN];  ///< label span, null terminated
+} hpgl_command_record_t;
+
 typedef union {
     uint8_t value;
     struct {
@@ -173,7 +204,7 @@ typedef struct {
     bool plot_relative;
     uint8_t etxchar;
     char term[3];
-    uint8_t pattern_type;
+    uint8_t pattern_type;       ///< LT pattern 0 - 6 or LINETYPE_SOLID
     float pattern_length;
     bool use_alt_charset;
     bool text_vertical;
@@ -186,7 +217,7 @@ typedef struct {
     hpgl_error_t last_error;
     uint8_t errmask;
     uint8_t alertmask;
-    float numpad[4];
+    int32_t iw_pad[4];
     // The following values are not changed on a reset to default values, ip_pad must be first!
     int32_t ip_pad[4];
     int32_t sc_pad[4];
@@ -197,18 +228,17 @@ typedef struct {
 } hpgl_state_t;
 
 extern hpgl_state_t hpgl_state;
-typedef hpgl_command_t (*hpgl_char_ptr)(char c, hpgl_point_t *target, uint8_t *lb);
+typedef const hpgl_command_record_t *(*hpgl_char_ptr)(char c);
 
 /// Initialize the scanner.
 void hpgl_init();
 
-/// Handle next character from the input. When action is determined, return one of the _hpgl_command values.
-/// Pass target coordinates in x and y.
+/// Handle next character from the input. When action is determined, return a record with the command,
+/// target coordinates, label span and parameters. Label characters are collected up to the label terminator
+/// or until the span is full.
 /// @param c    input char
-/// @param x    output: destination x (returns -1 if no data)
-/// @param y    output: destination y (returns -1 if no data)
-/// @param lb   output: next label character (see CMD_LB)
-/// @returns    _hpgl_command
+/// @returns    pointer to command record, NULL if no action
+/// @see hpgl_command_record_t
 extern hpgl_char_ptr hpgl_char;
 
 hpgl_error_t hpgl_get_error (void);
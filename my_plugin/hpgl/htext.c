@@ -4,11 +4,27 @@
 #include "hpgl.h"
 #include "scale.h"
 #include "htext.h"
+#include "stats.h"
 
 #ifdef HPGL_DEBUG
 #include "../grbl/hal.h"
 #endif
 
+#ifndef HPGL_GLYPH_CACHE_SIZE
+#define HPGL_GLYPH_CACHE_SIZE 8 // Set to 0 to disable the glyph cache
+#endif
+
+#define GLYPH_MAX_VERTICES 18   // Longest glyph in the charsets (17) + advance
+
+/// Cached glyph, vertices are stored scaled and rotated relative to the character origin.
+/// The last vertex is the (pen up) advance to the next character origin.
+typedef struct {
+    const char *glyph;
+    uint8_t n_vertices;
+    uint32_t pen_down;          ///< Bitmask, bit set if draw to vertex
+    user_point_t vertex[GLYPH_MAX_VERTICES];
+} glyph_cache_t;
+
 user_point_t fontscale;
 user_point_t charorigin;
 user_point_t labelorigin;
@@ -16,6 +32,78 @@ user_point_t labelorigin;
 user_coord_t sintheta, costheta;
 
 static const char *coffs;
+static uint_fast8_t glyph_vertex;
+static const glyph_cache_t *glyph = NULL;
+
+#if HPGL_GLYPH_CACHE_SIZE
+
+static uint_fast8_t glyph_next = 0;
+static glyph_cache_t glyph_cache[HPGL_GLYPH_CACHE_SIZE] = {0};
+
+// Invalidate all entries, called when scale or direction changes.
+static void glyph_cache_flush (void)
+{
+    uint_fast8_t idx = HPGL_GLYPH_CACHE_SIZE;
+
+    do {
+        glyph_cache[--idx].glyph = NULL;
+    } while(idx);
+
+    glyph = NULL;
+}
+
+static inline void glyph_transform (user_point_t *v, float x, float y)
+{
+    v->x = x * costheta + y * sintheta;
+    v->y = -x * sintheta + y * costheta;
+}
+
+// Returns cached glyph, decodes, scales and rotates it into the cache on a miss.
+static const glyph_cache_t *glyph_get (const char *data)
+{
+    uint8_t encoded;
+    uint_fast8_t idx = HPGL_GLYPH_CACHE_SIZE;
+    glyph_cache_t *entry;
+    const char *strokes = data;
+
+    do {
+        if(glyph_cache[--idx].glyph == data)
+            return &glyph_cache[idx];
+    } while(idx);
+
+    entry = &glyph_cache[glyph_next];
+    glyph_next = (glyph_next + 1) % HPGL_GLYPH_CACHE_SIZE;
+
+    entry->glyph = NULL;
+    entry->pen_down = 0;
+    entry->n_vertices = 0;
+
+    while((encoded = (uint8_t)*strokes++)) {
+        if(entry->n_vertices == GLYPH_MAX_VERTICES - 1)
+            return NULL; // Too long, fall back to uncached rendering.
+        if(encoded & 0b10000000)
+            entry->pen_down |= (1 << entry->n_vertices);
+        glyph_transform(&entry->vertex[entry->n_vertices++], fontscale.x * ((encoded >> 4) & 0b111), fontscale.y * ((encoded & 0b1111) - 4));
+    }
+
+    glyph_transform(&entry->vertex[entry->n_vertices++], fontscale.x * 5.0f, 0.0f);
+    entry->glyph = data;
+
+    return entry;
+}
+
+#else
+
+static inline void glyph_cache_flush (void)
+{
+}
+
+static inline const glyph_cache_t *glyph_get (const char *data)
+{
+    return NULL;
+}
+
+#endif // HPGL_GLYPH_CACHE_SIZE
 
 void text_init (void)
 {
@@ -31,6 +119,8 @@ void text_setscale (float sx, float sy)
     fontscale.x = sx;
     fontscale.y = sy;
 
+    glyph_cache_flush();
+
     printf_P(PSTR("Text scale is (%f, %f)\n"), fontscale.x, fontscale.y);
 }
 
@@ -58,7 +148,9 @@ void text_direction (float cost, float sint)
 {
     sintheta = -sint;
     costheta = cost;
-    
+
+    glyph_cache_flush();
+
     printf_P(PSTR("Label rotation: sin=%f cos=%f\n"), sintheta, costheta);
 }
 
@@ -115,6 +207,7 @@ bool text_char (uint8_t c, hpgl_point_t *target, pen_status_t *pen)
 
         encoded = 1;
         *pen = Pen_Up;
+        glyph = NULL;
 
         switch (c) {
             case '\r':
@@ -139,13 +232,26 @@ bool text_char (uint8_t c, hpgl_point_t *target, pen_status_t *pen)
                 noadvance = true;
                 break;
             default:
-                coffs = hpgl_state.charset[c];
+                coffs = hpgl_state.charset[c] ? hpgl_state.charset[c] : hpgl_state.charset[0];
                 charorigin = hpgl_state.user_loc;
                 noadvance = false;
+                glyph = glyph_get(coffs);
+                glyph_vertex = 0;
+                hpgl_stats.glyphs++;
                 //printf_P(PSTR("coffs=%x first=%o"), charset0[c], *charset0[c]);
                 break;
         } 
 
+    } else if(glyph) {
+
+        // Cache hit, only translation to the character origin needed.
+        *pen = glyph->pen_down & (1 << glyph_vertex) ? Pen_Down : Pen_Up;
+        d.x = charorigin.x + glyph->vertex[glyph_vertex].x;
+        d.y = charorigin.y + glyph->vertex[glyph_vertex].y;
+        userscale(d, target, &hpgl_state.user_loc);
+
+        encoded = ++glyph_vertex < glyph->n_vertices;
+
     } else {
 
         encoded = *coffs++;
@@ -47,19 +47,33 @@
 #include <string.h>
 
 #include "arc.h"
+#include "clip.h"
+#include "dash.h"
+#include "fill.h"
+#include "gcode.h"
+#include "stats.h"
+#include "config.h"
 #include "htext.h"
 #include "scale.h"
 #include "hpgl.h"
 #include "motori.h"
 
+#include "grbl/gcode.h"
+#include "grbl/ioports.h"
 #include "grbl/protocol.h"
 #include "grbl/motion_control.h"
+#include "grbl/planner.h"
+#include "grbl/report.h"
 #include "grbl/state_machine.h"
 #include "grbl/task.h"
 
 #define VERSION "0.11"
 #define DC_VALUES_MAX 12
 
+#ifndef HPGL_FLOW_ADAPTIVE
+#define HPGL_FLOW_ADAPTIVE 1 // set to 0 to use the XON/XOFF thresholds set by ESC.H/ESC.I and ESC.R as given
+#endif
+
 typedef enum {
     IOError_None = 0,
     IOError_DCI_Overlap = 10,
@@ -76,14 +90,35 @@ static char pollc = 0;
 static float feed_rate = 1000; // mm/min
 static volatile uint16_t rx_count;
 static volatile bool xoff = false;
+static struct {
+    volatile uint32_t rx_bytes;         ///< Characters received
+    uint32_t parsed_bytes;              ///< Characters parsed
+    uint32_t xoff_count;                ///< XOFF responses sent
+    uint32_t ack_deferred;              ///< ENQ/ACK acknowledges deferred due to lack of buffer space
+    volatile uint_fast16_t skid;        ///< Characters received after the last XOFF
+    uint_fast16_t skid_max;             ///< Max characters received after XOFF, measures host stop latency
+    volatile int_fast16_t countdown;    ///< Characters that can be received before the high watermark can be crossed
+    uint_fast16_t high_watermark;       ///< Send XOFF when free buffer space drops below this
+    uint_fast16_t low_watermark;        ///< Send XON when buffered characters drops to or below this
+    volatile bool await_resume;         ///< XON sent, waiting for the first character from the host
+    uint32_t xon_ms;                    ///< Time when the XON was sent
+    uint32_t xoff_ms;                   ///< Time when the XOFF was sent
+    uint32_t xoff_parsed;               ///< parsed_bytes when the XOFF was sent
+    uint_fast16_t latency_ms;           ///< Measured time from XON to host resuming transmission
+    uint32_t drain_rate;                ///< Measured parser throughput in characters/s when backlogged
+} flow = {0};
 static uint32_t last_action = 0;
 static volatile pen_status_t pen_status = Pen_Unknown;          ///< pen status: 0 = up
+static uint_fast16_t current_pen = 0;
+static pen_status_t polygon_pen = Pen_Up;                       ///< pen status when polygon mode was entered
+static bool pen_raised = false;                                 ///< pen is up in a line pattern gap while pen status is down
 static io_stream_t stream;
 static enqueue_realtime_command_ptr enqueue_realtime_command, base_handler;
 static on_execute_realtime_ptr on_execute_realtime, process;
 static on_report_options_ptr on_report_options;
 static on_state_change_ptr on_state_change;
 static coord_data_t target = {0}, origin = {0};
+static hpgl_point_t commanded = {0}, actual = {0}; ///< Unclipped and clipped (physical) pen position
 static struct {
     uint_fast8_t i;
     uint_fast8_t j;
@@ -111,19 +146,14 @@ static struct {
 #define SEEK0_DONE  0x80
 
 static void go_home (void);
+static void flow_reset (void);
 static ISR_CODE bool ISR_FUNC(stream_insert_buffer)(char c);
 static ISR_CODE bool ISR_FUNC(stream_insert_buffer_xoff)(char c);
 static ISR_CODE bool ISR_FUNC(stream_insert_buffer_enq)(char c);
 
 bool moveto (hpgl_coord_t x, hpgl_coord_t y);
+static bool plan_motion (hpgl_point_t point, bool travel);
 
-__attribute__((weak)) void select_pen (uint_fast16_t pen)
-{
-    if(pen == 0) {
-        hpgl_state.user_loc.x = hpgl_state.user_loc.y = 0.0f;
-        moveto(0, 0);
-    }
-}
 
 __attribute__((weak)) void pen_led (bool on)
 {
@@ -154,6 +184,10 @@ void grinding_halt() {
 
 void plotter_init()
 {
+    commanded.x = commanded.y = actual.x = actual.y = 0;
+
+    feed_rate = hpgl_settings.feed_rate_down;
+
     hpgl_init();
     text_init();
     pen_control(Pen_Up);
@@ -171,78 +205,596 @@ pen_status_t get_pen_status (void)
     return pen_status;
 }
 
-void pen_control (pen_status_t state)
-{
-    static const spindle_state_t on = { .on = true },  off = { .on = false };
+// Planner output, default
+//
+// Moves and pen changes are queued in order and fed to the planner from the foreground process.
+// When the pen is driven by the spindle a pen change waits for motion to complete, actuates the pen
+// and then waits for the settle time without blocking the foreground process. The HPGL parser may
+// run ahead while this happens so that the planner buffer can be refilled immediately after the pen
+// has settled, but the planner is drained on every pen change.
+//
+// When the pen is driven by an aux port (HPGL_PEN_PORT) the pen change is attached to the next move
+// as a synchronized output command, set by the stepper when the block starts executing. A short
+// lead-in block at the start of the move is fed so that it takes the pen delays, the planner is not drained.
 
-    if (pen_status != state) {
+#ifndef HPGL_EVENT_QUEUE_SIZE
+#define HPGL_EVENT_QUEUE_SIZE 32 // must be a power of 2
+#endif
 
-        if (state != Pen_Timeout) {
-            protocol_buffer_synchronize();
-            sync_position();
-        }
+#ifndef HPGL_PEN_OUTPUTS
+#define HPGL_PEN_OUTPUTS 16 // pen changes that can be queued in the planner
+#endif
+
+#ifndef HPGL_PEN_LEAD_IN
+#define HPGL_PEN_LEAD_IN 0.1f // mm, long enough to generate steps so that the output is executed
+#endif
+
+typedef enum {
+    PenPhase_Idle = 0,
+    PenPhase_AwaitMotion,
+    PenPhase_PreDelay,
+    PenPhase_Settle
+} pen_phase_t;
+
+typedef struct {
+    float x;
+    float y;
+    float feed_rate;
+    bool rapid;
+    pen_status_t pen;   ///< Pen_NoAction for moves
+} motion_event_t;
 
-        if (state == Pen_Down) {
-            DELAY_MS(PEN_DOWN_DELAY);
+static struct {
+    volatile uint_fast8_t head;
+    volatile uint_fast8_t tail;
+    bool pumping;
+    pen_phase_t phase;
+    uint32_t timeout;
+    motion_event_t event[HPGL_EVENT_QUEUE_SIZE];
+} events = {0};
+
+static struct {
+    uint8_t port;                               ///< aux port, 0xFF if the pen is driven by the spindle
+    uint_fast8_t next;                          ///< next output command to use
+    pen_status_t pending;                       ///< pen change to attach to the next move
+    output_command_t cmd[HPGL_PEN_OUTPUTS];
+} pen_output = { .port = 0xFF, .pending = Pen_NoAction };
+
+static void pen_actuate (pen_status_t state)
+{
+    static const spindle_state_t on = { .on = true },  off = { .on = false };
+
+    if(pen_output.port != 0xFF)
+        hal.port.digital_out(pen_output.port, state == Pen_Down);
+    else if (state == Pen_Down) {
 #if GRBL_BUILD >= 20231120
-            spindle_get(0)->set_state(spindle_get(0), on, 1000.0f);
+        spindle_get(0)->set_state(spindle_get(0), on, 1000.0f);
 #elif GRBL_BUILD >= 20230201
-            spindle_get(0)->set_state(on, 1000.0f);
+        spindle_get(0)->set_state(on, 1000.0f);
 #else
-            hal.spindle.set_state(on, 1000.0f);
+        hal.spindle.set_state(on, 1000.0f);
 #endif
-            pen_status = Pen_Down;
-            last_action = hal.get_elapsed_ticks();
-        } else {
+    } else {
 #if GRBL_BUILD >= 20231120
-            spindle_get(0)->set_state(spindle_get(0), off, 0.0f);
+        spindle_get(0)->set_state(spindle_get(0), off, 0.0f);
 #elif GRBL_BUILD >= 20230201
-            spindle_get(0)->set_state(off, 0.0f);
+        spindle_get(0)->set_state(off, 0.0f);
 #else
-            hal.spindle.set_state(off, 0.0f);
+        hal.spindle.set_state(off, 0.0f);
 #endif
-            pen_status = Pen_Up;
-        }
+    }
+}
 
-        pen_led(pen_status == Pen_Down);
+static inline bool events_empty (void)
+{
+    return events.head == events.tail;
+}
 
-        if (state != Pen_Timeout)
-            DELAY_MS(PEN_LIFT_DELAY);
-    }
+static void pen_outputs_reset (void)
+{
+    uint_fast8_t idx = HPGL_PEN_OUTPUTS;
+
+    do {
+        pen_output.cmd[--idx].is_executed = true;
+    } while(idx);
+
+    pen_output.next = 0;
+    pen_output.pending = Pen_NoAction;
 }
 
-static inline bool valid_target (hpgl_point_t target)
+// Queued output commands are discarded with the planner buffer.
+static void events_flush (void)
 {
-    return !(target.x < 0 || target.y < 0 || target.x > MAX_X || target.y > MAX_Y);
+    events.tail = events.head;
+    events.phase = PenPhase_Idle;
+    pen_outputs_reset();
 }
 
-bool moveto (hpgl_coord_t x, hpgl_coord_t y)
+// Returns false when a pen change is in progress and the queue has to wait.
+static bool pen_event (pen_status_t state)
 {
-    plan_line_data_t plan_data;
+    switch(events.phase) {
+
+        case PenPhase_Idle:
+            protocol_auto_cycle_start();
+            events.phase = PenPhase_AwaitMotion;
+            // no break
+
+        case PenPhase_AwaitMotion:
+            if(plan_get_current_block() || state_get() == STATE_CYCLE)
+                break;
+            sync_position();
+            if(state == Pen_Down) {
+                events.phase = PenPhase_PreDelay;
+                events.timeout = hal.get_elapsed_ticks() + hpgl_settings.pen_down_delay;
+                break;
+            }
+            // no break
+
+        case PenPhase_PreDelay:
+            if(events.phase == PenPhase_PreDelay && (int32_t)(hal.get_elapsed_ticks() - events.timeout) < 0)
+                break;
+            pen_actuate(state);
+            events.phase = PenPhase_Settle;
+            events.timeout = hal.get_elapsed_ticks() + hpgl_settings.pen_lift_delay;
+            break;
+
+        case PenPhase_Settle:
+            if((int32_t)(hal.get_elapsed_ticks() - events.timeout) >= 0)
+                events.phase = PenPhase_Idle;
+            break;
+    }
+
+    return events.phase == PenPhase_Idle;
+}
+
+// Attach the pending pen change to a move. If the pen delays are not zero the start of the move is
+// planned as a lead-in block fed so that it takes the delays, returns true if the lead-in was planned
+// as a separate block and the rest of the move remains.
+static bool pen_lead_in (motion_event_t *event, plan_line_data_t *plan_data)
+{
+    float dx = event->x - target.x, dy = event->y - target.y, length = hypotf(dx, dy), lead_in;
+    uint32_t delay = hpgl_settings.pen_lift_delay + (pen_output.pending == Pen_Down ? hpgl_settings.pen_down_delay : 0);
+    output_command_t *cmd = &pen_output.cmd[pen_output.next];
 
-    if(x < hpgl_state.ip_pad[0] || y < hpgl_state.ip_pad[1])
+    // A null move does not produce a block, the pen change waits for the next one.
+    if(length == 0.0f)
         return false;
 
-    if(x > hpgl_state.ip_pad[2] || y > hpgl_state.ip_pad[3])
-       return false;
+    cmd->is_digital = true;
+    cmd->is_executed = false;
+    cmd->port = pen_output.port;
+    cmd->value = pen_output.pending == Pen_Down ? 1 : 0;
+    cmd->next = NULL;
 
-    plan_data_init(&plan_data);
-    plan_data.feed_rate = feed_rate;
-    plan_data.condition.rapid_motion = get_pen_status() == Pen_Up;
+    pen_output.next = (pen_output.next + 1) % HPGL_PEN_OUTPUTS;
+    pen_output.pending = Pen_NoAction;
+
+    plan_data->output_commands = cmd;
+
+    if(delay == 0)
+        return false;
+
+    lead_in = min(length, HPGL_PEN_LEAD_IN);
+
+    plan_data->condition.rapid_motion = Off;
+    plan_data->feed_rate = lead_in * 60000.0f / (float)delay;
+
+    if(lead_in == length)
+        return false;
+
+    target.x += dx * lead_in / length;
+    target.y += dy * lead_in / length;
+
+    mc_line(target.values, plan_data);
+
+    return true;
+}
+
+// Feed queued events to the planner, called from the foreground process.
+static void events_pump (void)
+{
+    if(events.pumping)
+        return;
+
+    events.pumping = true;
+
+    while(!events_empty()) {
+
+        motion_event_t *event = &events.event[events.tail];
+
+        if(event->pen != Pen_NoAction) {
+            if(pen_output.port != 0xFF)
+                pen_output.pending = event->pen;
+            else if(!pen_event(event->pen))
+                break;
+        } else {
+
+            plan_line_data_t plan_data;
+
+            if(plan_check_full_buffer())
+                break;
+
+            plan_data_init(&plan_data);
+            plan_data.feed_rate = event->feed_rate;
+            plan_data.condition.rapid_motion = event->rapid;
+
+            if(pen_output.pending != Pen_NoAction) {
+                // All output commands are queued, wait for the stepper to execute the oldest.
+                if(!pen_output.cmd[pen_output.next].is_executed) {
+                    protocol_auto_cycle_start();
+                    break;
+                }
+                if(pen_lead_in(event, &plan_data))
+                    continue;
+            }
+
+            target.x = event->x;
+            target.y = event->y;
+
+            mc_line(target.values, &plan_data);
+        }
+
+        events.tail = (events.tail + 1) & (HPGL_EVENT_QUEUE_SIZE - 1);
+    }
+
+    events.pumping = false;
+}
+
+// Get next free event, waits for a free slot if the queue is full.
+static motion_event_t *events_next (void)
+{
+    uint_fast8_t next = (events.head + 1) & (HPGL_EVENT_QUEUE_SIZE - 1);
 
-    target.x = origin.x + (float)x * 0.025f;
-    target.y = origin.y + (float)y * 0.025f;
+    if(next == events.tail)
+        hpgl_stats.planner_stalls++;
+
+    while(next == events.tail) {
+        events_pump();
+        if(next == events.tail && !protocol_execute_realtime()) {
+            events_flush();
+            return NULL;
+        }
+    }
+
+    return &events.event[events.head];
+}
+
+static inline void events_commit (void)
+{
+    events.head = (events.head + 1) & (HPGL_EVENT_QUEUE_SIZE - 1);
+}
+
+static void planner_pen (pen_status_t state)
+{
+    motion_event_t *event;
+
+    if(state == Pen_Timeout) {
+        pen_output.pending = Pen_NoAction;
+        pen_actuate(Pen_Up);
+    } else if((event = events_next())) {
+        event->pen = state;
+        events_commit();
+    }
+}
+
+static bool planner_move (hpgl_point_t point, bool rapid, float feed_rate)
+{
+    motion_event_t *event;
 
 #ifdef HPGL_DEBUG
-    hal.stream.write(uitoa(x));
+    hal.stream.write(uitoa(point.x));
     hal.stream.write(",");
-    hal.stream.write(uitoa(y));
+    hal.stream.write(uitoa(point.y));
     hal.stream.write(ASCII_EOL);
 #endif
 
+    if((event = events_next())) {
+        event->x = origin.x + (float)point.x * hpgl_scale.mm_per_unit_x;
+        event->y = origin.y + (float)point.y * hpgl_scale.mm_per_unit_y;
+        event->feed_rate = feed_rate;
+        event->rapid = rapid;
+        event->pen = Pen_NoAction;
+        events_commit();
+    }
+
+    return event != NULL;
+}
+
+// Wait for all queued events and motions to complete.
+static void planner_sync (void)
+{
+    uint32_t us = hpgl_stats_us();
+
+    while(!events_empty()) {
+        events_pump();
+        if(!events_empty() && !protocol_execute_realtime()) {
+            events_flush();
+            break;
+        }
+    }
+
+    // A pen change not followed by a move is executed when motion has completed.
+    while(pen_output.pending != Pen_NoAction) {
+        if(pen_event(pen_output.pending))
+            pen_output.pending = Pen_NoAction;
+        else if(!protocol_execute_realtime()) {
+            events_flush();
+            break;
+        }
+    }
+
+    protocol_buffer_synchronize();
+    sync_position();
+
+    hpgl_stats.sync_count++;
+    hpgl_stats.sync_us += hpgl_stats_us() - us;
+}
+
+// Pen change by tool change, the tool change handler is executed with motion completed.
+// Returns false if the M6 block is rejected or the tool change is aborted.
+static bool planner_tool (uint_fast16_t pen)
+{
+    bool ok;
+    char block[12];
+
+    planner_sync();
+
+    strcpy(block, "M6T");
+    strcat(block, uitoa(pen));
+
+    // A manual tool change enters the tool change state from the realtime loop and
+    // completes when the operator resumes the cycle.
+    if((ok = gc_execute_block(block) == Status_OK && protocol_execute_realtime())) {
+        while(state_get() == STATE_TOOL_CHANGE) {
+            if(!(ok = protocol_execute_realtime()))
+                break;
+        }
+    }
+
+    if(ok)
+        planner_sync();
+
+    return ok;
+}
+
+static const hpgl_output_t planner_output = {
+    .live = true,
+    .move = planner_move,
+    .pen = planner_pen,
+    .tool = planner_tool,
+    .sync = planner_sync
+};
+
+static const hpgl_output_t *output = &planner_output;
+
+void hpgl_set_output (const hpgl_output_t *out)
+{
+    output = out ? out : &planner_output;
+    pen_status = Pen_Unknown; // force pen actuation on next pen_control() call
+    pen_raised = false;
+    current_pen = 0;
+}
+
+const hpgl_output_t *hpgl_get_output (void)
+{
+    return output;
+}
+
+void pen_control (pen_status_t state)
+{
+    if (pen_status != state) {
+
+        // In polygon mode pen changes are recorded in the polygon buffer only
+        if(polygon_mode()) {
+            pen_status = state == Pen_Down ? Pen_Down : Pen_Up;
+            return;
+        }
+
+        if(pen_status == Pen_Down && !pen_raised)
+            hpgl_stats.pen_lifts++;
+
+        if(state == Pen_Down && !clip_inside(commanded)) {
+            // Outside the window, the pen is lowered when a segment enters it.
+            pen_status = Pen_Down;
+            pen_raised = true;
+            pen_led(true);
+            return;
+        }
+
+        if(state == Pen_Down && (commanded.x != actual.x || commanded.y != actual.y))
+            plan_motion(commanded, true);
+
+        if(!(pen_raised && state != Pen_Down))
+            output->pen(state);
+
+        pen_raised = false;
+
+        if((pen_status = state == Pen_Down ? Pen_Down : Pen_Up) == Pen_Down) {
+            dash_restart();
+            last_action = hal.get_elapsed_ticks();
+        }
+
+        pen_led(pen_status == Pen_Down);
+    }
+}
+
+// Negative coordinates are used to flag no target, targets outside the window are clipped.
+static inline bool valid_target (hpgl_point_t target)
+{
+    return !(target.x < 0 || target.y < 0 || target.x > hpgl_settings.max_x || target.y > hpgl_settings.max_y);
+}
+
+#if HPGL_PENS
+
+__attribute__((weak)) void select_pen (uint_fast16_t pen)
+{
+    if(pen <= HPGL_PENS && pen != current_pen) {
+        pen_control(Pen_Up);
+        if(output->tool(pen)) {
+            current_pen = pen;
+            hpgl_stats.pen_changes++;
+        }
+    }
+}
+
+#else
+
+__attribute__((weak)) void select_pen (uint_fast16_t pen)
+{
+    if(pen == 0) {
+        hpgl_state.user_loc.x = hpgl_state.user_loc.y = 0.0f;
+        moveto(0, 0);
+    }
+
+    current_pen = pen;
+}
+
+#endif
+
+uint_fast16_t get_pen (void)
+{
+    return current_pen;
+}
+
+// Travel moves are executed at the pen up feed rate, line pattern gaps at the current feed rate.
+static bool plan_motion (hpgl_point_t point, bool travel)
+{
+    // Statistics only, the X + Y travel is used so that no square root is needed per move.
+    uint32_t distance = (uint32_t)(abs(point.x - actual.x) + abs(point.y - actual.y));
+
+    if(travel || pen_raised)
+        hpgl_stats.pen_up_distance += distance;
+    else
+        hpgl_stats.pen_down_distance += distance;
+
+    actual = point;
     last_action = hal.get_elapsed_ticks();
 
-    return mc_line(target.values, &plan_data);
+    if(travel)
+        return output->move(point, hpgl_settings.feed_rate_up == 0.0f, hpgl_settings.feed_rate_up);
+
+    return output->move(point, false, feed_rate);
+}
+
+static inline bool plan_move (hpgl_point_t point)
+{
+    return plan_motion(point, get_pen_status() != Pen_Down);
+}
+
+// Raise or lower the pen without changing the pen status, for line pattern gaps and clipped segments.
+static void dash_pen (bool down)
+{
+    if(pen_raised == down) {
+        if(!(pen_raised = !down))
+            last_action = hal.get_elapsed_ticks();
+        else
+            hpgl_stats.pen_lifts++;
+        output->pen(down ? Pen_Down : Pen_Up);
+    }
+}
+
+// Split a pen down vector into line pattern dashes and gaps.
+// Gaps are moved at the current feed rate, pen changes are queued in order with the motion.
+// With the pen on the spindle each gap drains the planner, set HPGL_PEN_PORT to avoid that.
+static bool dash_moveto (hpgl_point_t to)
+{
+    bool ok = true, down;
+    hpgl_point_t point;
+
+    dash_begin(actual, to);
+
+    while(ok && dash_next(&point, &down)) {
+        dash_pen(down);
+        if(point.x != actual.x || point.y != actual.y)
+            ok = plan_move(point);
+    }
+
+    return ok;
+}
+
+/// Move to plotter coordinates, the segment from the previous commanded position is
+/// clipped against the input window (IW) before being passed to the planner.
+/// Pen up moves outside the window are not executed but the commanded position is
+/// tracked, the pen is lowered where a pen down segment enters the window and
+/// lifted when it reenters at a different position than where it left.
+bool moveto (hpgl_coord_t x, hpgl_coord_t y)
+{
+    bool ok = true;
+    hpgl_point_t from = commanded, to = { .x = x, .y = y };
+
+    commanded = to;
+
+    if(polygon_mode()) {
+        if(!polygon_add(to, get_pen_status() == Pen_Down))
+            hpgl_set_error(ERR_BufferOverflow);
+        return true;
+    }
+
+    if(get_pen_status() != Pen_Down)
+        return clip_inside(to) ? plan_move(to) : true;
+
+    if(clip_line(&from, &to) == Clip_Rejected)
+        return true;
+
+    if(from.x != actual.x || from.y != actual.y) {
+        dash_pen(false);
+        ok = plan_motion(from, true);
+        dash_restart();
+    }
+
+    if(dash_enabled())
+        return ok && dash_moveto(to);
+
+    if(pen_raised)
+        dash_pen(true);
+
+    return ok && (to.x == actual.x && to.y == actual.y ? true : plan_move(to));
+}
+
+static void polygon_enter (void)
+{
+    polygon_pen = get_pen_status();
+    polygon_begin(commanded);
+}
+
+// Exit polygon mode, the pen is moved to the current location and restored to the status it had when polygon mode was entered.
+static void polygon_exit (void)
+{
+    polygon_end();
+    pen_status = polygon_pen;
+
+    if(commanded.x != actual.x || commanded.y != actual.y) {
+        pen_control(Pen_Up);
+        plan_move(commanded);
+        pen_control(polygon_pen);
+    }
+}
+
+static void polygon_line (hpgl_point_t from, hpgl_point_t to)
+{
+    if(from.x != commanded.x || from.y != commanded.y) {
+        pen_control(Pen_Up);
+        moveto(from.x, from.y);
+    }
+    pen_control(Pen_Down);
+    moveto(to.x, to.y);
+}
+
+// Fill (FP) or outline (EP) the polygon buffer, pen status and location are restored when done.
+static void polygon_plot (bool fill)
+{
+    hpgl_point_t org = commanded;
+    pen_status_t pen = get_pen_status();
+
+    if(fill)
+        polygon_fill(mmtohpgl_y(hpgl_state.pen_thickness), polygon_line);
+    else
+        polygon_edge(polygon_line);
+
+    pen_control(Pen_Up);
+    moveto(org.x, org.y);
+    pen_control(pen);
 }
 
 void state_changed (sys_state_t state)
@@ -252,8 +804,10 @@ void state_changed (sys_state_t state)
     if(state == STATE_IDLE && prev_state == STATE_JOG) {
         coord_data_t position;
         system_convert_array_steps_to_mpos(position.values, sys.position);
-        hpgl_state.user_loc.x = (position.x - origin.x) / 0.025f;
-        hpgl_state.user_loc.y = (position.y - origin.y) / 0.025f;
+        hpgl_state.user_loc.x = (position.x - origin.x) * hpgl_settings.units_per_mm_x;
+        hpgl_state.user_loc.y = (position.y - origin.y) * hpgl_settings.units_per_mm_y;
+        commanded.x = actual.x = (hpgl_coord_t)lroundf(hpgl_state.user_loc.x);
+        commanded.y = actual.y = (hpgl_coord_t)lroundf(hpgl_state.user_loc.y);
     }
 
     if(state == STATE_IDLE || state == STATE_JOG)
@@ -269,11 +823,91 @@ void poll_stuff (sys_state_t state)
         return;
     }
 
+    events_pump();
+
     // If no motion for 55s lift pen
-    if(get_pen_status() == Pen_Down && (hal.get_elapsed_ticks() - last_action) >= 55000)
+    if(get_pen_status() == Pen_Down && events_empty() && (hal.get_elapsed_ticks() - last_action) >= 55000)
         pen_control(Pen_Timeout);
 }
 
+static inline void stats_count_command (hpgl_command_t cmd)
+{
+    switch(cmd) {
+
+        case CMD_PA:
+        case CMD_PR:
+        case CMD_PU:
+        case CMD_PD:
+            hpgl_stats.plot_commands++;
+            break;
+
+        case CMD_AA:
+        case CMD_AR:
+        case CMD_CI:
+        case CMD_EW:
+            hpgl_stats.arc_commands++;
+            break;
+
+        case CMD_EA:
+        case CMD_ER:
+            hpgl_stats.edge_commands++;
+            break;
+
+        case CMD_LB0:
+            hpgl_stats.label_commands++;
+            break;
+
+        case CMD_LB:
+            break;
+
+        case CMD_ERR:
+            hpgl_stats.errors++;
+            break;
+
+        default:
+            hpgl_stats.other_commands++;
+            break;
+    }
+}
+
+// Plot a label span, pen up moves between strokes are merged.
+static void plot_label (const char *text, uint_fast8_t length)
+{
+    bool more, pending = false;
+    hpgl_point_t target, travel;
+    pen_status_t pen;
+
+    while(length--) {
+
+        uint8_t c = (uint8_t)*text++;
+
+        do {
+            target.x = -1;
+            more = text_char(c, &target, &pen);
+            c = 0;
+            if(valid_target(target)) {
+                if(pen == Pen_Down) {
+                    if(pending) {
+                        pen_control(Pen_Up);
+                        moveto(travel.x, travel.y);
+                        pending = false;
+                    }
+                    pen_control(Pen_Down);
+                    moveto(target.x, target.y);
+                } else {
+                    travel = target;
+                    pending = true;
+                }
+            }
+        } while(more);
+    }
+
+    if(pending) {
+        pen_control(Pen_Up);
+        moveto(travel.x, travel.y);
+    }
+}
+
 /// Main loop routine.
 ///
 /// Could be re-implemented as a state machine as complexity increases. So far there are only 3 states:
@@ -285,21 +919,19 @@ void poll_stuff (sys_state_t state)
 void do_stuff (char c)
 {
     hpgl_point_t target;
-    uint8_t labelchar;
     pen_status_t on_finish_path = Pen_NoAction;
     hpgl_command_t cmd = 0;
-
-    target.x = target.y = -1;
+    const hpgl_command_record_t *record;
 
     if(c == ASCII_CAN) {
 
-        // Restore stream handling and exit back to normal operation
-
-        protocol_buffer_synchronize();
-        sync_position();
+        // Restore stream handling and exit back to normal operation, the pen is lifted before
+        // poll_stuff() is unhooked since the lift is queued.
 
         pen_control(Pen_Up);
 
+        planner_sync();
+
         memcpy(&hal.stream, &stream, sizeof(io_stream_t));
         hal.stream.set_enqueue_rt_handler(enqueue_realtime_command);
 
@@ -318,11 +950,21 @@ void do_stuff (char c)
         return;
     }
 
-    switch((cmd = hpgl_char(c, &target, &labelchar))) {
+    if((record = hpgl_char(c)) == NULL) {
+        pollc = 0;
+        return;
+    }
+
+    cmd = record->cmd;
+    target = record->target;
+
+    stats_count_command(cmd);
+
+    switch(cmd) {
 
         case CMD_AA:
         case CMD_AR: // AR: Arc relative
-            if(arc_init()) {
+            if(arc_init(record->param)) {
                 while(arc_next(&target))
                     moveto(target.x, target.y);
                 moveto(target.x, target.y);
@@ -330,14 +972,14 @@ void do_stuff (char c)
             break;
 
         case CMD_AS:
-            //set_acceleration_mode(hpgl_state.numpad[0]);
+            //set_acceleration_mode(record->param[0]);
             break;
 
         case CMD_CI:
             {
                 hpgl_point_t point;
                 user_point_t org = hpgl_state.user_loc;
-                if(circle_init(&point)) {
+                if(circle_init(record->param, &point)) {
                     on_finish_path = get_pen_status();
                     pen_control(Pen_Up);
                     moveto(point.x, point.y);
@@ -354,11 +996,11 @@ void do_stuff (char c)
             break;
 
         case CMD_CP:
-            text_pos(hpgl_state.numpad[0], hpgl_state.numpad[1], &target);
+            text_pos(record->param[0], record->param[1], &target);
             break;
 
         case CMD_DI:
-            text_direction(hpgl_state.numpad[0], hpgl_state.numpad[1]);
+            text_direction(record->param[0], record->param[1]);
             break;
 
         case CMD_EA:
@@ -375,20 +1017,76 @@ void do_stuff (char c)
             break;
 
         case CMD_EW: // EW: Edge Wedge
-            if(wedge_init()) {
-                while(arc_next(&target)) {
+            if(wedge_init(record->param)) {
+                while(arc_next(&target))
                     moveto(target.x, target.y);
-                            protocol_buffer_synchronize();
-                }
                 moveto(target.x, target.y);
             }
             break;
 
+        case CMD_EP:
+        case CMD_FP:
+            if(!polygon_mode())
+                polygon_plot(cmd == CMD_FP);
+            break;
+
+        case CMD_PM:
+            switch((uint_fast8_t)record->param[0]) {
+
+                case 0:
+                    if(polygon_mode())
+                        polygon_end();
+                    polygon_enter();
+                    break;
+
+                case 1:
+                    if(polygon_mode())
+                        polygon_close(commanded);
+                    break;
+
+                default:
+                    if(polygon_mode())
+                        polygon_exit();
+                    break;
+            }
+            break;
+
+        case CMD_RA:
+        case CMD_RR:
+            if(!polygon_mode()) {
+                hpgl_point_t org = commanded;
+                polygon_enter();
+                pen_control(Pen_Down);
+                moveto(target.x, org.y);
+                moveto(target.x, target.y);
+                moveto(org.x, target.y);
+                moveto(org.x, org.y);
+                polygon_exit();
+                polygon_plot(true);
+            }
+            target.x = -1;
+            break;
+
+        case CMD_WG:
+            if(!polygon_mode()) {
+                polygon_enter();
+                pen_control(Pen_Down);
+                if(wedge_init(record->param)) {
+                    while(arc_next(&target))
+                        moveto(target.x, target.y);
+                    moveto(target.x, target.y);
+                }
+                polygon_exit();
+                polygon_plot(true);
+            }
+            target.x = -1;
+            break;
+
         case CMD_IN:
             // 1. home
             // 2. init scale etc
 #ifdef GO_HOME_ON_IN
-             if(settings.homing.flags.enabled)
+             if(output->live && settings.homing.flags.enabled)
                 go_home();
 #endif
             target.x = target.y = 0;
@@ -401,18 +1099,8 @@ void do_stuff (char c)
             break;
 
         case CMD_LB:
-            if (labelchar != 0) {
-                pen_status_t penny;
-                //printf_P(PSTR("[%c]"), labelchar);
-                while(text_char(labelchar, &target, &penny)) {
-                    labelchar = 0;
-                    pen_control(penny);
-                    moveto(target.x, target.y);
-                }
-                pen_control(penny);
-                moveto(target.x, target.y);
-                target.x = -1;
-            }
+            plot_label(record->label, record->label_length);
+            target.x = -1;
             //text_active = 1;
             break;
 
@@ -431,11 +1119,12 @@ void do_stuff (char c)
             break;
 
         case CMD_SEEK0:
-            go_home();
+            if(output->live)
+                go_home();
             break;
 
         case CMD_SI:
-            text_scale_cm(hpgl_state.numpad[0], hpgl_state.numpad[1]);
+            text_scale_cm(record->param[0], record->param[1]);
             break;
 
         case CMD_SP: // Select pen
@@ -443,11 +1132,11 @@ void do_stuff (char c)
             break;
 
         case CMD_SR:
-            text_scale_rel(hpgl_state.numpad[0], hpgl_state.numpad[1]);
+            text_scale_rel(record->param[0], record->param[1]);
             break;
 
         case CMD_VS:
-            set_speed(hpgl_state.numpad[0]);
+            set_speed(record->param[0]);
             break;
 
         case CMD_ERR:
@@ -461,22 +1150,21 @@ void do_stuff (char c)
     }
 
 
-    if (on_finish_path != Pen_NoAction) {
-        protocol_buffer_synchronize();
-        sync_position();
+    if (on_finish_path != Pen_NoAction)
         pen_control(on_finish_path);
-    }
 
     switch(cmd) {
 
         case CMD_IN:
             plotter_init();
+            hpgl_stats_reset();
             // Get current position.
-            system_convert_array_steps_to_mpos(origin.values, sys.position);
+            if(output->live)
+                system_convert_array_steps_to_mpos(origin.values, sys.position);
             break;
 
         case CMD_SP: // Select pen
-            select_pen((uint_fast16_t)truncf(hpgl_state.numpad[0]));
+            select_pen((uint_fast16_t)truncf(record->param[0]));
             break;
 
         default:
@@ -518,6 +1206,7 @@ static void await_homed (sys_state_t state)
             // Get current position.
             system_convert_array_steps_to_mpos(origin.values, sys.position);
 
+            events_flush(); // Discard moves queued relative to the old origin.
             plotter_init();
         }
 
@@ -536,6 +1225,7 @@ static void go_home (void)
     hal.stream.write = hal.stream.write_all = stream_write_null;
 
     pen_control(Pen_Up);
+    planner_sync();
     system_execute_line(cmd);
 
     plan_data_init(&plan_data);
@@ -590,6 +1280,31 @@ void report_extended_status (void *data)
     hal.stream.write(ASCII_EOL);
 }
 
+// Nonstandard, outputs received characters, parsed characters, parser throughput (characters/s),
+// XOFFs sent, deferred ACKs, host XON latency (ms), max characters received after XOFF,
+// high (XOFF) and low (XON) watermarks.
+void report_flow_stats (void *data)
+{
+    hal.stream.write(uitoa(flow.rx_bytes));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(flow.parsed_bytes));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(flow.drain_rate));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(flow.xoff_count));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(flow.ack_deferred));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(flow.latency_ms));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(flow.skid_max));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(flow.high_watermark));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(flow.low_watermark));
+    hal.stream.write(ASCII_EOL);
+}
+
 static inline bool get_value (char *s, int32_t *v)
 {
     bool ok;
@@ -612,6 +1327,7 @@ static ISR_CODE void ISR_FUNC(set_handshake_mode)(void)
         base_handler = stream_insert_buffer;
 
     hpgl_state.comm.enable_dtr = base_handler == stream_insert_buffer && stream_get_flags(hal.stream).rts_handshake;
+    flow_reset();
     hal.stream.set_enqueue_rt_handler(base_handler);
 }
 
@@ -650,6 +1366,7 @@ static ISR_CODE void ISR_FUNC(process_dci)(void)
             if((dc_data.enquiry = present[1] ? val[1] : 0))
                 dc_data.block_size = present[0] ? min(val[0], hal.rx_buffer_size) : 80;
             else {
+                // XOFF threshold, used as given by flow_update_watermarks() up to the buffer size less one.
                 dc_data.xoff_threshold = present[0] ? min(val[0], hal.rx_buffer_size) : 0;
                 if(dc_data.xoff_threshold > 512)
                     dc_data.xon_level = hal.rx_buffer_size - (dc_data.xoff_threshold + 1);
@@ -772,6 +1489,14 @@ static ISR_CODE bool ISR_FUNC(stream_parse_esc)(char c)
                 task_add_immediate(report_extended_status, NULL);
                 break;
 
+            case 'Q': // nonstandard
+                task_add_immediate(report_flow_stats, NULL);
+                break;
+
+            case 'U': // nonstandard
+                task_add_immediate(hpgl_stats_report, NULL);
+                break;
+
             case 'R':
                 memset(&dc_data, 0, sizeof(dc_data));
                 dc_data.block_size = 80;
@@ -806,12 +1531,27 @@ static ISR_CODE bool ISR_FUNC(stream_parse_esc)(char c)
 
 // Normal mode data transfer
 
-int16_t stream_get_data (void)
+// Block mode input, parses all characters available in the input buffer in one go.
+// Yields when the planner buffer is full, a process such as homing is running or
+// the input handler is changed, e.g. on a handshake mode change or exit from HPGL mode.
+static void stream_process_block (stream_read_ptr handler)
 {
-    if(pollc == 0 && stream.get_rx_buffer_count()) {
-        pollc = stream.read();
+    uint_fast16_t count = stream.get_rx_buffer_count();
+
+    while(count-- && pollc == 0 && process == NULL && hal.stream.read == handler) {
+        if(plan_check_full_buffer()) {
+            hpgl_stats.planner_stalls++;
+            break;
+        }
+        pollc = (char)stream.read();
+        flow.parsed_bytes++;
         do_stuff(pollc);
     }
+}
+
+int16_t stream_get_data (void)
+{
+    stream_process_block(stream_get_data);
 
     return SERIAL_NO_DATA;
 }
@@ -820,6 +1560,8 @@ static ISR_CODE bool ISR_FUNC(stream_insert_buffer)(char c)
 {
     bool claim = false;
 
+    flow.rx_bytes++;
+
     switch(c) {
 
         case ASCII_ESC:
@@ -842,6 +1584,49 @@ static ISR_CODE bool ISR_FUNC(stream_insert_buffer)(char c)
 }
 
 // Xon/Xoff mode data transfer
+//
+// The watermarks are adapted to the measured host behaviour:
+//  - the high watermark (free space at which XOFF is sent) is set from the max number of
+//    characters the host has sent after receiving XOFF, at most half the buffer. Half the buffer
+//    is also used until the first XON so that a slow host does not overrun the buffer.
+//    The threshold set by ESC.H/ESC.I (xoff_threshold) is a lower limit and is used as given,
+//    also when above half the buffer, limited to the buffer size less one.
+//  - the low watermark (buffered characters at which XON is sent) is set from the measured
+//    parser throughput and the time the host takes to resume transmission after XON.
+//    The level set by ESC.R or derived from ESC.H/ESC.I (xon_level) is used until the throughput is known.
+// Set HPGL_FLOW_ADAPTIVE to 0 to use the ESC.H/ESC.I and ESC.R values as they are.
+// In order to avoid polling the buffer on every received character the ISR counts down the
+// characters that can be received before the high watermark can be reached.
+
+static void flow_update_watermarks (void)
+{
+    uint_fast16_t size = hal.rx_buffer_size - 1, high, low;
+
+#if HPGL_FLOW_ADAPTIVE
+    high = flow.skid_max ? min(flow.skid_max + (flow.skid_max >> 1) + 8, size >> 1) : size >> 1;
+    high = max(high, dc_data.xoff_threshold);
+    low = flow.drain_rate ? (uint_fast16_t)min((flow.drain_rate * (flow.latency_ms + 10) * 2) / 1000, size) : dc_data.xon_level;
+#else
+    high = dc_data.xoff_threshold;
+    low = dc_data.xon_level;
+#endif
+
+    high = min(high, size - 1);
+    if(low + high >= size)
+        low = size - high - 1;
+
+    flow.high_watermark = high;
+    flow.low_watermark = low;
+    flow.countdown = 0;
+}
+
+static void flow_reset (void)
+{
+    flow.skid_max = flow.latency_ms = 0;
+    flow.drain_rate = 0;
+    flow.await_resume = false;
+    flow_update_watermarks();
+}
 
 int16_t stream_get_data_xon (void)
 {
@@ -855,17 +1640,29 @@ int16_t stream_get_data_xon (void)
     rx_count = stream.get_rx_buffer_count();
 
     if (process == NULL && rx_count) {
+        stream_process_block(stream_get_data_xon);
+        rx_count = stream.get_rx_buffer_count();
+    }
 
-        if(pollc == 0) {
-            pollc = stream.read();
-            do_stuff(pollc);
-        }
+    if(xoff && rx_count <= flow.low_watermark) {
 
-        if(xoff && rx_count <= dc_data.xon_level) {
-            xoff = false;
-            hal.stream.write(dc_data.xon_ack_response);
-            hal.stream.read = stream_get_data;
+        uint32_t ms = hal.get_elapsed_ticks();
+
+        if(ms != flow.xoff_ms && flow.parsed_bytes - flow.xoff_parsed > 32) {
+            uint32_t rate = ((flow.parsed_bytes - flow.xoff_parsed) * 1000) / (ms - flow.xoff_ms);
+            flow.drain_rate = flow.drain_rate ? (flow.drain_rate * 3 + rate) >> 2 : rate;
         }
+
+        if(flow.skid > flow.skid_max)
+            flow.skid_max = flow.skid;
+
+        flow_update_watermarks();
+
+        flow.xon_ms = ms;
+        flow.await_resume = true;
+        xoff = false;
+        hal.stream.write(dc_data.xon_ack_response);
+        hal.stream.read = stream_get_data;
     }
 
     lock = false;
@@ -877,10 +1674,31 @@ static ISR_CODE bool ISR_FUNC(stream_insert_buffer_xoff)(char c)
 {
     bool claim = false;
 
-    if(!xoff) {
-        if((xoff = stream.get_rx_buffer_free() < dc_data.xoff_threshold)) {
-            hal.stream.write(dc_data.xoff_immediate_response);
-            hal.stream.read = stream_get_data_xon;
+    flow.rx_bytes++;
+
+    if(xoff)
+        flow.skid++;
+
+    else {
+
+        if(flow.await_resume) {
+            flow.await_resume = false;
+            flow.latency_ms = (uint_fast16_t)min(hal.get_elapsed_ticks() - flow.xon_ms, 1000);
+        }
+
+        if(--flow.countdown <= 0) {
+
+            uint_fast16_t free = stream.get_rx_buffer_free();
+
+            if((xoff = free < flow.high_watermark)) {
+                flow.skid = 0;
+                flow.xoff_count++;
+                flow.xoff_ms = hal.get_elapsed_ticks();
+                flow.xoff_parsed = flow.parsed_bytes;
+                hal.stream.write(dc_data.xoff_immediate_response);
+                hal.stream.read = stream_get_data_xon;
+            } else // Buffer space can only increase between calls, no need to check again before this is used up.
+                flow.countdown = (int_fast16_t)(free - flow.high_watermark) + 1;
         }
     }
 
@@ -921,10 +1739,7 @@ int16_t stream_get_data_ack (void)
 
     if (process == NULL && rx_count) {
 
-        if(pollc == 0) {
-            pollc = stream.read();
-            do_stuff(pollc);
-        }
+        stream_process_block(stream_get_data_ack);
 
         if(stream.get_rx_buffer_free() >= dc_data.block_size) {
             hal.stream.write(dc_data.xon_ack_response);
@@ -945,8 +1760,10 @@ static ISR_CODE void ISR_FUNC(stream_send_ack)(void)
         hal.stream.write(dc_data.xon_ack_response);
         if(dc_data.handshake_mode != 2)
             hal.stream.write(hpgl_state.term);
-    } else
+    } else {
+        flow.ack_deferred++;
         hal.stream.read = stream_get_data_ack;
+    }
 }
 
 static ISR_CODE bool ISR_FUNC(stream_await_echo_terminator)(char c)
@@ -979,6 +1796,8 @@ static ISR_CODE bool ISR_FUNC(stream_insert_buffer_enq)(char c)
 {
     bool claim = false;
 
+    flow.rx_bytes++;
+
     if(c == dc_data.enquiry) {
 
         if(dc_data.handshake_mode != 2 && dc_data.output_trigger) {
@@ -1035,6 +1854,10 @@ status_code_t hpgl_start (sys_state_t state, char *args)
 {
     plotter_init();
 
+    memset(&flow, 0, sizeof(flow));
+    flow_reset();
+    hpgl_stats_reset();
+
     if(stream.write == NULL)
         memcpy(&stream, &hal.stream, sizeof(io_stream_t));
     else {
@@ -1059,13 +1882,20 @@ status_code_t hpgl_start (sys_state_t state, char *args)
     return Status_OK;
 }
 
+bool hpgl_session_active (void)
+{
+    return on_execute_realtime != NULL;
+}
+
 void hpgl_boot (void *data)
 {
     hpgl_start(state_get(), NULL);
 }
 
 const sys_command_t hpgl_command_list[] = {
-    {"HPGL", hpgl_start, { .noargs = On }}
+    {"HPGL", hpgl_start, { .noargs = On }},
+    {"HPGL2GCODE", hpgl_to_gcode, { .allow_blocking = On }, { .str = "$HPGL2GCODE=<hpgl file>,<gcode file> - convert HPGL file to G-code" } },
+    {"HPGLSTATS", hpgl_stats_command, { .noargs = On }, { .str = "output HPGL job statistics" } }
 };
 
 static sys_commands_t hpgl_commands = {
@@ -1080,6 +1910,19 @@ void my_plugin_init (void)
 
     system_register_commands(&hpgl_commands);
 
+    hpgl_settings_init();
+
+    pen_outputs_reset();
+
+    if(HPGL_PEN_PORT >= 0) {
+        pen_output.port = HPGL_PEN_PORT;
+        if(!(ioport_can_claim_explicit() && pen_output.port < ioports_available(Port_Digital, Port_Output) &&
+              ioport_claim(Port_Digital, Port_Output, &pen_output.port, "HPGL pen"))) {
+            pen_output.port = 0xFF;
+            task_run_on_startup(report_warning, "HPGL plugin: pen port is not available, using spindle");
+        }
+    }
+
     stream.write = NULL;
 #ifdef HPGL_BOOT
     protocol_enqueue_foreground_task(hpgl_boot, NULL);
@@ -9,22 +9,58 @@
 
 #define GO_HOME_ON_IN // Uncomment to disable
 
+// Aux output port for the pen actuator, -1 to use the spindle. With an aux port pen changes are
+// synchronized with motion (M62/M63 style) instead of waiting for the planner to drain.
+#ifndef HPGL_PEN_PORT
+#define HPGL_PEN_PORT -1
+#endif
+
 #define PSTR(s) s
 #define printf_P printf
 #define DELAY_MS(ms) hal.delay_ms(ms, NULL)
 
+/// Motion output, the HPGL engine either outputs to the planner (default)
+/// or to a sink such as the G-code file writer.
+typedef struct {
+    bool live;                                                          ///< true if output is to the machine
+    bool (*move)(hpgl_point_t point, bool rapid, float feed_rate);      ///< move to absolute plotter coordinates
+    void (*pen)(pen_status_t state);                                    ///< raise/lower pen, including settle delays
+    bool (*tool)(uint_fast16_t pen);                                    ///< change pen, called with the pen raised, false if not changed
+    void (*sync)(void);                                                 ///< wait for buffered motions to complete
+} hpgl_output_t;
+
 /// Controls the pen position. Both servo and solenoid actuators.
-/// Causes immediate delay to allow for the pen to settle.
+/// The pen change is queued in order with motion, actuation and settle delay
+/// are handled from the foreground process without blocking.
 ///
 /// @param down true if pen should be down, 0 if raised
 void pen_control (pen_status_t state);
 
 pen_status_t get_pen_status (void);
 
+/// Select pen, SP command. When HPGL_PENS > 0 the pen is changed by the output tool handler.
+void select_pen (uint_fast16_t pen);
+
+/// Get selected pen, 0 if none.
+uint_fast16_t get_pen (void);
+
 /// Initialize plotter state. Move to home position, then reset everything, including motors and timers.
 /// Reset user scale and translation, raise the pen.
 void plotter_init();
 
 coord_data_t *get_origin (void);
 
+/// Set motion output, pass NULL to restore output to the planner. Pen status and selected pen are reset.
+void hpgl_set_output (const hpgl_output_t *output);
+const hpgl_output_t *hpgl_get_output (void);
+
+/// $HPGL, start a live session. The session is ended by CAN (0x18).
+status_code_t hpgl_start (sys_state_t state, char *args);
+
+/// Check if a live $HPGL session is running.
+bool hpgl_session_active (void);
+
+/// Feed one character to the HPGL engine.
+void do_stuff (char c);
+
 #endif
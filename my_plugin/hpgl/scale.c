@@ -2,28 +2,38 @@
 #include <stdio.h>
 
 #include "scale.h"
+#include "config.h"
 
 #include "grbl/hal.h"
 
-static user_point_t user_scale, user_translate;
+static bool unity_scale = true;
+static user_point_t user_scale, user_rscale, user_translate;
+
+// Round half away from zero like roundf() without the library call.
+static inline hpgl_coord_t to_hpgl (float v)
+{
+    return (hpgl_coord_t)(v >= 0.0f ? v + 0.5f : v - 0.5f);
+}
 
 void translate_init_ip (void)
 {
     hpgl_state.ip_pad[0] = 0;
     hpgl_state.ip_pad[1] = 0;
-    hpgl_state.ip_pad[2] = MAX_X;
-    hpgl_state.ip_pad[3] = MAX_Y;
+    hpgl_state.ip_pad[2] = hpgl_settings.max_x;
+    hpgl_state.ip_pad[3] = hpgl_settings.max_y;
 }
 
 void translate_init_sc (void)
 {
+    unity_scale = true;
     user_scale.x = user_scale.y = 1.0f;
+    user_rscale.x = user_rscale.y = 1.0f;
     user_translate.x = user_translate.y = 0.0f;
 
     hpgl_state.sc_pad[0] = 0;
-    hpgl_state.sc_pad[1] = MAX_X;
+    hpgl_state.sc_pad[1] = hpgl_settings.max_x;
     hpgl_state.sc_pad[2] = 0;
-    hpgl_state.sc_pad[3] = MAX_Y;
+    hpgl_state.sc_pad[3] = hpgl_settings.max_y;
 }
 
 // use IP and SC data to calculate the scale
@@ -36,6 +46,11 @@ void translate_scale (void)
     
     user_scale.x = iprange.x / (float)scxrange;
     user_scale.y = iprange.y / (float)scyrange;
+    // Precalculate reciprocals so that the per point transforms does not divide,
+    // results are within one plotter unit of dividing (test/test_scale.c)
+    user_rscale.x = (float)scxrange / iprange.x;
+    user_rscale.y = (float)scyrange / iprange.y;
+    unity_scale = user_scale.x == 1.0f && user_scale.y == 1.0f;
     //user_xscale = ((float)scxrange)/((float)ipxrange);
     //user_yscale = ((float)scyrange)/((float)ipyrange);
     user_translate.x = -hpgl_state.sc_pad[0] * user_scale.x;
@@ -46,38 +61,58 @@ void translate_scale (void)
 
 void userprescale (user_point_t abs, user_point_t *out)
 {
-    out->x = abs.x / user_scale.x;
-    out->y = abs.y / user_scale.y;
+    out->x = abs.x * user_rscale.x;
+    out->y = abs.y * user_rscale.y;
 }
 
 void usertohpgl (user_point_t src, hpgl_point_t *target)
 {
-    target->x = (int16_t)roundf(src.x * user_scale.x);
-    target->y = (int16_t)roundf(src.y * user_scale.y);
+    if(unity_scale) {
+        target->x = to_hpgl(src.x);
+        target->y = to_hpgl(src.y);
+    } else {
+        target->x = to_hpgl(src.x * user_scale.x);
+        target->y = to_hpgl(src.y * user_scale.y);
+    }
 }
 
 void userscalerelative (user_point_t src, hpgl_point_t *target, user_point_t *out)
 {
-    target->x = (int16_t)roundf(out->x + src.x * user_scale.x);
-    target->y = (int16_t)roundf(out->y + src.y * user_scale.y);
-
-    if(out) {
-        out->x = (float)target->x / user_scale.x;
-        out->y = (float)target->y / user_scale.y;
+    if(unity_scale) {
+        target->x = to_hpgl(out->x + src.x);
+        target->y = to_hpgl(out->y + src.y);
+        out->x = (float)target->x;
+        out->y = (float)target->y;
+    } else {
+        target->x = to_hpgl(out->x + src.x * user_scale.x);
+        target->y = to_hpgl(out->y + src.y * user_scale.y);
+        out->x = (float)target->x * user_rscale.x;
+        out->y = (float)target->y * user_rscale.y;
     }
 }
 
 void userscale (user_point_t src, hpgl_point_t *target, user_point_t *out)
 {
-    target->x = (int16_t)roundf(src.x * user_scale.x);
-    target->y = (int16_t)roundf(src.y * user_scale.y);
+    usertohpgl(src, target);
 
     if(out) {
-        out->x = (float)target->x / user_scale.x;
-        out->y = (float)target->y / user_scale.y;
+        if(unity_scale) {
+            out->x = (float)target->x;
+            out->y = (float)target->y;
+        } else {
+            out->x = (float)target->x * user_rscale.x;
+            out->y = (float)target->y * user_rscale.y;
+        }
     }
 }
 
+hpgl_coord_t mmtohpgl_y (float mm)
+{
+    hpgl_coord_t units = to_hpgl(mm * hpgl_settings.units_per_mm_y);
+
+    return units < 1 ? 1 : units;
+}
+
 user_point_t range_P1P2 (void)
 {
     user_point_t p;
@@ -30,6 +30,10 @@ void userscalerelative (user_point_t src, hpgl_point_t *target, user_point_t *ou
 
 void usertohpgl (user_point_t src, hpgl_point_t *target);
 
+/// Convert a length in mm, such as the pen thickness, to plotter units along the y axis.
+/// @returns length in plotter units, at least one
+hpgl_coord_t mmtohpgl_y (float mm);
+
 /// Something that shouldn't be used 
 void userprescale (user_point_t abs, user_point_t *out);
 
@@ -0,0 +1,88 @@
+/// \file stats.c
+/// HPGL job statistics, counters are updated inline by the engine and are cheap enough to be always enabled.
+
+#include <string.h>
+
+#include "stats.h"
+
+#define HPGL_MM_PER_UNIT 0.025f
+
+hpgl_stats_t hpgl_stats = {0};
+
+void hpgl_stats_reset (void)
+{
+    memset(&hpgl_stats, 0, sizeof(hpgl_stats_t));
+    hpgl_stats.start_ms = hal.get_elapsed_ticks();
+}
+
+void hpgl_stats_report (void *data)
+{
+    hal.stream.write(uitoa(hal.get_elapsed_ticks() - hpgl_stats.start_ms));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.plot_commands));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.arc_commands));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.edge_commands));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.label_commands));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.other_commands));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.errors));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.pen_lifts));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.pen_down_distance));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.pen_up_distance));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.arcs));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.chords));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.glyphs));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.planner_stalls));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.sync_count));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.sync_us / 1000));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(hpgl_stats.pen_changes));
+    hal.stream.write(ASCII_EOL);
+}
+
+static void report_value (const char *name, uint32_t value)
+{
+    hal.stream.write(name);
+    hal.stream.write(uitoa(value));
+    hal.stream.write(ASCII_EOL);
+}
+
+status_code_t hpgl_stats_command (sys_state_t state, char *args)
+{
+    report_value("Job time (ms): ", hal.get_elapsed_ticks() - hpgl_stats.start_ms);
+    report_value("Plot commands: ", hpgl_stats.plot_commands);
+    report_value("Arc commands: ", hpgl_stats.arc_commands);
+    report_value("Edge commands: ", hpgl_stats.edge_commands);
+    report_value("Label commands: ", hpgl_stats.label_commands);
+    report_value("Other commands: ", hpgl_stats.other_commands);
+    report_value("Errors: ", hpgl_stats.errors);
+    report_value("Pen lifts: ", hpgl_stats.pen_lifts);
+    report_value("Pen changes: ", hpgl_stats.pen_changes);
+    hal.stream.write("Pen down X+Y travel (mm): ");
+    hal.stream.write(ftoa((float)hpgl_stats.pen_down_distance * HPGL_MM_PER_UNIT, 1));
+    hal.stream.write(ASCII_EOL);
+    hal.stream.write("Pen up X+Y travel (mm): ");
+    hal.stream.write(ftoa((float)hpgl_stats.pen_up_distance * HPGL_MM_PER_UNIT, 1));
+    hal.stream.write(ASCII_EOL);
+    report_value("Arcs: ", hpgl_stats.arcs);
+    report_value("Chords: ", hpgl_stats.chords);
+    report_value("Glyphs: ", hpgl_stats.glyphs);
+    report_value("Planner full stalls: ", hpgl_stats.planner_stalls);
+    report_value("Motion syncs: ", hpgl_stats.sync_count);
+    report_value("Motion sync time (ms): ", hpgl_stats.sync_us / 1000);
+
+    return Status_OK;
+}
@@ -0,0 +1,42 @@
+#ifndef _STATS_H
+#define _STATS_H
+
+#include "grbl/hal.h"
+
+/// Per job counters, reset on $HPGL and IN.
+typedef struct {
+    uint32_t start_ms;
+    uint32_t plot_commands;     ///< PA, PR, PU and PD, one per coordinate pair
+    uint32_t arc_commands;      ///< AA, AR, CI and EW
+    uint32_t edge_commands;     ///< EA and ER
+    uint32_t label_commands;    ///< LB
+    uint32_t other_commands;
+    uint32_t errors;
+    uint32_t pen_lifts;
+    uint32_t pen_changes;
+    uint32_t pen_down_distance; ///< X + Y travel, plotter units
+    uint32_t pen_up_distance;   ///< X + Y travel, plotter units
+    uint32_t arcs;
+    uint32_t chords;
+    uint32_t glyphs;
+    uint32_t planner_stalls;    ///< Input parsing paused due to planner or motion queue full
+    uint32_t sync_count;        ///< Number of waits for motion to complete
+    uint32_t sync_us;           ///< Time spent waiting for motion to complete
+} hpgl_stats_t;
+
+extern hpgl_stats_t hpgl_stats;
+
+static inline uint32_t hpgl_stats_us (void)
+{
+    return hal.get_micros ? hal.get_micros() : hal.get_elapsed_ticks() * 1000;
+}
+
+void hpgl_stats_reset (void);
+
+/// ESC.U (nonstandard), outputs the counters as comma separated values.
+void hpgl_stats_report (void *data);
+
+/// $HPGLSTATS - outputs the counters in human readable form.
+status_code_t hpgl_stats_command (sys_state_t state, char *args);
+
+#endif
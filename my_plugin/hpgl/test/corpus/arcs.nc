@@ -0,0 +1,408 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+X75.000Y75.000
+M3S1000
+G4P0.070
+G1X72.825Y74.900F1000
+X70.650Y74.625
+X68.525Y74.150
+X66.450Y73.500
+X64.425Y72.650
+X62.500Y71.650
+X60.650Y70.475
+X58.925Y69.150
+X57.325Y67.675
+X55.850Y66.075
+X54.525Y64.350
+X53.350Y62.500
+X52.350Y60.575
+X51.500Y58.550
+X50.850Y56.475
+X50.375Y54.350
+X50.100Y52.175
+X50.000Y50.000
+X50.200Y52.175
+X50.750Y54.275
+X51.675Y56.250
+X52.925Y58.025
+X54.475Y59.575
+X56.250Y60.825
+X58.225Y61.750
+X60.325Y62.300
+X62.500Y62.500
+X64.675Y62.300
+X66.775Y61.750
+X68.750Y60.825
+X70.525Y59.575
+X72.075Y58.025
+X73.325Y56.250
+X74.250Y54.275
+X74.800Y52.175
+X75.000Y50.000
+M5
+G4P0.050
+G0X150.000Y100.000
+X162.500
+M3S1000
+G4P0.070
+G1X162.450Y101.100
+X162.300Y102.175
+X162.075Y103.225
+X161.750Y104.275
+X161.325Y105.275
+X160.825Y106.250
+X160.250Y107.175
+X159.575Y108.025
+X158.850Y108.850
+X158.025Y109.575
+X157.175Y110.250
+X156.250Y110.825
+X155.275Y111.325
+X154.275Y111.750
+X153.225Y112.075
+X152.175Y112.300
+X151.100Y112.450
+X150.000Y112.500
+X148.900Y112.450
+X147.825Y112.300
+X146.775Y112.075
+X145.725Y111.750
+X144.725Y111.325
+X143.750Y110.825
+X142.825Y110.250
+X141.975Y109.575
+X141.150Y108.850
+X140.425Y108.025
+X139.750Y107.175
+X139.175Y106.250
+X138.675Y105.275
+X138.250Y104.275
+X137.925Y103.225
+X137.700Y102.175
+X137.550Y101.100
+X137.500Y100.000
+X137.550Y98.900
+X137.700Y97.825
+X137.925Y96.775
+X138.250Y95.725
+X138.675Y94.725
+X139.175Y93.750
+X139.750Y92.825
+X140.425Y91.975
+X141.150Y91.150
+X141.975Y90.425
+X142.825Y89.750
+X143.750Y89.175
+X144.725Y88.675
+X145.725Y88.250
+X146.775Y87.925
+X147.825Y87.700
+X148.900Y87.550
+X150.000Y87.500
+X151.100Y87.550
+X152.175Y87.700
+X153.225Y87.925
+X154.275Y88.250
+X155.275Y88.675
+X156.250Y89.175
+X157.175Y89.750
+X158.025Y90.425
+X158.850Y91.150
+X159.575Y91.975
+X160.250Y92.825
+X160.825Y93.750
+X161.325Y94.725
+X161.750Y95.725
+X162.075Y96.775
+X162.300Y97.825
+X162.450Y98.900
+X162.500Y100.000
+M5
+G4P0.050
+G0X150.000
+X156.250
+M3S1000
+G4P0.070
+G1Y100.225
+X156.225Y100.425
+Y100.650
+X156.200Y100.875
+X156.150Y101.075
+X156.125Y101.300
+X156.075Y101.500
+X156.000Y101.725
+X155.950Y101.925
+X155.875Y102.150
+X155.800Y102.350
+X155.700Y102.550
+X155.625Y102.750
+X155.525Y102.925
+X155.425Y103.125
+X155.300Y103.300
+X155.175Y103.500
+X155.050Y103.675
+X154.925Y103.850
+X154.800Y104.025
+X154.650Y104.175
+X154.500Y104.350
+X154.350Y104.500
+X154.175Y104.650
+X154.025Y104.800
+X153.850Y104.925
+X153.675Y105.050
+X153.500Y105.175
+X153.300Y105.300
+X153.125Y105.425
+X152.925Y105.525
+X152.750Y105.625
+X152.550Y105.700
+X152.350Y105.800
+X152.150Y105.875
+X151.925Y105.950
+X151.725Y106.000
+X151.500Y106.075
+X151.300Y106.125
+X151.075Y106.150
+X150.875Y106.200
+X150.650Y106.225
+X150.425
+X150.225Y106.250
+X150.000
+X149.775
+X149.575Y106.225
+X149.350
+X149.125Y106.200
+X148.925Y106.150
+X148.700Y106.125
+X148.500Y106.075
+X148.275Y106.000
+X148.075Y105.950
+X147.850Y105.875
+X147.650Y105.800
+X147.450Y105.700
+X147.250Y105.625
+X147.075Y105.525
+X146.875Y105.425
+X146.700Y105.300
+X146.500Y105.175
+X146.325Y105.050
+X146.150Y104.925
+X145.975Y104.800
+X145.825Y104.650
+X145.650Y104.500
+X145.500Y104.350
+X145.350Y104.175
+X145.200Y104.025
+X145.075Y103.850
+X144.950Y103.675
+X144.825Y103.500
+X144.700Y103.300
+X144.575Y103.125
+X144.475Y102.925
+X144.375Y102.750
+X144.300Y102.550
+X144.200Y102.350
+X144.125Y102.150
+X144.050Y101.925
+X144.000Y101.725
+X143.925Y101.500
+X143.875Y101.300
+X143.850Y101.075
+X143.800Y100.875
+X143.775Y100.650
+Y100.425
+X143.750Y100.225
+Y100.000
+Y99.775
+X143.775Y99.575
+Y99.350
+X143.800Y99.125
+X143.850Y98.925
+X143.875Y98.700
+X143.925Y98.500
+X144.000Y98.275
+X144.050Y98.075
+X144.125Y97.850
+X144.200Y97.650
+X144.300Y97.450
+X144.375Y97.250
+X144.475Y97.075
+X144.575Y96.875
+X144.700Y96.700
+X144.825Y96.500
+X144.950Y96.325
+X145.075Y96.150
+X145.200Y95.975
+X145.350Y95.825
+X145.500Y95.650
+X145.650Y95.500
+X145.825Y95.350
+X145.975Y95.200
+X146.150Y95.075
+X146.325Y94.950
+X146.500Y94.825
+X146.700Y94.700
+X146.875Y94.575
+X147.075Y94.475
+X147.250Y94.375
+X147.450Y94.300
+X147.650Y94.200
+X147.850Y94.125
+X148.075Y94.050
+X148.275Y94.000
+X148.500Y93.925
+X148.700Y93.875
+X148.925Y93.850
+X149.125Y93.800
+X149.350Y93.775
+X149.575
+X149.775Y93.750
+X150.000
+X150.225
+X150.425Y93.775
+X150.650
+X150.875Y93.800
+X151.075Y93.850
+X151.300Y93.875
+X151.500Y93.925
+X151.725Y94.000
+X151.925Y94.050
+X152.150Y94.125
+X152.350Y94.200
+X152.550Y94.300
+X152.750Y94.375
+X152.925Y94.475
+X153.125Y94.575
+X153.300Y94.700
+X153.500Y94.825
+X153.675Y94.950
+X153.850Y95.075
+X154.025Y95.200
+X154.175Y95.350
+X154.350Y95.500
+X154.500Y95.650
+X154.650Y95.825
+X154.800Y95.975
+X154.925Y96.150
+X155.050Y96.325
+X155.175Y96.500
+X155.300Y96.700
+X155.425Y96.875
+X155.525Y97.075
+X155.625Y97.250
+X155.700Y97.450
+X155.800Y97.650
+X155.875Y97.850
+X155.950Y98.075
+X156.000Y98.275
+X156.075Y98.500
+X156.125Y98.700
+X156.150Y98.925
+X156.200Y99.125
+X156.225Y99.350
+Y99.575
+X156.250Y99.775
+Y100.000
+M5
+G4P0.050
+G0X150.000
+X25.000Y125.000
+X34.950Y125.875
+X34.850Y126.725
+X34.650Y127.600
+X34.400Y128.425
+X34.075Y129.225
+X33.650Y130.000
+X33.200Y130.725
+X32.650Y131.425
+X32.075Y132.075
+X31.425Y132.650
+X30.725Y133.200
+X30.000Y133.650
+X29.225Y134.075
+X28.425Y134.400
+X27.600Y134.650
+X26.725Y134.850
+X25.875Y134.950
+X25.000Y135.000
+Y125.000
+X200.000Y25.000
+M3S1000
+G4P0.070
+G1X198.900Y24.950
+X197.825Y24.800
+X196.775Y24.575
+X195.725Y24.250
+X194.725Y23.825
+X193.750Y23.325
+X192.825Y22.750
+X191.975Y22.075
+X191.150Y21.350
+X190.425Y20.525
+X189.750Y19.675
+X189.175Y18.750
+X188.675Y17.775
+X188.250Y16.775
+X187.925Y15.725
+X187.700Y14.675
+X187.550Y13.600
+X187.500Y12.500
+X187.550Y11.400
+X187.700Y10.325
+X187.925Y9.275
+X188.250Y8.225
+X188.675Y7.225
+X189.175Y6.250
+X189.750Y5.325
+X190.425Y4.475
+X191.150Y3.650
+X191.975Y2.925
+X192.825Y2.250
+X193.750Y1.675
+X194.725Y1.175
+X195.725Y0.750
+X196.775Y0.425
+X197.825Y0.200
+X198.900Y0.050
+X200.000Y0.000
+X201.100Y0.050
+X202.175Y0.200
+X203.225Y0.425
+X204.275Y0.750
+X205.275Y1.175
+X206.250Y1.675
+X207.175Y2.250
+X208.025Y2.925
+X208.850Y3.650
+X209.575Y4.475
+X210.250Y5.325
+X210.825Y6.250
+X211.325Y7.225
+X211.750Y8.225
+X212.075Y9.275
+X212.300Y10.325
+X212.450Y11.400
+X212.500Y12.500
+X212.450Y13.600
+X212.300Y14.675
+X212.075Y15.725
+X211.750Y16.775
+X211.325Y17.775
+X210.825Y18.750
+X210.250Y19.675
+X209.575Y20.525
+X208.850Y21.350
+X208.025Y22.075
+X207.175Y22.750
+X206.250Y23.325
+X205.275Y23.825
+X204.275Y24.250
+X203.225Y24.575
+X202.175Y24.800
+X201.100Y24.950
+X200.000Y25.000
+M5
+G4P0.050
+M2
@@ -0,0 +1,29 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+X30.000Y25.000
+M3S1000
+G4P0.070
+G1X120.000Y100.000F1000
+M5
+G4P0.050
+G0X25.000Y75.000
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X75.000Y50.000
+M3S1000
+G4P0.070
+G1X87.500
+M5
+G4P0.050
+G0X0.000Y0.000
+M3S1000
+G4P0.070
+G1X2.500Y2.500
+M5
+G4P0.050
+M2
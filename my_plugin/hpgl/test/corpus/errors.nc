@@ -0,0 +1,31 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+X0.025Y0.050
+X0.000Y0.000
+M3S1000
+G4P0.070
+G1X0.025Y0.075F1000
+M5
+G4P0.050
+G0X25.000Y25.000
+M3S1000
+G4P0.070
+G1X29.775Y29.775
+M5
+G4P0.050
+X34.525Y34.525
+M3S1000
+G4P0.070
+X39.300Y39.300
+M5
+G4P0.050
+X44.050Y44.050
+M3S1000
+G4P0.070
+X48.825Y48.825
+M5
+G4P0.050
+X50.000Y50.000
+M2
@@ -0,0 +1,19 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+X2.500Y2.500
+M3S1000
+G4P0.070
+G1X50.000F1000
+Y50.000
+M5
+G4P0.050
+G0X75.000Y75.000
+M3S1000
+G4P0.070
+G1X100.000
+M5
+G4P0.050
+G0X0.000Y0.000
+M2
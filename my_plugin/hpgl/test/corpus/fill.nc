@@ -0,0 +1,461 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+X25.000Y25.000
+X30.000Y30.000
+X25.000Y25.250
+M3S1000
+G4P0.070
+G1X50.000F1000
+Y25.750
+X25.000
+Y26.250
+X50.000
+Y26.750
+X25.000
+Y27.250
+X50.000
+Y27.750
+X25.000
+Y28.250
+X50.000
+Y28.750
+X25.000
+Y29.250
+X50.000
+Y29.750
+X25.000
+Y30.250
+X30.125
+M5
+G4P0.050
+G0X44.875
+M3S1000
+G4P0.070
+G1X50.000
+Y30.750
+X44.625
+M5
+G4P0.050
+G0X30.375
+M3S1000
+G4P0.070
+G1X25.000
+Y31.250
+X30.625
+M5
+G4P0.050
+G0X44.375
+M3S1000
+G4P0.070
+G1X50.000
+Y31.750
+X44.125
+M5
+G4P0.050
+G0X30.875
+M3S1000
+G4P0.070
+G1X25.000
+Y32.250
+X31.125
+M5
+G4P0.050
+G0X43.875
+M3S1000
+G4P0.070
+G1X50.000
+Y32.750
+X43.625
+M5
+G4P0.050
+G0X31.375
+M3S1000
+G4P0.070
+G1X25.000
+Y33.250
+X31.625
+M5
+G4P0.050
+G0X43.375
+M3S1000
+G4P0.070
+G1X50.000
+Y33.750
+X43.125
+M5
+G4P0.050
+G0X31.875
+M3S1000
+G4P0.070
+G1X25.000
+Y34.250
+X32.125
+M5
+G4P0.050
+G0X42.875
+M3S1000
+G4P0.070
+G1X50.000
+Y34.750
+X42.625
+M5
+G4P0.050
+G0X32.375
+M3S1000
+G4P0.070
+G1X25.000
+Y35.250
+X32.625
+M5
+G4P0.050
+G0X42.375
+M3S1000
+G4P0.070
+G1X50.000
+Y35.750
+X42.125
+M5
+G4P0.050
+G0X32.875
+M3S1000
+G4P0.070
+G1X25.000
+Y36.250
+X33.125
+M5
+G4P0.050
+G0X41.875
+M3S1000
+G4P0.070
+G1X50.000
+Y36.750
+X41.625
+M5
+G4P0.050
+G0X33.375
+M3S1000
+G4P0.070
+G1X25.000
+Y37.250
+X33.625
+M5
+G4P0.050
+G0X41.375
+M3S1000
+G4P0.070
+G1X50.000
+Y37.750
+X41.125
+M5
+G4P0.050
+G0X33.875
+M3S1000
+G4P0.070
+G1X25.000
+Y38.250
+X34.125
+M5
+G4P0.050
+G0X40.875
+M3S1000
+G4P0.070
+G1X50.000
+Y38.750
+X40.625
+M5
+G4P0.050
+G0X34.375
+M3S1000
+G4P0.070
+G1X25.000
+Y39.250
+X34.625
+M5
+G4P0.050
+G0X40.375
+M3S1000
+G4P0.070
+G1X50.000
+Y39.750
+X40.125
+M5
+G4P0.050
+G0X34.875
+M3S1000
+G4P0.070
+G1X25.000
+Y40.250
+X35.125
+M5
+G4P0.050
+G0X39.875
+M3S1000
+G4P0.070
+G1X50.000
+Y40.750
+X39.625
+M5
+G4P0.050
+G0X35.375
+M3S1000
+G4P0.070
+G1X25.000
+Y41.250
+X35.625
+M5
+G4P0.050
+G0X39.375
+M3S1000
+G4P0.070
+G1X50.000
+Y41.750
+X39.125
+M5
+G4P0.050
+G0X35.875
+M3S1000
+G4P0.070
+G1X25.000
+Y42.250
+X36.125
+M5
+G4P0.050
+G0X38.875
+M3S1000
+G4P0.070
+G1X50.000
+Y42.750
+X38.625
+M5
+G4P0.050
+G0X36.375
+M3S1000
+G4P0.070
+G1X25.000
+Y43.250
+X36.625
+M5
+G4P0.050
+G0X38.375
+M3S1000
+G4P0.070
+G1X50.000
+Y43.750
+X38.125
+M5
+G4P0.050
+G0X36.875
+M3S1000
+G4P0.070
+G1X25.000
+Y44.250
+X37.125
+M5
+G4P0.050
+G0X37.875
+M3S1000
+G4P0.070
+G1X50.000
+Y44.750
+X37.625
+M5
+G4P0.050
+G0X37.375
+M3S1000
+G4P0.070
+G1X25.000
+Y45.250
+X50.000
+Y45.750
+X25.000
+Y46.250
+X50.000
+Y46.750
+X25.000
+Y47.250
+X50.000
+Y47.750
+X25.000
+Y48.250
+X50.000
+Y48.750
+X25.000
+Y49.250
+X50.000
+Y49.750
+X25.000
+M5
+G4P0.050
+G0X30.000Y30.000
+X25.000Y25.000
+M3S1000
+G4P0.070
+G1X50.000
+Y50.000
+X25.000
+Y25.000
+M5
+G4P0.050
+G0X30.000Y30.000
+M3S1000
+G4P0.070
+G1X45.000
+X37.500Y45.000
+X30.000Y30.000
+M5
+G4P0.050
+G0X75.000Y75.000
+Y75.250
+M3S1000
+G4P0.070
+G1X100.000
+Y75.750
+X75.000
+Y76.250
+X100.000
+Y76.750
+X75.000
+Y77.250
+X100.000
+Y77.750
+X75.000
+Y78.250
+X100.000
+Y78.750
+X75.000
+Y79.250
+X100.000
+Y79.750
+X75.000
+Y80.250
+X100.000
+Y80.750
+X75.000
+Y81.250
+X100.000
+Y81.750
+X75.000
+Y82.250
+X100.000
+Y82.750
+X75.000
+Y83.250
+X100.000
+Y83.750
+X75.000
+Y84.250
+X100.000
+Y84.750
+X75.000
+Y85.250
+X100.000
+Y85.750
+X75.000
+Y86.250
+X100.000
+Y86.750
+X75.000
+Y87.250
+X100.000
+M5
+G4P0.050
+G0X75.000Y75.000
+M3S1000
+G4P0.070
+G1X62.500
+Y68.750
+X75.000
+Y75.000
+M5
+G4P0.050
+G0X150.000Y50.000
+X149.750Y50.250
+M3S1000
+G4P0.070
+G1X152.825
+X158.500Y50.750
+X149.250
+X148.750Y51.250
+X162.425
+X162.350Y51.750
+X148.250
+X147.750Y52.250
+X162.275
+X162.175Y52.750
+X147.250
+X146.750Y53.250
+X162.075
+X161.925Y53.750
+X146.250
+X145.750Y54.250
+X161.750
+X161.550Y54.750
+X145.250
+X144.750Y55.250
+X161.325
+X161.075Y55.750
+X144.250
+X143.750Y56.250
+X160.825
+X160.525Y56.750
+X143.250
+X142.750Y57.250
+X160.200
+X159.800Y57.750
+X142.250
+X141.750Y58.250
+X159.375
+X158.950Y58.750
+X141.250
+X141.600Y59.250
+X158.400
+X157.800Y59.750
+X142.200
+X142.825Y60.250
+X157.175
+X156.375Y60.750
+X143.625
+X144.575Y61.250
+X155.425
+M5
+G4P0.050
+G0X154.275Y61.750
+M3S1000
+G4P0.070
+G1X145.725
+X147.600Y62.250
+X152.400
+M5
+G4P0.050
+G0X150.000Y50.000
+X162.450Y51.100
+X162.300Y52.175
+X162.075Y53.225
+X161.750Y54.275
+X161.325Y55.275
+X160.825Y56.250
+X160.250Y57.175
+X159.575Y58.025
+X158.850Y58.850
+X158.025Y59.575
+X157.175Y60.250
+X156.250Y60.825
+X155.275Y61.325
+X154.275Y61.750
+X153.225Y62.075
+X152.175Y62.300
+X151.100Y62.450
+X150.000Y62.500
+X148.900Y62.450
+X147.825Y62.300
+X146.775Y62.075
+X145.725Y61.750
+X144.725Y61.325
+X143.750Y60.825
+X142.825Y60.250
+X141.975Y59.575
+X141.150Y58.850
+X150.000Y50.000
+M2
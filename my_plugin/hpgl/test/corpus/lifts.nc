@@ -0,0 +1,1346 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+X12.500Y150.000
+X12.775Y151.800
+M3S1000
+G4P0.070
+G1Y150.000F1000
+X13.925
+M5
+G4P0.050
+G0X14.200
+M3S1000
+G4P0.070
+G1X15.350
+M5
+G4P0.050
+G0X14.775
+M3S1000
+G4P0.070
+G1Y151.800
+M5
+G4P0.050
+G0X14.200
+M3S1000
+G4P0.070
+G1X15.350
+M5
+G4P0.050
+G0X15.625Y150.000
+M3S1000
+G4P0.070
+G1Y151.800
+X16.775
+M5
+G4P0.050
+G0X15.625Y150.900
+M3S1000
+G4P0.070
+G1X16.500
+M5
+G4P0.050
+G0X17.625Y150.000
+M3S1000
+G4P0.070
+G1Y151.800
+X17.050
+X18.200
+M5
+G4P0.050
+G0X19.900Y150.000
+M3S1000
+G4P0.070
+G1Y151.800
+M5
+G4P0.050
+G0X21.050Y150.000
+M3S1000
+G4P0.070
+G1Y151.800
+M5
+G4P0.050
+G0X19.900Y150.900
+M3S1000
+G4P0.070
+G1X21.050
+M5
+G4P0.050
+G0X22.475Y150.000
+M3S1000
+G4P0.070
+G1X21.325
+Y151.800
+X22.475
+M5
+G4P0.050
+G0X21.325Y150.900
+M3S1000
+G4P0.070
+G1X22.200
+M5
+G4P0.050
+G0X22.750Y150.000
+M3S1000
+G4P0.070
+G1Y151.500
+X23.050Y151.800
+X23.625
+X23.900Y151.500
+Y150.000
+M5
+G4P0.050
+G0X22.750Y150.600
+M3S1000
+G4P0.070
+G1X23.900
+M5
+G4P0.050
+G0X24.175Y151.800
+M3S1000
+G4P0.070
+G1Y151.200
+X24.750Y150.000
+X25.325Y151.200
+Y151.800
+M5
+G4P0.050
+G0X25.600
+M3S1000
+G4P0.070
+G1Y151.500
+X26.175Y150.600
+Y150.000
+M5
+G4P0.050
+G0Y150.600
+M3S1000
+G4P0.070
+G1X26.750Y151.500
+Y151.800
+M5
+G4P0.050
+G0X28.450Y150.000
+M3S1000
+G4P0.070
+G1Y151.800
+X29.325
+X29.600Y151.500
+Y151.200
+X29.325Y150.900
+X28.450
+M5
+G4P0.050
+G0X29.875Y151.800
+M3S1000
+G4P0.070
+G1Y150.000
+X31.025
+M5
+G4P0.050
+G0X31.600
+M3S1000
+G4P0.070
+G1X31.300Y150.300
+Y151.500
+X31.600Y151.800
+X32.175
+X32.450Y151.500
+Y150.300
+X32.175Y150.000
+X31.600
+M5
+G4P0.050
+G0X33.300
+M3S1000
+G4P0.070
+G1Y151.800
+X32.725
+X33.875
+M5
+G4P0.050
+G0X35.575Y150.000
+M3S1000
+G4P0.070
+G1Y151.800
+X36.450
+X36.725Y151.500
+Y151.200
+X36.450Y150.900
+X35.575
+X35.875
+X36.725Y150.000
+M5
+G4P0.050
+G0X37.300
+M3S1000
+G4P0.070
+G1X37.000Y150.300
+Y151.500
+X37.300Y151.800
+X37.875
+X38.150Y151.500
+Y150.300
+X37.875Y150.000
+X37.300
+M5
+G4P0.050
+G0X38.425Y151.800
+M3S1000
+G4P0.070
+G1Y150.000
+X39.000Y150.900
+X39.575Y150.000
+Y151.800
+M5
+G4P0.050
+G0X41.275Y150.300
+M3S1000
+G4P0.070
+G1X41.575Y150.000
+X42.150
+X42.425Y150.300
+Y151.500
+X42.150Y151.800
+X41.575
+X41.275Y151.500
+Y150.300
+M5
+G4P0.050
+G0X42.425Y150.000
+X12.500Y135.000
+X12.775Y136.800
+M3S1000
+G4P0.070
+G1Y135.000
+X13.925
+M5
+G4P0.050
+G0X14.200
+M3S1000
+G4P0.070
+G1X15.350
+M5
+G4P0.050
+G0X14.775
+M3S1000
+G4P0.070
+G1Y136.800
+M5
+G4P0.050
+G0X14.200
+M3S1000
+G4P0.070
+G1X15.350
+M5
+G4P0.050
+G0X15.625Y135.000
+M3S1000
+G4P0.070
+G1Y136.800
+X16.775
+M5
+G4P0.050
+G0X15.625Y135.900
+M3S1000
+G4P0.070
+G1X16.500
+M5
+G4P0.050
+G0X17.625Y135.000
+M3S1000
+G4P0.070
+G1Y136.800
+X17.050
+X18.200
+M5
+G4P0.050
+G0X19.900Y135.000
+M3S1000
+G4P0.070
+G1Y136.800
+M5
+G4P0.050
+G0X21.050Y135.000
+M3S1000
+G4P0.070
+G1Y136.800
+M5
+G4P0.050
+G0X19.900Y135.900
+M3S1000
+G4P0.070
+G1X21.050
+M5
+G4P0.050
+G0X22.475Y135.000
+M3S1000
+G4P0.070
+G1X21.325
+Y136.800
+X22.475
+M5
+G4P0.050
+G0X21.325Y135.900
+M3S1000
+G4P0.070
+G1X22.200
+M5
+G4P0.050
+G0X22.750Y135.000
+M3S1000
+G4P0.070
+G1Y136.500
+X23.050Y136.800
+X23.625
+X23.900Y136.500
+Y135.000
+M5
+G4P0.050
+G0X22.750Y135.600
+M3S1000
+G4P0.070
+G1X23.900
+M5
+G4P0.050
+G0X24.175Y136.800
+M3S1000
+G4P0.070
+G1Y136.200
+X24.750Y135.000
+X25.325Y136.200
+Y136.800
+M5
+G4P0.050
+G0X25.600
+M3S1000
+G4P0.070
+G1Y136.500
+X26.175Y135.600
+Y135.000
+M5
+G4P0.050
+G0Y135.600
+M3S1000
+G4P0.070
+G1X26.750Y136.500
+Y136.800
+M5
+G4P0.050
+G0X28.450Y135.000
+M3S1000
+G4P0.070
+G1Y136.800
+X29.325
+X29.600Y136.500
+Y136.200
+X29.325Y135.900
+X28.450
+M5
+G4P0.050
+G0X29.875Y136.800
+M3S1000
+G4P0.070
+G1Y135.000
+X31.025
+M5
+G4P0.050
+G0X31.600
+M3S1000
+G4P0.070
+G1X31.300Y135.300
+Y136.500
+X31.600Y136.800
+X32.175
+X32.450Y136.500
+Y135.300
+X32.175Y135.000
+X31.600
+M5
+G4P0.050
+G0X33.300
+M3S1000
+G4P0.070
+G1Y136.800
+X32.725
+X33.875
+M5
+G4P0.050
+G0X35.575Y135.000
+M3S1000
+G4P0.070
+G1Y136.800
+X36.450
+X36.725Y136.500
+Y136.200
+X36.450Y135.900
+X35.575
+X35.875
+X36.725Y135.000
+M5
+G4P0.050
+G0X37.300
+M3S1000
+G4P0.070
+G1X37.000Y135.300
+Y136.500
+X37.300Y136.800
+X37.875
+X38.150Y136.500
+Y135.300
+X37.875Y135.000
+X37.300
+M5
+G4P0.050
+G0X38.425Y136.800
+M3S1000
+G4P0.070
+G1Y135.000
+X39.000Y135.900
+X39.575Y135.000
+Y136.800
+M5
+G4P0.050
+G0X41.575Y135.000
+M3S1000
+G4P0.070
+G1X42.150
+M5
+G4P0.050
+G0X41.850
+M3S1000
+G4P0.070
+G1Y136.800
+X41.575Y136.500
+M5
+G4P0.050
+G0X42.425Y135.000
+X12.500Y120.000
+X12.775Y121.800
+M3S1000
+G4P0.070
+G1Y120.000
+X13.925
+M5
+G4P0.050
+G0X14.200
+M3S1000
+G4P0.070
+G1X15.350
+M5
+G4P0.050
+G0X14.775
+M3S1000
+G4P0.070
+G1Y121.800
+M5
+G4P0.050
+G0X14.200
+M3S1000
+G4P0.070
+G1X15.350
+M5
+G4P0.050
+G0X15.625Y120.000
+M3S1000
+G4P0.070
+G1Y121.800
+X16.775
+M5
+G4P0.050
+G0X15.625Y120.900
+M3S1000
+G4P0.070
+G1X16.500
+M5
+G4P0.050
+G0X17.625Y120.000
+M3S1000
+G4P0.070
+G1Y121.800
+X17.050
+X18.200
+M5
+G4P0.050
+G0X19.900Y120.000
+M3S1000
+G4P0.070
+G1Y121.800
+M5
+G4P0.050
+G0X21.050Y120.000
+M3S1000
+G4P0.070
+G1Y121.800
+M5
+G4P0.050
+G0X19.900Y120.900
+M3S1000
+G4P0.070
+G1X21.050
+M5
+G4P0.050
+G0X22.475Y120.000
+M3S1000
+G4P0.070
+G1X21.325
+Y121.800
+X22.475
+M5
+G4P0.050
+G0X21.325Y120.900
+M3S1000
+G4P0.070
+G1X22.200
+M5
+G4P0.050
+G0X22.750Y120.000
+M3S1000
+G4P0.070
+G1Y121.500
+X23.050Y121.800
+X23.625
+X23.900Y121.500
+Y120.000
+M5
+G4P0.050
+G0X22.750Y120.600
+M3S1000
+G4P0.070
+G1X23.900
+M5
+G4P0.050
+G0X24.175Y121.800
+M3S1000
+G4P0.070
+G1Y121.200
+X24.750Y120.000
+X25.325Y121.200
+Y121.800
+M5
+G4P0.050
+G0X25.600
+M3S1000
+G4P0.070
+G1Y121.500
+X26.175Y120.600
+Y120.000
+M5
+G4P0.050
+G0Y120.600
+M3S1000
+G4P0.070
+G1X26.750Y121.500
+Y121.800
+M5
+G4P0.050
+G0X28.450Y120.000
+M3S1000
+G4P0.070
+G1Y121.800
+X29.325
+X29.600Y121.500
+Y121.200
+X29.325Y120.900
+X28.450
+M5
+G4P0.050
+G0X29.875Y121.800
+M3S1000
+G4P0.070
+G1Y120.000
+X31.025
+M5
+G4P0.050
+G0X31.600
+M3S1000
+G4P0.070
+G1X31.300Y120.300
+Y121.500
+X31.600Y121.800
+X32.175
+X32.450Y121.500
+Y120.300
+X32.175Y120.000
+X31.600
+M5
+G4P0.050
+G0X33.300
+M3S1000
+G4P0.070
+G1Y121.800
+X32.725
+X33.875
+M5
+G4P0.050
+G0X35.575Y120.000
+M3S1000
+G4P0.070
+G1Y121.800
+X36.450
+X36.725Y121.500
+Y121.200
+X36.450Y120.900
+X35.575
+X35.875
+X36.725Y120.000
+M5
+G4P0.050
+G0X37.300
+M3S1000
+G4P0.070
+G1X37.000Y120.300
+Y121.500
+X37.300Y121.800
+X37.875
+X38.150Y121.500
+Y120.300
+X37.875Y120.000
+X37.300
+M5
+G4P0.050
+G0X38.425Y121.800
+M3S1000
+G4P0.070
+G1Y120.000
+X39.000Y120.900
+X39.575Y120.000
+Y121.800
+M5
+G4P0.050
+G0X41.275Y121.500
+M3S1000
+G4P0.070
+G1X41.575Y121.800
+X42.150
+X42.425Y121.500
+Y121.200
+X41.275Y120.300
+Y120.000
+X42.425
+M5
+G4P0.050
+G0X12.500Y12.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y14.000
+M5
+G4P0.050
+G0X47.500Y12.500
+M3S1000
+G4P0.070
+G1X55.000Y15.500
+M5
+G4P0.050
+G0X65.000Y12.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y14.000
+M5
+G4P0.050
+G0X100.000Y12.500
+M3S1000
+G4P0.070
+G1X107.500Y15.500
+M5
+G4P0.050
+G0X117.500Y12.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y14.000
+M5
+G4P0.050
+G0X152.500Y12.500
+M3S1000
+G4P0.070
+G1X160.000Y15.500
+M5
+G4P0.050
+G0X170.000Y12.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y14.000
+M5
+G4P0.050
+G0X205.000Y12.500
+M3S1000
+G4P0.070
+G1X212.500Y15.500
+M5
+G4P0.050
+G0X12.500Y22.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y24.000
+M5
+G4P0.050
+G0X47.500Y22.500
+M3S1000
+G4P0.070
+G1X55.000Y25.500
+M5
+G4P0.050
+G0X65.000Y22.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y24.000
+M5
+G4P0.050
+G0X100.000Y22.500
+M3S1000
+G4P0.070
+G1X107.500Y25.500
+M5
+G4P0.050
+G0X117.500Y22.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y24.000
+M5
+G4P0.050
+G0X152.500Y22.500
+M3S1000
+G4P0.070
+G1X160.000Y25.500
+M5
+G4P0.050
+G0X170.000Y22.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y24.000
+M5
+G4P0.050
+G0X205.000Y22.500
+M3S1000
+G4P0.070
+G1X212.500Y25.500
+M5
+G4P0.050
+G0X12.500Y32.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y34.000
+M5
+G4P0.050
+G0X47.500Y32.500
+M3S1000
+G4P0.070
+G1X55.000Y35.500
+M5
+G4P0.050
+G0X65.000Y32.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y34.000
+M5
+G4P0.050
+G0X100.000Y32.500
+M3S1000
+G4P0.070
+G1X107.500Y35.500
+M5
+G4P0.050
+G0X117.500Y32.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y34.000
+M5
+G4P0.050
+G0X152.500Y32.500
+M3S1000
+G4P0.070
+G1X160.000Y35.500
+M5
+G4P0.050
+G0X170.000Y32.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y34.000
+M5
+G4P0.050
+G0X205.000Y32.500
+M3S1000
+G4P0.070
+G1X212.500Y35.500
+M5
+G4P0.050
+G0X12.500Y42.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y44.000
+M5
+G4P0.050
+G0X47.500Y42.500
+M3S1000
+G4P0.070
+G1X55.000Y45.500
+M5
+G4P0.050
+G0X65.000Y42.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y44.000
+M5
+G4P0.050
+G0X100.000Y42.500
+M3S1000
+G4P0.070
+G1X107.500Y45.500
+M5
+G4P0.050
+G0X117.500Y42.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y44.000
+M5
+G4P0.050
+G0X152.500Y42.500
+M3S1000
+G4P0.070
+G1X160.000Y45.500
+M5
+G4P0.050
+G0X170.000Y42.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y44.000
+M5
+G4P0.050
+G0X205.000Y42.500
+M3S1000
+G4P0.070
+G1X212.500Y45.500
+M5
+G4P0.050
+G0X12.500Y52.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y54.000
+M5
+G4P0.050
+G0X47.500Y52.500
+M3S1000
+G4P0.070
+G1X55.000Y55.500
+M5
+G4P0.050
+G0X65.000Y52.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y54.000
+M5
+G4P0.050
+G0X100.000Y52.500
+M3S1000
+G4P0.070
+G1X107.500Y55.500
+M5
+G4P0.050
+G0X117.500Y52.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y54.000
+M5
+G4P0.050
+G0X152.500Y52.500
+M3S1000
+G4P0.070
+G1X160.000Y55.500
+M5
+G4P0.050
+G0X170.000Y52.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y54.000
+M5
+G4P0.050
+G0X205.000Y52.500
+M3S1000
+G4P0.070
+G1X212.500Y55.500
+M5
+G4P0.050
+G0X12.500Y62.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y64.000
+M5
+G4P0.050
+G0X47.500Y62.500
+M3S1000
+G4P0.070
+G1X55.000Y65.500
+M5
+G4P0.050
+G0X65.000Y62.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y64.000
+M5
+G4P0.050
+G0X100.000Y62.500
+M3S1000
+G4P0.070
+G1X107.500Y65.500
+M5
+G4P0.050
+G0X117.500Y62.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y64.000
+M5
+G4P0.050
+G0X152.500Y62.500
+M3S1000
+G4P0.070
+G1X160.000Y65.500
+M5
+G4P0.050
+G0X170.000Y62.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y64.000
+M5
+G4P0.050
+G0X205.000Y62.500
+M3S1000
+G4P0.070
+G1X212.500Y65.500
+M5
+G4P0.050
+G0X12.500Y72.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y74.000
+M5
+G4P0.050
+G0X47.500Y72.500
+M3S1000
+G4P0.070
+G1X55.000Y75.500
+M5
+G4P0.050
+G0X65.000Y72.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y74.000
+M5
+G4P0.050
+G0X100.000Y72.500
+M3S1000
+G4P0.070
+G1X107.500Y75.500
+M5
+G4P0.050
+G0X117.500Y72.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y74.000
+M5
+G4P0.050
+G0X152.500Y72.500
+M3S1000
+G4P0.070
+G1X160.000Y75.500
+M5
+G4P0.050
+G0X170.000Y72.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y74.000
+M5
+G4P0.050
+G0X205.000Y72.500
+M3S1000
+G4P0.070
+G1X212.500Y75.500
+M5
+G4P0.050
+G0X12.500Y82.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y84.000
+M5
+G4P0.050
+G0X47.500Y82.500
+M3S1000
+G4P0.070
+G1X55.000Y85.500
+M5
+G4P0.050
+G0X65.000Y82.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y84.000
+M5
+G4P0.050
+G0X100.000Y82.500
+M3S1000
+G4P0.070
+G1X107.500Y85.500
+M5
+G4P0.050
+G0X117.500Y82.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y84.000
+M5
+G4P0.050
+G0X152.500Y82.500
+M3S1000
+G4P0.070
+G1X160.000Y85.500
+M5
+G4P0.050
+G0X170.000Y82.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y84.000
+M5
+G4P0.050
+G0X205.000Y82.500
+M3S1000
+G4P0.070
+G1X212.500Y85.500
+M5
+G4P0.050
+G0X12.500Y92.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y94.000
+M5
+G4P0.050
+G0X47.500Y92.500
+M3S1000
+G4P0.070
+G1X55.000Y95.500
+M5
+G4P0.050
+G0X65.000Y92.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y94.000
+M5
+G4P0.050
+G0X100.000Y92.500
+M3S1000
+G4P0.070
+G1X107.500Y95.500
+M5
+G4P0.050
+G0X117.500Y92.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y94.000
+M5
+G4P0.050
+G0X152.500Y92.500
+M3S1000
+G4P0.070
+G1X160.000Y95.500
+M5
+G4P0.050
+G0X170.000Y92.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y94.000
+M5
+G4P0.050
+G0X205.000Y92.500
+M3S1000
+G4P0.070
+G1X212.500Y95.500
+M5
+G4P0.050
+G0X12.500Y102.500
+M3S1000
+G4P0.070
+G1X20.000
+M5
+G4P0.050
+G0X30.000
+M3S1000
+G4P0.070
+G1X37.500Y104.000
+M5
+G4P0.050
+G0X47.500Y102.500
+M3S1000
+G4P0.070
+G1X55.000Y105.500
+M5
+G4P0.050
+G0X65.000Y102.500
+M3S1000
+G4P0.070
+G1X72.500
+M5
+G4P0.050
+G0X82.500
+M3S1000
+G4P0.070
+G1X90.000Y104.000
+M5
+G4P0.050
+G0X100.000Y102.500
+M3S1000
+G4P0.070
+G1X107.500Y105.500
+M5
+G4P0.050
+G0X117.500Y102.500
+M3S1000
+G4P0.070
+G1X125.000
+M5
+G4P0.050
+G0X135.000
+M3S1000
+G4P0.070
+G1X142.500Y104.000
+M5
+G4P0.050
+G0X152.500Y102.500
+M3S1000
+G4P0.070
+G1X160.000Y105.500
+M5
+G4P0.050
+G0X170.000Y102.500
+M3S1000
+G4P0.070
+G1X177.500
+M5
+G4P0.050
+G0X187.500
+M3S1000
+G4P0.070
+G1X195.000Y104.000
+M5
+G4P0.050
+G0X205.000Y102.500
+M3S1000
+G4P0.070
+G1X212.500Y105.500
+X5.000Y5.000
+X10.000Y10.000
+M5
+G4P0.050
+M2
@@ -0,0 +1,376 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+X25.000Y25.000
+M3S1000
+G4P0.070
+G1X28.375F1000
+M5
+G4P0.050
+X31.725
+M3S1000
+G4P0.070
+X35.100
+M5
+G4P0.050
+X38.475
+M3S1000
+G4P0.070
+X41.850
+M5
+G4P0.050
+X45.200
+M3S1000
+G4P0.070
+X48.575
+M5
+G4P0.050
+X50.000
+Y26.950
+M3S1000
+G4P0.070
+Y30.300
+M5
+G4P0.050
+Y33.675
+M3S1000
+G4P0.070
+Y37.050
+M5
+G4P0.050
+Y37.500
+G0X75.000Y75.000
+M3S1000
+G4P0.070
+G1X85.775
+M5
+G4P0.050
+X87.125
+M3S1000
+G4P0.070
+M5
+G4P0.050
+X88.475
+M3S1000
+G4P0.070
+X90.000
+M5
+G4P0.050
+G0X2.500Y2.500
+M3S1000
+G4P0.070
+M5
+G4P0.050
+G1X5.000
+M3S1000
+G4P0.070
+M5
+G4P0.050
+X7.500Y5.000
+M3S1000
+G4P0.070
+M5
+G4P0.050
+G0X100.000Y100.000
+M3S1000
+G4P0.070
+G1X101.500Y100.750
+M5
+G4P0.050
+X101.800Y100.900
+M3S1000
+G4P0.070
+X102.100Y101.050
+M5
+G4P0.050
+X102.400Y101.200
+M3S1000
+G4P0.070
+X102.700Y101.350
+M5
+G4P0.050
+X103.000Y101.500
+M3S1000
+G4P0.070
+X104.525Y102.250
+M5
+G4P0.050
+X104.825Y102.400
+M3S1000
+G4P0.070
+X105.125Y102.550
+M5
+G4P0.050
+X105.425Y102.700
+M3S1000
+G4P0.070
+X105.725Y102.850
+M5
+G4P0.050
+X106.025Y103.000
+M3S1000
+G4P0.070
+X107.525Y103.775
+M5
+G4P0.050
+X107.825Y103.925
+M3S1000
+G4P0.070
+X108.125Y104.075
+M5
+G4P0.050
+X108.425Y104.225
+M3S1000
+G4P0.070
+X108.725Y104.375
+M5
+G4P0.050
+X109.025Y104.525
+M3S1000
+G4P0.070
+X110.550Y105.275
+M5
+G4P0.050
+X110.850Y105.425
+M3S1000
+G4P0.070
+X111.150Y105.575
+M5
+G4P0.050
+X111.450Y105.725
+M3S1000
+G4P0.070
+X111.750Y105.875
+M5
+G4P0.050
+X112.050Y106.025
+M3S1000
+G4P0.070
+X113.550Y106.775
+M5
+G4P0.050
+X113.850Y106.925
+M3S1000
+G4P0.070
+X114.150Y107.075
+M5
+G4P0.050
+X114.450Y107.225
+M3S1000
+G4P0.070
+X114.750Y107.375
+M5
+G4P0.050
+X115.050Y107.525
+M3S1000
+G4P0.070
+X116.575Y108.275
+M5
+G4P0.050
+X116.875Y108.425
+M3S1000
+G4P0.070
+X117.175Y108.575
+M5
+G4P0.050
+X117.475Y108.725
+M3S1000
+G4P0.070
+X117.775Y108.875
+M5
+G4P0.050
+X118.075Y109.025
+M3S1000
+G4P0.070
+X119.575Y109.800
+M5
+G4P0.050
+X119.875Y109.950
+M3S1000
+G4P0.070
+X120.175Y110.100
+M5
+G4P0.050
+X120.475Y110.250
+M3S1000
+G4P0.070
+X120.775Y110.400
+M5
+G4P0.050
+X121.075Y110.550
+M3S1000
+G4P0.070
+X122.600Y111.300
+M5
+G4P0.050
+X122.900Y111.450
+M3S1000
+G4P0.070
+X123.200Y111.600
+M5
+G4P0.050
+X123.500Y111.750
+M3S1000
+G4P0.070
+X123.800Y111.900
+M5
+G4P0.050
+X124.100Y112.050
+M3S1000
+G4P0.070
+X125.600Y112.800
+M5
+G4P0.050
+X125.900Y112.950
+M3S1000
+G4P0.070
+X126.200Y113.100
+M5
+G4P0.050
+X126.500Y113.250
+M3S1000
+G4P0.070
+X126.800Y113.400
+M5
+G4P0.050
+X127.100Y113.550
+M3S1000
+G4P0.070
+X128.625Y114.300
+M5
+G4P0.050
+X128.925Y114.450
+M3S1000
+G4P0.070
+X129.225Y114.600
+M5
+G4P0.050
+X129.525Y114.750
+M3S1000
+G4P0.070
+X129.825Y114.900
+M5
+G4P0.050
+X130.125Y115.050
+M3S1000
+G4P0.070
+X131.625Y115.825
+M5
+G4P0.050
+X131.925Y115.975
+M3S1000
+G4P0.070
+X132.225Y116.125
+M5
+G4P0.050
+X132.525Y116.275
+M3S1000
+G4P0.070
+X132.825Y116.425
+M5
+G4P0.050
+X133.125Y116.575
+M3S1000
+G4P0.070
+X134.650Y117.325
+M5
+G4P0.050
+X134.950Y117.475
+M3S1000
+G4P0.070
+X135.250Y117.625
+M5
+G4P0.050
+X135.550Y117.775
+M3S1000
+G4P0.070
+X135.850Y117.925
+M5
+G4P0.050
+X136.150Y118.075
+M3S1000
+G4P0.070
+X137.650Y118.825
+M5
+G4P0.050
+X137.950Y118.975
+M3S1000
+G4P0.070
+X138.250Y119.125
+M5
+G4P0.050
+X138.550Y119.275
+M3S1000
+G4P0.070
+X138.850Y119.425
+M5
+G4P0.050
+X139.150Y119.575
+M3S1000
+G4P0.070
+X140.675Y120.325
+M5
+G4P0.050
+X140.975Y120.475
+M3S1000
+G4P0.070
+X141.275Y120.625
+M5
+G4P0.050
+X141.575Y120.775
+M3S1000
+G4P0.070
+X141.875Y120.925
+M5
+G4P0.050
+X142.175Y121.075
+M3S1000
+G4P0.070
+X143.675Y121.850
+M5
+G4P0.050
+X143.975Y122.000
+M3S1000
+G4P0.070
+X144.275Y122.150
+M5
+G4P0.050
+X144.575Y122.300
+M3S1000
+G4P0.070
+X144.875Y122.450
+M5
+G4P0.050
+X145.175Y122.600
+M3S1000
+G4P0.070
+X146.700Y123.350
+M5
+G4P0.050
+X147.000Y123.500
+M3S1000
+G4P0.070
+X147.300Y123.650
+M5
+G4P0.050
+X147.600Y123.800
+M3S1000
+G4P0.070
+X147.900Y123.950
+M5
+G4P0.050
+X148.200Y124.100
+M3S1000
+G4P0.070
+X149.700Y124.850
+M5
+G4P0.050
+X150.000Y125.000
+G0X0.000Y0.000
+M3S1000
+G4P0.070
+G1X2.500
+M5
+G4P0.050
+M2
@@ -0,0 +1,30 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+M3S1000
+G4P0.070
+G1X25.000F1000
+Y25.000
+X0.000
+Y0.000
+M5
+G4P0.050
+G0X12.500Y12.500
+M3S1000
+G4P0.070
+G1X17.500
+Y17.500
+X12.500
+Y12.500
+M5
+G4P0.050
+G0X50.000Y50.000
+M3S1000
+G4P0.070
+G1X62.500
+Y62.500
+M5
+G4P0.050
+G0X0.000Y0.000
+M2
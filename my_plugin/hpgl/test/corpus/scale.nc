@@ -0,0 +1,26 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+M3S1000
+G4P0.070
+G1X200.000F1000
+Y150.000
+X0.000
+Y0.000
+M5
+G4P0.050
+G0X20.000Y15.000
+M3S1000
+G4P0.070
+G1X20.250Y0.250
+X0.250Y15.000
+M5
+G4P0.050
+G0X0.000Y0.000
+M3S1000
+G4P0.070
+G1X69.000Y48.250
+M5
+G4P0.050
+M2
@@ -0,0 +1,516 @@
+G21G90G17
+M5
+G4P0.050
+G0X0.000Y0.000
+X25.000Y25.000
+X25.250
+M3S1000
+G4P0.070
+G1Y26.500F1000
+M5
+G4P0.050
+G0X26.250Y25.000
+M3S1000
+G4P0.070
+G1Y26.500
+M5
+G4P0.050
+G0X25.250Y25.750
+M3S1000
+G4P0.070
+G1X26.250
+M5
+G4P0.050
+G0X26.500Y25.500
+M3S1000
+G4P0.070
+G1X27.250
+X27.500Y25.750
+X27.250Y26.000
+X26.750
+X26.500Y25.750
+Y25.250
+X26.750Y25.000
+X27.500
+M5
+G4P0.050
+G0X28.000Y26.500
+M3S1000
+G4P0.070
+G1X28.250
+Y25.000
+M5
+G4P0.050
+G0X28.000
+M3S1000
+G4P0.070
+G1X28.500
+M5
+G4P0.050
+G0X29.250Y26.500
+M3S1000
+G4P0.070
+G1X29.500
+Y25.000
+M5
+G4P0.050
+G0X29.250
+M3S1000
+G4P0.070
+G1X29.750
+M5
+G4P0.050
+G0X30.500
+M3S1000
+G4P0.070
+G1X30.250Y25.250
+Y25.750
+X30.500Y26.000
+X30.750
+X31.000Y25.750
+Y25.250
+X30.750Y25.000
+X30.500
+M5
+G4P0.050
+G0X32.000
+M3S1000
+G4P0.070
+G1X31.750
+Y25.250
+X32.000
+Y24.750
+X31.750Y24.500
+M5
+G4P0.050
+G0X34.000Y26.500
+M3S1000
+G4P0.070
+G1Y25.000
+X34.500Y25.750
+X35.000Y25.000
+Y26.500
+M5
+G4P0.050
+G0X35.500Y25.000
+M3S1000
+G4P0.070
+G1X35.250Y25.250
+Y25.750
+X35.500Y26.000
+X35.750
+X36.000Y25.750
+Y25.250
+X35.750Y25.000
+X35.500
+M5
+G4P0.050
+G0X36.500Y26.000
+M3S1000
+G4P0.070
+G1Y25.000
+M5
+G4P0.050
+G0Y25.500
+M3S1000
+G4P0.070
+G1X37.000Y26.000
+X37.250
+M5
+G4P0.050
+G0X38.000Y26.500
+M3S1000
+G4P0.070
+G1X38.250
+Y25.000
+M5
+G4P0.050
+G0X38.000
+M3S1000
+G4P0.070
+G1X38.500
+M5
+G4P0.050
+G0X39.750Y26.500
+M3S1000
+G4P0.070
+G1Y25.000
+X39.250
+X39.000Y25.250
+Y25.750
+X39.250Y26.000
+X39.750
+M5
+G4P0.050
+G0Y25.000
+M3S1000
+G4P0.070
+G1X40.000
+M5
+G4P0.050
+G0X40.750
+M3S1000
+G4P0.070
+G1Y25.250
+M5
+G4P0.050
+G0Y25.500
+M3S1000
+G4P0.070
+G1Y26.500
+M5
+G4P0.050
+G0X41.250Y25.000
+X50.000Y50.000
+Y50.575
+M3S1000
+G4P0.070
+G1X46.400
+Y52.275
+X47.000Y52.850
+X47.600
+X48.200Y52.275
+Y50.575
+Y51.150
+X50.000Y52.850
+M5
+G4P0.050
+G0Y54.000
+M3S1000
+G4P0.070
+G1X49.400Y53.425
+X48.200
+X47.600Y54.000
+Y54.575
+X48.200Y55.125
+X49.400
+X50.000Y54.575
+Y54.000
+M5
+G4P0.050
+G0X46.400Y56.850
+M3S1000
+G4P0.070
+G1X50.000
+Y57.975
+M5
+G4P0.050
+G0X47.600Y56.275
+M3S1000
+G4P0.070
+G1Y57.975
+M5
+G4P0.050
+G0X50.000Y61.400
+M3S1000
+G4P0.070
+G1Y59.700
+X49.400Y59.125
+X48.200
+X47.600Y59.700
+Y60.825
+X50.000
+M5
+G4P0.050
+G0X46.400Y62.550
+M3S1000
+G4P0.070
+G1X50.000
+Y63.675
+M5
+G4P0.050
+G0X47.600Y61.975
+M3S1000
+G4P0.070
+G1Y63.675
+M5
+G4P0.050
+G0X48.800Y64.825
+M3S1000
+G4P0.070
+G1Y66.525
+X48.200Y67.100
+X47.600Y66.525
+Y65.400
+X48.200Y64.825
+X49.400
+X50.000Y65.400
+Y67.100
+M5
+G4P0.050
+G0X46.400Y69.375
+M3S1000
+G4P0.070
+G1X50.000
+Y68.250
+X49.400Y67.675
+X48.200
+X47.600Y68.250
+Y69.375
+M5
+G4P0.050
+G0X50.000
+M3S1000
+G4P0.070
+G1Y69.950
+M5
+G4P0.050
+G0X53.950Y73.800
+X54.350
+M3S1000
+G4P0.070
+G1Y76.125
+X55.525
+X55.925Y75.725
+Y75.350
+X55.525Y74.950
+X54.350
+X54.750
+X55.925Y73.800
+M5
+G4P0.050
+G0X56.325Y74.575
+M3S1000
+G4P0.070
+G1X57.500
+X57.900Y74.950
+X57.500Y75.350
+X56.725
+X56.325Y74.950
+Y74.175
+X56.725Y73.800
+X57.900
+M5
+G4P0.050
+G0X58.700Y76.125
+M3S1000
+G4P0.070
+G1X59.075
+Y73.800
+M5
+G4P0.050
+G0X58.700
+M3S1000
+G4P0.070
+G1X59.475
+M5
+G4P0.050
+G0X61.850
+M3S1000
+G4P0.070
+G1X60.675
+X60.275Y74.175
+Y74.950
+X60.675Y75.350
+X61.450
+Y73.800
+M5
+G4P0.050
+G0X62.650Y76.125
+M3S1000
+G4P0.070
+G1Y73.800
+X63.425
+M5
+G4P0.050
+G0X62.250Y75.350
+M3S1000
+G4P0.070
+G1X63.425
+M5
+G4P0.050
+G0X65.000Y76.125
+M3S1000
+G4P0.070
+G1Y75.725
+M5
+G4P0.050
+G0X64.625Y75.350
+M3S1000
+G4P0.070
+G1X65.000
+Y73.800
+M5
+G4P0.050
+G0X64.625
+M3S1000
+G4P0.070
+G1X65.400
+M5
+G4P0.050
+G0X66.200Y75.350
+M3S1000
+G4P0.070
+G1Y74.575
+X66.975Y73.800
+X67.775Y74.575
+Y75.350
+M5
+G4P0.050
+G0X68.175Y74.575
+M3S1000
+G4P0.070
+G1X69.350
+X69.750Y74.950
+X69.350Y75.350
+X68.575
+X68.175Y74.950
+Y74.175
+X68.575Y73.800
+X69.750
+M5
+G4P0.050
+G0X70.150
+M3S1000
+G4P0.070
+G1Y76.125
+M5
+G4P0.050
+G0X71.725Y73.800
+M3S1000
+G4P0.070
+G1Y76.125
+M5
+G4P0.050
+G0X70.150Y74.950
+M3S1000
+G4P0.070
+G1X71.725
+M5
+G4P0.050
+G0X73.700Y73.800
+M3S1000
+G4P0.070
+G1X72.525
+X72.125Y74.175
+Y74.950
+X72.525Y75.350
+X73.300
+Y73.800
+M5
+G4P0.050
+G0X75.275Y75.350
+M3S1000
+G4P0.070
+G1X74.500
+X74.100Y74.950
+X74.500Y74.575
+X74.875
+X75.275Y74.175
+X74.875Y73.800
+X74.100
+M5
+G4P0.050
+G0X76.075Y76.125
+M3S1000
+G4P0.070
+G1Y73.800
+M5
+G4P0.050
+G0Y75.350
+M3S1000
+G4P0.070
+G1X76.850
+X77.250Y74.950
+Y73.800
+M5
+G4P0.050
+G0X77.650
+X78.050
+M3S1000
+G4P0.070
+G1Y75.725
+X78.450Y76.125
+X79.225
+X79.625Y75.725
+Y73.800
+M5
+G4P0.050
+G0X78.050Y74.575
+M3S1000
+G4P0.070
+G1X79.625
+M5
+G4P0.050
+G0X80.025Y75.725
+M3S1000
+G4P0.070
+G1X80.425
+Y75.350
+X81.600Y73.800
+M5
+G4P0.050
+G0X80.025
+M3S1000
+G4P0.070
+G1X80.800Y74.575
+M5
+G4P0.050
+G0X82.000
+M3S1000
+G4P0.070
+G1X82.775Y74.950
+X83.575
+M5
+G4P0.050
+G0X82.775
+M3S1000
+G4P0.070
+G1Y73.800
+X83.575
+M5
+G4P0.050
+G0X86.350Y74.175
+M3S1000
+G4P0.070
+G1Y74.575
+X86.725Y74.950
+X87.125
+X87.525Y74.575
+Y74.175
+X87.125Y73.800
+X86.725
+X86.350Y74.175
+M5
+G4P0.050
+G0X87.125Y74.950
+M3S1000
+G4P0.070
+G1X87.525Y75.350
+M5
+G4P0.050
+G0X89.500Y74.950
+M3S1000
+G4P0.070
+G1X89.100Y75.350
+X88.325
+X87.925Y74.950
+X88.325Y74.575
+X88.700
+M5
+G4P0.050
+G0X88.325
+M3S1000
+G4P0.070
+G1X87.925Y74.175
+X88.325Y73.800
+X89.100
+X89.500Y74.175
+M5
+G4P0.050
+G0X89.900Y74.575
+M3S1000
+G4P0.070
+G1X90.675Y74.950
+X91.475
+M5
+G4P0.050
+G0X90.675
+M3S1000
+G4P0.070
+G1Y73.800
+X91.475
+M5
+G4P0.050
+G0X93.450
+M2
@@ -0,0 +1,24 @@
+# Run the XON/XOFF handshake simulation with a sender of LATENCY ms against the adaptive watermarks (ADAPTIVE)
+# and the fixed ESC.I/ESC.R thresholds (FIXED) and compare: the adaptive watermarks must not lose characters
+# and must toggle the sender less often. The fixed thresholds may lose characters with a slow host.
+
+function(simulate exe prefix)
+  execute_process(COMMAND ${exe} ${LATENCY} RESULT_VARIABLE result OUTPUT_VARIABLE output OUTPUT_STRIP_TRAILING_WHITESPACE)
+  message(STATUS "${prefix}: ${output}")
+  foreach(key time_ms xoff xon overruns starved_ms)
+    string(REGEX MATCH "${key}=([0-9]+)" match "${output}")
+    set(${prefix}_${key} ${CMAKE_MATCH_1} PARENT_SCOPE)
+  endforeach()
+  set(${prefix}_result ${result} PARENT_SCOPE)
+endfunction()
+
+simulate(${ADAPTIVE} adaptive)
+simulate(${FIXED} fixed)
+
+if(NOT adaptive_result EQUAL 0 OR NOT adaptive_overruns EQUAL 0)
+  message(FATAL_ERROR "adaptive watermarks: ${adaptive_overruns} characters lost with ${LATENCY} ms host latency")
+endif()
+
+if(NOT adaptive_xoff LESS fixed_xoff)
+  message(FATAL_ERROR "adaptive watermarks: ${adaptive_xoff} XOFFs, not fewer than ${fixed_xoff} with fixed thresholds")
+endif()
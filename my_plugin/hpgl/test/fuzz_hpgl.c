@@ -0,0 +1,101 @@
+/*
+
+  fuzz_hpgl.c - libFuzzer target for the HPGL engine
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+The input is run through the parser and the executor (arcs, text, fill, clipping and line types)
+with motion output discarded, as for live input device control instructions and CAN are not passed on.
+
+Built with -fsanitize=fuzzer when the compiler is clang, otherwise a main() is provided that replays
+the files given on the command line so that the corpus can be run as a regression test.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host.h"
+#include "hpgl.h"
+
+int LLVMFuzzerTestOneInput (const uint8_t *data, size_t size)
+{
+    static bool init = false;
+
+    size_t i;
+
+    if(!init) {
+        init = true;
+        host_init();
+    }
+
+    hpgl_set_output(&host_null_output);
+    plotter_init();
+
+    for(i = 0; i < size; i++) {
+        if(data[i] != ASCII_ESC && data[i] != ASCII_CAN)
+            do_stuff((char)data[i]);
+    }
+
+    // Terminate any label or command left open so that the next input starts from a clean parser state.
+    do_stuff(ASCII_ETX);
+    do_stuff(';');
+
+    pen_control(Pen_Up);
+    hpgl_set_output(NULL);
+
+    return 0;
+}
+
+#ifndef HPGL_LIBFUZZER
+
+int main (int argc, char **argv)
+{
+    int i;
+    long len;
+    uint8_t *data;
+    FILE *file;
+
+    for(i = 1; i < argc; i++) {
+
+        if((file = fopen(argv[i], "rb")) == NULL) {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 2;
+        }
+
+        fseek(file, 0, SEEK_END);
+        len = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        data = malloc(len ? len : 1);
+        len = (long)fread(data, 1, len, file);
+        fclose(file);
+
+        LLVMFuzzerTestOneInput(data, (size_t)len);
+        free(data);
+
+        printf("%s: ok\n", argv[i]);
+    }
+
+    return 0;
+}
+
+#endif
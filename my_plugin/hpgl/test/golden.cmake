@@ -0,0 +1,22 @@
+# Convert INPUT to G-code with HOST and compare with the expected output, <INPUT without extension>.nc.
+# With UPDATE set the expected output is replaced instead.
+
+get_filename_component(dir ${INPUT} DIRECTORY)
+get_filename_component(name ${INPUT} NAME_WE)
+set(expected ${dir}/${name}.nc)
+
+execute_process(COMMAND ${HOST} convert ${INPUT} ${OUTPUT} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "conversion of ${INPUT} failed: ${result}")
+endif()
+
+if(UPDATE)
+  configure_file(${OUTPUT} ${expected} COPYONLY)
+  message(STATUS "updated ${expected}")
+  return()
+endif()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT} ${expected} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${OUTPUT} differs from ${expected}")
+endif()
@@ -0,0 +1,225 @@
+/*
+
+  hal.h - host stand-in for the grblHAL core HAL, declares only what the HPGL plugin uses
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _HAL_H_
+#define _HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#define GRBL_BUILD 20250101
+
+#define ISR_CODE
+#define ISR_FUNC(f) f
+
+#define ASCII_ETX   0x03
+#define ASCII_ENQ   0x05
+#define ASCII_ACK   0x06
+#define ASCII_LF    0x0A
+#define ASCII_CAN   0x18
+#define ASCII_ESC   0x1B
+#define ASCII_EOL   "\r\n"
+
+#define SERIAL_NO_DATA  -1
+#define CMD_JOG_CANCEL  0x85
+#define LINE_BUFFER_SIZE 257
+
+#define CAPS(c) ((c >= 'a' && c <= 'z') ? (c & 0x5F) : c)
+#define UNUSED(x) (void)(x)
+#define isintf(x) (truncf(x) == (x))
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#define On  1
+#define Off 0
+
+#define X_AXIS 0
+#define Y_AXIS 1
+#define Z_AXIS 2
+#define N_AXIS 3
+
+#define STATE_IDLE  0
+#define STATE_CYCLE (1 << 3)
+#define STATE_JOG   (1 << 5)
+#define STATE_TOOL_CHANGE (1 << 9)
+
+#define EXEC_MOTION_CANCEL (1 << 6)
+
+typedef uint_fast16_t sys_state_t;
+
+typedef enum {
+    Status_OK = 0,
+    Status_ExpectedCommandLetter = 1,
+    Status_BadNumberFormat = 2,
+    Status_InvalidStatement = 3,
+    Status_IdleError = 8,
+    Status_Overflow = 11,
+    Status_GcodeValueOutOfRange = 27,
+    Status_SettingValueOutOfRange = 34,
+    Status_FileOpenFailed = 82,
+    Status_Unhandled = 253
+} status_code_t;
+
+typedef union {
+    float values[N_AXIS];
+    struct {
+        float x, y, z;
+    };
+} coord_data_t;
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t on  :1,
+                ccw :1;
+    };
+} spindle_state_t;
+
+typedef struct spindle_ptrs spindle_ptrs_t;
+
+struct spindle_ptrs {
+    void (*set_state)(spindle_ptrs_t *spindle, spindle_state_t state, float rpm);
+};
+
+spindle_ptrs_t *spindle_get (uint_fast8_t spindle_num);
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t rts_handshake :1;
+    };
+} io_stream_flags_t;
+
+typedef bool (*enqueue_realtime_command_ptr)(char c);
+typedef void (*stream_write_ptr)(const char *s);
+typedef int16_t (*stream_read_ptr)(void);
+typedef uint16_t (*get_stream_buffer_count_ptr)(void);
+
+typedef struct {
+    stream_read_ptr read;
+    stream_write_ptr write;
+    stream_write_ptr write_all;
+    bool (*write_char)(const char c);
+    get_stream_buffer_count_ptr get_rx_buffer_free;
+    get_stream_buffer_count_ptr get_rx_buffer_count;
+    enqueue_realtime_command_ptr (*set_enqueue_rt_handler)(enqueue_realtime_command_ptr handler);
+} io_stream_t;
+
+io_stream_flags_t stream_get_flags (io_stream_t stream);
+
+typedef void (*delay_callback_ptr)(void);
+typedef void (*on_execute_realtime_ptr)(sys_state_t state);
+typedef void (*on_report_options_ptr)(bool newopt);
+typedef void (*on_state_change_ptr)(sys_state_t state);
+
+typedef struct {
+    void (*digital_out)(uint8_t port, bool on);
+} io_port_t;
+
+typedef struct {
+    uint16_t rx_buffer_size;
+    io_stream_t stream;
+    uint32_t (*get_elapsed_ticks)(void);
+    uint32_t (*get_micros)(void);
+    bool (*delay_ms)(uint32_t ms, delay_callback_ptr callback);
+    io_port_t port;
+    struct {
+        void (*memcpy_to_nvs)(uint32_t dest, uint8_t *src, uint32_t size, bool with_checksum);
+        int (*memcpy_from_nvs)(uint8_t *dest, uint32_t source, uint32_t size, bool with_checksum);
+    } nvs;
+} grbl_hal_t;
+
+typedef struct {
+    on_execute_realtime_ptr on_execute_realtime;
+    on_report_options_ptr on_report_options;
+    on_state_change_ptr on_state_change;
+} grbl_t;
+
+extern grbl_hal_t hal;
+extern grbl_t grbl;
+
+typedef struct {
+    float max_travel;
+} axis_settings_t;
+
+typedef struct {
+    axis_settings_t axis[N_AXIS];
+    struct {
+        struct {
+            uint8_t enabled :1;
+        } flags;
+    } homing;
+} settings_t;
+
+extern settings_t settings;
+
+typedef struct {
+    int32_t position[N_AXIS];
+} system_t;
+
+extern system_t sys;
+
+typedef status_code_t (*sys_command_ptr)(sys_state_t state, char *args);
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t noargs         :1,
+                allow_blocking :1;
+    };
+} sysflags_t;
+
+typedef union {
+    const char *str;
+} sys_help_t;
+
+typedef struct {
+    const char *command;
+    sys_command_ptr execute;
+    sysflags_t flags;
+    sys_help_t help;
+} sys_command_t;
+
+typedef struct sys_commands_str {
+    uint8_t n_commands;
+    const sys_command_t *commands;
+    struct sys_commands_str *next;
+} sys_commands_t;
+
+void system_register_commands (sys_commands_t *commands);
+status_code_t system_execute_line (char *line);
+void system_convert_array_steps_to_mpos (float *position, int32_t *steps);
+void system_set_exec_state_flag (uint_fast16_t flag);
+sys_state_t state_get (void);
+
+char *uitoa (uint32_t n);
+char *ftoa (float n, uint8_t decimal_places);
+bool read_float (char *line, uint_fast8_t *char_counter, float *float_ptr);
+void report_plugin (const char *name, const char *version);
+
+#endif
@@ -0,0 +1,43 @@
+/*
+
+  ioports.h - host stand-in for the grblHAL core, declares only what the HPGL plugin uses
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _IOPORTS_H_
+#define _IOPORTS_H_
+
+#include "hal.h"
+
+typedef enum {
+    Port_Analog = 0,
+    Port_Digital
+} io_port_type_t;
+
+typedef enum {
+    Port_Input = 0,
+    Port_Output
+} io_port_direction_t;
+
+bool ioport_can_claim_explicit (void);
+uint8_t ioports_available (io_port_type_t type, io_port_direction_t dir);
+bool ioport_claim (io_port_type_t type, io_port_direction_t dir, uint8_t *port, const char *description);
+
+#endif
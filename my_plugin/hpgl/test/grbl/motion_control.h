@@ -0,0 +1,32 @@
+/*
+
+  motion_control.h - host stand-in for the grblHAL core, declares only what the HPGL plugin uses
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _MOTION_CONTROL_H_
+#define _MOTION_CONTROL_H_
+
+#include "planner.h"
+
+bool mc_line (float *target, plan_line_data_t *pl_data);
+void sync_position (void);
+
+#endif
@@ -0,0 +1,123 @@
+/*
+
+  nvs_buffer.h - host stand-in for the grblHAL core, declares only what the HPGL plugin uses
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _NVS_BUFFER_H_
+#define _NVS_BUFFER_H_
+
+#include "hal.h"
+
+typedef uint32_t nvs_address_t;
+
+enum {
+    NVS_TransferResult_OK = 0
+};
+
+typedef enum {
+    Group_Root = 0,
+    Group_UserSettings = 99
+} setting_group_t;
+
+typedef enum {
+    Setting_UserDefined_0 = 450,
+    Setting_UserDefined_1,
+    Setting_UserDefined_2,
+    Setting_UserDefined_3,
+    Setting_UserDefined_4,
+    Setting_UserDefined_5,
+    Setting_UserDefined_6,
+    Setting_UserDefined_7,
+    Setting_UserDefined_8,
+    Setting_UserDefined_9
+} setting_id_t;
+
+typedef enum {
+    Format_Bool,
+    Format_Bitfield,
+    Format_XBitfield,
+    Format_RadioButtons,
+    Format_AxisMask,
+    Format_Integer,
+    Format_Decimal,
+    Format_String,
+    Format_Password,
+    Format_IPv4,
+    Format_Int8,
+    Format_Int16
+} setting_datatype_t;
+
+typedef enum {
+    Setting_NonCore,
+    Setting_NonCoreFn
+} setting_type_t;
+
+typedef struct {
+    setting_group_t parent;
+    setting_group_t id;
+    const char *name;
+} setting_group_detail_t;
+
+typedef struct {
+    setting_id_t id;
+    setting_group_t group;
+    const char *name;
+    const char *unit;
+    setting_datatype_t datatype;
+    const char *format;
+    const char *min_value;
+    const char *max_value;
+    setting_type_t type;
+    void *value;
+    void *get_value;
+    bool (*is_available)(const void *setting);
+} setting_detail_t;
+
+typedef struct {
+    setting_id_t id;
+    const char *description;
+} setting_descr_t;
+
+typedef union {
+    uint32_t value;
+    struct {
+        uint32_t spindle   :1,
+                 unassigned :31;
+    };
+} settings_changed_flags_t;
+
+typedef struct {
+    uint8_t n_groups;
+    const setting_group_detail_t *groups;
+    uint16_t n_settings;
+    const setting_detail_t *settings;
+    uint16_t n_descriptions;
+    const setting_descr_t *descriptions;
+    void (*on_changed)(settings_t *settings, settings_changed_flags_t changed);
+    void (*save)(void);
+    void (*load)(void);
+    void (*restore)(void);
+} setting_details_t;
+
+nvs_address_t nvs_alloc (size_t size);
+void settings_register (setting_details_t *details);
+
+#endif
@@ -0,0 +1,50 @@
+/*
+
+  planner.h - host stand-in for the grblHAL core, declares only what the HPGL plugin uses
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _PLANNER_H_
+#define _PLANNER_H_
+
+#include "hal.h"
+#include "gcode.h"
+
+typedef union {
+    uint32_t value;
+    struct {
+        uint32_t rapid_motion  :1,
+                 system_motion :1;
+    };
+} planner_cond_t;
+
+typedef struct {
+    float feed_rate;
+    planner_cond_t condition;
+    output_command_t *output_commands;
+} plan_line_data_t;
+
+typedef struct plan_block plan_block_t;
+
+void plan_data_init (plan_line_data_t *plan_data);
+bool plan_check_full_buffer (void);
+plan_block_t *plan_get_current_block (void);
+
+#endif
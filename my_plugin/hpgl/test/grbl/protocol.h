@@ -0,0 +1,34 @@
+/*
+
+  protocol.h - host stand-in for the grblHAL core, declares only what the HPGL plugin uses
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _PROTOCOL_H_
+#define _PROTOCOL_H_
+
+#include "hal.h"
+
+bool protocol_buffer_synchronize (void);
+bool protocol_enqueue_foreground_task (void (*fn)(void *data), void *data);
+bool protocol_execute_realtime (void);
+void protocol_auto_cycle_start (void);
+
+#endif
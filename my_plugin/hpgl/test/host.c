@@ -0,0 +1,489 @@
+/*
+
+  host.c - host build of the HPGL plugin, grblHAL core stand-in
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+Just enough of the core for the plugin to run on a PC: time is simulated and advanced by the realtime
+loop, motion is discarded unless a test installs a hook, the stream is written to host_stream and read
+from a receive buffer filled by host_rx(), the vfs is mapped to stdio. uitoa() and ftoa() share one buffer like the core versions do.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host.h"
+
+#include "grbl/gcode.h"
+#include "grbl/ioports.h"
+#include "grbl/motion_control.h"
+#include "grbl/nvs_buffer.h"
+#include "grbl/protocol.h"
+#include "grbl/report.h"
+#include "grbl/task.h"
+#include "grbl/vfs.h"
+
+grbl_hal_t hal;
+grbl_t grbl;
+settings_t settings;
+system_t sys;
+
+host_hooks_t host = {0};
+uint32_t host_ms = 0;
+FILE *host_stream = NULL;
+
+extern void my_plugin_init (void);
+
+static char buf[20];
+
+char *uitoa (uint32_t n)
+{
+    char *bptr = buf + sizeof(buf);
+
+    *--bptr = '\0';
+
+    do {
+        *--bptr = '0' + n % 10;
+    } while(n /= 10);
+
+    return bptr;
+}
+
+char *ftoa (float n, uint8_t decimal_places)
+{
+    snprintf(buf, sizeof(buf), "%.*f", decimal_places, n);
+
+    return buf;
+}
+
+// Same syntax as the core: optional sign, digits and at most one decimal point. No exponent.
+bool read_float (char *line, uint_fast8_t *char_counter, float *float_ptr)
+{
+    char *ptr = line + *char_counter;
+    bool neg = false, dot = false, digits = false;
+    double value = 0.0, scale = 1.0;
+
+    if(*ptr == '-' || *ptr == '+')
+        neg = *ptr++ == '-';
+
+    for(;; ptr++) {
+        if(*ptr >= '0' && *ptr <= '9') {
+            digits = true;
+            if(dot)
+                value += (*ptr - '0') * (scale *= 0.1);
+            else
+                value = value * 10.0 + (*ptr - '0');
+        } else if(*ptr == '.' && !dot)
+            dot = true;
+        else
+            break;
+    }
+
+    if(digits) {
+        *float_ptr = (float)(neg ? -value : value);
+        *char_counter = (uint_fast8_t)(ptr - line);
+    }
+
+    return digits;
+}
+
+void report_plugin (const char *name, const char *version)
+{
+}
+
+void report_warning (void *message)
+{
+    fprintf(host_stream, "[MSG:Warning: %s]" ASCII_EOL, (char *)message);
+}
+
+// Stream
+
+static void stream_write (const char *s)
+{
+    if(host.write)
+        host.write(s);
+    else
+        fputs(s, host_stream);
+}
+
+static bool stream_write_char (const char c)
+{
+    char s[2] = { c, '\0' };
+
+    stream_write(s);
+
+    return true;
+}
+
+// Receive buffer, filled by host_rx() as by a serial driver ISR.
+static struct {
+    volatile uint_fast16_t head;
+    volatile uint_fast16_t tail;
+    char data[HOST_RX_BUFFER_SIZE];
+} rxbuf = {0};
+
+static enqueue_realtime_command_ptr enqueue_realtime_command = NULL;
+
+bool host_rx (char c)
+{
+    uint_fast16_t next_head = (rxbuf.head + 1) & (HOST_RX_BUFFER_SIZE - 1);
+
+    if(enqueue_realtime_command && enqueue_realtime_command(c))
+        return true;
+
+    if(next_head == rxbuf.tail)
+        return false;
+
+    rxbuf.data[rxbuf.head] = c;
+    rxbuf.head = next_head;
+
+    return true;
+}
+
+static uint16_t stream_rx_free (void)
+{
+    return (HOST_RX_BUFFER_SIZE - 1) - ((rxbuf.head - rxbuf.tail) & (HOST_RX_BUFFER_SIZE - 1));
+}
+
+static uint16_t stream_rx_count (void)
+{
+    return (rxbuf.head - rxbuf.tail) & (HOST_RX_BUFFER_SIZE - 1);
+}
+
+static int16_t stream_read (void)
+{
+    int16_t c;
+
+    if(rxbuf.tail == rxbuf.head)
+        return SERIAL_NO_DATA;
+
+    c = (int16_t)(uint8_t)rxbuf.data[rxbuf.tail];
+    rxbuf.tail = (rxbuf.tail + 1) & (HOST_RX_BUFFER_SIZE - 1);
+
+    return c;
+}
+
+static enqueue_realtime_command_ptr stream_set_enqueue_rt_handler (enqueue_realtime_command_ptr handler)
+{
+    enqueue_realtime_command_ptr prev = enqueue_realtime_command;
+
+    enqueue_realtime_command = handler;
+
+    return prev;
+}
+
+io_stream_flags_t stream_get_flags (io_stream_t stream)
+{
+    io_stream_flags_t flags = {0};
+
+    return flags;
+}
+
+// Time
+
+static uint32_t get_elapsed_ticks (void)
+{
+    return host_ms;
+}
+
+static uint32_t get_micros (void)
+{
+    return host_ms * 1000;
+}
+
+static bool delay_ms (uint32_t ms, delay_callback_ptr callback)
+{
+    while(ms--) {
+        host_ms++;
+        if(host.realtime)
+            host.realtime();
+    }
+
+    if(callback)
+        callback();
+
+    return true;
+}
+
+// NVS, nothing is stored so settings are always restored to defaults.
+
+static void memcpy_to_nvs (uint32_t dest, uint8_t *src, uint32_t size, bool with_checksum)
+{
+}
+
+static int memcpy_from_nvs (uint8_t *dest, uint32_t source, uint32_t size, bool with_checksum)
+{
+    return 1;
+}
+
+nvs_address_t nvs_alloc (size_t size)
+{
+    return 1;
+}
+
+void settings_register (setting_details_t *details)
+{
+    if(details->load)
+        details->load();
+}
+
+// System
+
+void system_register_commands (sys_commands_t *commands)
+{
+}
+
+status_code_t system_execute_line (char *line)
+{
+    return Status_OK;
+}
+
+void system_convert_array_steps_to_mpos (float *position, int32_t *steps)
+{
+    uint_fast8_t idx;
+
+    for(idx = 0; idx < N_AXIS; idx++)
+        position[idx] = 0.0f;
+}
+
+void system_set_exec_state_flag (uint_fast16_t flag)
+{
+}
+
+sys_state_t state_get (void)
+{
+    return STATE_IDLE;
+}
+
+bool task_add_immediate (foreground_task_ptr fn, void *data)
+{
+    fn(data);
+
+    return true;
+}
+
+bool task_run_on_startup (foreground_task_ptr fn, void *data)
+{
+    fn(data);
+
+    return true;
+}
+
+bool protocol_enqueue_foreground_task (void (*fn)(void *data), void *data)
+{
+    fn(data);
+
+    return true;
+}
+
+bool protocol_execute_realtime (void)
+{
+    host_ms++;
+
+    if(host.realtime)
+        host.realtime();
+
+    if(grbl.on_execute_realtime)
+        grbl.on_execute_realtime(state_get());
+
+    return true;
+}
+
+bool protocol_buffer_synchronize (void)
+{
+    return host.buffer_synchronize ? host.buffer_synchronize() : true;
+}
+
+void protocol_auto_cycle_start (void)
+{
+}
+
+status_code_t gc_execute_block (char *block)
+{
+    return host.execute_block ? host.execute_block(block) : Status_OK;
+}
+
+// Motion
+
+void plan_data_init (plan_line_data_t *plan_data)
+{
+    memset(plan_data, 0, sizeof(plan_line_data_t));
+}
+
+bool plan_check_full_buffer (void)
+{
+    return host.check_full_buffer ? host.check_full_buffer() : false;
+}
+
+plan_block_t *plan_get_current_block (void)
+{
+    return host.get_current_block ? host.get_current_block() : NULL;
+}
+
+bool mc_line (float *target, plan_line_data_t *pl_data)
+{
+    return host.mc_line ? host.mc_line(target, pl_data) : true;
+}
+
+void sync_position (void)
+{
+}
+
+// Aux ports
+
+bool ioport_can_claim_explicit (void)
+{
+    return true;
+}
+
+uint8_t ioports_available (io_port_type_t type, io_port_direction_t dir)
+{
+    return type == Port_Digital && dir == Port_Output ? HOST_AUX_OUTPUTS : 0;
+}
+
+bool ioport_claim (io_port_type_t type, io_port_direction_t dir, uint8_t *port, const char *description)
+{
+    return *port < ioports_available(type, dir);
+}
+
+static void digital_out (uint8_t port, bool on)
+{
+    if(host.digital_out)
+        host.digital_out(port, on);
+}
+
+static void spindle_set_state (spindle_ptrs_t *spindle, spindle_state_t state, float rpm)
+{
+    if(host.spindle)
+        host.spindle(state);
+}
+
+spindle_ptrs_t *spindle_get (uint_fast8_t spindle_num)
+{
+    static spindle_ptrs_t spindle = {
+        .set_state = spindle_set_state
+    };
+
+    return &spindle;
+}
+
+// VFS, mapped to stdio.
+
+vfs_file_t *vfs_open (const char *filename, const char *mode)
+{
+    return (vfs_file_t *)fopen(filename, mode);
+}
+
+void vfs_close (vfs_file_t *file)
+{
+    fclose((FILE *)file);
+}
+
+size_t vfs_read (void *buffer, size_t size, size_t n, vfs_file_t *file)
+{
+    return fread(buffer, size, n, (FILE *)file);
+}
+
+size_t vfs_puts (const char *s, vfs_file_t *file)
+{
+    return fputs(s, (FILE *)file) < 0 ? 0 : strlen(s);
+}
+
+// Null motion output
+
+static bool null_move (hpgl_point_t point, bool rapid, float feed_rate)
+{
+    return true;
+}
+
+static void null_pen (pen_status_t state)
+{
+}
+
+static bool null_tool (uint_fast16_t pen)
+{
+    return true;
+}
+
+static void null_sync (void)
+{
+}
+
+const hpgl_output_t host_null_output = {
+    .live = false,
+    .move = null_move,
+    .pen = null_pen,
+    .tool = null_tool,
+    .sync = null_sync
+};
+
+static void execute_realtime (sys_state_t state)
+{
+}
+
+static void state_change (sys_state_t state)
+{
+}
+
+static void report_options (bool newopt)
+{
+}
+
+void host_session_start (void)
+{
+    hpgl_start(STATE_IDLE, NULL);
+
+    // Complete the homing move, the plugin waits for a cycle to end before reading input.
+    grbl.on_execute_realtime(STATE_CYCLE);
+    grbl.on_execute_realtime(STATE_IDLE);
+}
+
+void host_init (void)
+{
+    if(host_stream == NULL)
+        host_stream = stderr;
+
+    hal.rx_buffer_size = HOST_RX_BUFFER_SIZE;
+    hal.stream.read = stream_read;
+    hal.stream.write = stream_write;
+    hal.stream.write_all = stream_write;
+    hal.stream.write_char = stream_write_char;
+    hal.stream.get_rx_buffer_free = stream_rx_free;
+    hal.stream.get_rx_buffer_count = stream_rx_count;
+    hal.stream.set_enqueue_rt_handler = stream_set_enqueue_rt_handler;
+    hal.get_elapsed_ticks = get_elapsed_ticks;
+    hal.get_micros = get_micros;
+    hal.delay_ms = delay_ms;
+    hal.port.digital_out = digital_out;
+    hal.nvs.memcpy_to_nvs = memcpy_to_nvs;
+    hal.nvs.memcpy_from_nvs = memcpy_from_nvs;
+
+    grbl.on_execute_realtime = execute_realtime;
+    grbl.on_state_change = state_change;
+    grbl.on_report_options = report_options;
+
+    settings.axis[X_AXIS].max_travel = 300.0f;
+    settings.axis[Y_AXIS].max_travel = 200.0f;
+
+    my_plugin_init();
+}
@@ -0,0 +1,75 @@
+/*
+
+  host.h - host build of the HPGL plugin, grblHAL core stand-in
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _HOST_H_
+#define _HOST_H_
+
+#include <stdio.h>
+
+#include "grbl/hal.h"
+#include "grbl/planner.h"
+
+#include "motori.h"
+
+/// Core calls that tests may want to observe, NULL for the default (do nothing) behaviour.
+typedef struct {
+    bool (*mc_line)(float *target, plan_line_data_t *pl_data);
+    bool (*buffer_synchronize)(void);
+    bool (*check_full_buffer)(void);
+    plan_block_t *(*get_current_block)(void);
+    void (*spindle)(spindle_state_t state);
+    void (*digital_out)(uint8_t port, bool on);
+    status_code_t (*execute_block)(char *block);
+    void (*realtime)(void);     ///< called once per simulated millisecond, after the clock is advanced
+    void (*write)(const char *s);   ///< stream output, replaces writing to host_stream
+} host_hooks_t;
+
+extern host_hooks_t host;
+
+/// Simulated millisecond clock, advanced by protocol_execute_realtime() and hal.delay_ms().
+extern uint32_t host_ms;
+
+/// Number of digital aux outputs that can be claimed.
+#define HOST_AUX_OUTPUTS 4
+
+/// Size of the stream receive buffer, must be a power of 2.
+#define HOST_RX_BUFFER_SIZE 1024
+
+/// Receives output written to the current stream, defaults to stderr.
+extern FILE *host_stream;
+
+/// Motion output that discards everything, for running the engine without the planner.
+extern const hpgl_output_t host_null_output;
+
+/// Receive a character as the serial driver ISR does, it is offered to the handler set by
+/// hal.stream.set_enqueue_rt_handler() before it is added to the receive buffer.
+/// @returns false on buffer overrun, the character is dropped
+bool host_rx (char c);
+
+/// Start a $HPGL session and complete the homing move so that input is read by the session reader.
+void host_session_start (void);
+
+/// Set up the HAL and register the plugin.
+void host_init (void);
+
+#endif
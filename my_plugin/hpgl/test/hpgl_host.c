@@ -0,0 +1,397 @@
+/*
+
+  hpgl_host.c - command line driver for the host build of the HPGL plugin
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+Usage:
+
+  hpgl_host parse <hpgl file>
+    Run the parser only and output one line per command record.
+
+  hpgl_host convert <hpgl file> <gcode file>
+    Run $HPGL2GCODE, used by the golden corpus tests.
+
+  hpgl_host diff <hpgl file> <reference hpgl_host>
+    Parse the file with this build and with the reference build and compare the command records one by one,
+    the first difference is reported. The reference is typically built from another revision of the plugin
+    by setting HPGL_REFERENCE_DIR when configuring.
+
+  hpgl_host bench [<hpgl file>|-] [<passes>]
+    Report parser, engine and stream ingest throughput, a synthetic plot is used if no file is given or the name is -.
+    Ingest feeds the data through the receive buffer and the $HPGL session reader, stream_get_data(), as a
+    sender with no flow control limits would, and also reports the average number of characters parsed per poll.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "gcode.h"
+#include "hpgl.h"
+
+#include "grbl/protocol.h"
+
+static char *load_file (const char *name, size_t *size)
+{
+    long len;
+    char *data = NULL;
+    FILE *file;
+
+    if((file = fopen(name, "rb"))) {
+        if(fseek(file, 0, SEEK_END) == 0 && (len = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0 &&
+            (data = malloc(len + 1)) && fread(data, 1, len, file) == (size_t)len)
+            *size = (size_t)len;
+        else {
+            free(data);
+            data = NULL;
+        }
+        fclose(file);
+    }
+
+    if(data == NULL)
+        fprintf(stderr, "cannot read %s\n", name);
+
+    return data;
+}
+
+// Deterministic plot with the command mix of a typical CAD export: mostly plot commands,
+// some arcs, circles and labels.
+static uint32_t rnd (uint32_t n)
+{
+    static uint32_t seed = 1;
+
+    seed = seed * 1103515245 + 12345;
+
+    return (seed >> 16) % n;
+}
+
+static char *synthetic_plot (size_t *size)
+{
+    uint32_t i, x, y;
+    size_t len = 0, max = 1 << 20;
+    char *data = malloc(max);
+
+    len += sprintf(data, "IN;SP1;SC0,10000,0,7000;");
+
+    for(i = 0; len < max - 100; i++) {
+        x = rnd(10000);
+        y = rnd(7000);
+        switch(rnd(16)) {
+            case 0:
+                len += sprintf(data + len, "PU;PA%u,%u;CI%u;", x, y, 10 + rnd(500));
+                break;
+            case 1:
+                len += sprintf(data + len, "PD;AA%u,%u,%d;", x, y, (int)rnd(360) - 180);
+                break;
+            case 2:
+                len += sprintf(data + len, "PU%u,%u;LBLabel %u\x03", x, y, i);
+                break;
+            default:
+                len += sprintf(data + len, "PU%u,%u;PD%u,%u", x, y, rnd(10000), rnd(7000));
+                len += sprintf(data + len, ",%u,%u;", rnd(10000), rnd(7000));
+                break;
+        }
+    }
+
+    *size = len;
+
+    return data;
+}
+
+static const char *command_name (hpgl_command_t cmd)
+{
+    static char name[3];
+
+    switch(cmd) {
+        case CMD_CONT:
+            return "CONT";
+        case CMD_ERR:
+            return "ERR";
+        case CMD_LB0:
+            return "LB0";
+        default:
+            name[0] = (char)(cmd >> 8);
+            name[1] = (char)(cmd & 0xFF);
+            name[2] = '\0';
+            return name;
+    }
+}
+
+static void dump_record (FILE *out, uint32_t idx, const hpgl_command_record_t *record)
+{
+    uint_fast8_t i;
+
+    fprintf(out, "%u %s %d,%d %g,%g,%g,%g", idx, command_name(record->cmd), record->target.x, record->target.y,
+             record->param[0], record->param[1], record->param[2], record->param[3]);
+
+    if(record->cmd == CMD_LB) {
+        fputs(" \"", out);
+        for(i = 0; i < record->label_length; i++) {
+            if(record->label[i] >= ' ' && record->label[i] < 0x7F && record->label[i] != '\\' && record->label[i] != '"')
+                fputc(record->label[i], out);
+            else
+                fprintf(out, "\\x%02X", (uint8_t)record->label[i]);
+        }
+        fputc('"', out);
+    }
+
+    fputc('\n', out);
+}
+
+static uint32_t parse (const char *data, size_t size, FILE *out)
+{
+    size_t i;
+    uint32_t n_records = 0;
+    const hpgl_command_record_t *record;
+
+    hpgl_init();
+
+    for(i = 0; i < size; i++) {
+        if((record = hpgl_char(data[i]))) {
+            if(out)
+                dump_record(out, n_records, record);
+            n_records++;
+        }
+    }
+
+    return n_records;
+}
+
+// Run the complete engine: parser, executor, arcs, text, fill and clipping, output is discarded.
+static void execute (const char *data, size_t size)
+{
+    size_t i;
+
+    hpgl_set_output(&host_null_output);
+    plotter_init();
+
+    for(i = 0; i < size; i++) {
+        if(data[i] != ASCII_ESC && data[i] != ASCII_CAN)
+            do_stuff(data[i]);
+    }
+
+    pen_control(Pen_Up);
+    hpgl_set_output(NULL);
+}
+
+// Run a $HPGL session fed through the receive buffer, the buffer is filled between foreground polls.
+// Returns the number of polls.
+static uint32_t ingest (const char *data, size_t size)
+{
+    size_t i = 0;
+    uint32_t polls = 0;
+
+    hpgl_set_output(&host_null_output);
+    host_session_start();
+
+    while(i < size || hal.stream.get_rx_buffer_count()) {
+        while(i < size && hal.stream.get_rx_buffer_free()) {
+            if(data[i] != ASCII_ESC && data[i] != ASCII_CAN)
+                host_rx(data[i]);
+            i++;
+        }
+        hal.stream.read();
+        protocol_execute_realtime();
+        polls++;
+    }
+
+    pen_control(Pen_Up);
+    hpgl_set_output(NULL);
+
+    return polls;
+}
+
+static double now (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static int cmd_parse (const char *name)
+{
+    size_t size;
+    char *data;
+
+    if((data = load_file(name, &size)) == NULL)
+        return 2;
+
+    parse(data, size, stdout);
+    free(data);
+
+    return 0;
+}
+
+static int cmd_convert (const char *in, const char *out)
+{
+    status_code_t status;
+    char *args = malloc(strlen(in) + strlen(out) + 2);
+
+    sprintf(args, "%s,%s", in, out);
+    status = hpgl_to_gcode(STATE_IDLE, args);
+    free(args);
+
+    return status == Status_OK ? 0 : 1;
+}
+
+static int cmd_diff (const char *name, const char *reference)
+{
+    int ret = 0;
+    uint32_t line = 0;
+    size_t size, len_cur = 0, len_ref = 0;
+    ssize_t n_cur, n_ref;
+    char *data, *command, *cur = NULL, *ref = NULL;
+    FILE *current, *ref_out;
+
+    if((data = load_file(name, &size)) == NULL)
+        return 2;
+
+    current = tmpfile();
+    parse(data, size, current);
+    rewind(current);
+    free(data);
+
+    command = malloc(strlen(reference) + strlen(name) + 16);
+    sprintf(command, "'%s' parse '%s'", reference, name);
+    ref_out = popen(command, "r");
+    free(command);
+
+    if(ref_out == NULL) {
+        fprintf(stderr, "cannot run %s\n", reference);
+        return 2;
+    }
+
+    do {
+        n_cur = getline(&cur, &len_cur, current);
+        n_ref = getline(&ref, &len_ref, ref_out);
+        if(n_cur != n_ref || (n_cur > 0 && strcmp(cur, ref))) {
+            printf("%s: command record %u differs\n  current:   %s  reference: %s", name, line,
+                    n_cur > 0 ? cur : "<none>\n", n_ref > 0 ? ref : "<none>\n");
+            ret = 1;
+            break;
+        }
+        line++;
+    } while(n_cur > 0);
+
+    if(ret == 0)
+        printf("%s: %u command records identical\n", name, line - 1);
+
+    if(pclose(ref_out) != 0 && ret == 0)
+        ret = 2;
+
+    fclose(current);
+    free(cur);
+    free(ref);
+
+    return ret;
+}
+
+static int cmd_bench (const char *name, uint32_t passes)
+{
+    int fd;
+    size_t size;
+    uint32_t pass, n_records = 0, polls = 0;
+    double t;
+    FILE *stream = host_stream;
+    char *data = name && strcmp(name, "-") ? load_file(name, &size) : synthetic_plot(&size);
+
+    if(data == NULL)
+        return 2;
+
+    t = now();
+    for(pass = 0; pass < passes; pass++)
+        n_records += parse(data, size, NULL);
+    t = now() - t;
+
+    printf("parser: %zu bytes x %u in %.1f ms, %.0f kB/s, %.0f commands/s\n", size, passes, t * 1000.0,
+            (double)size * passes / t / 1000.0, (double)n_records / t);
+
+    // The text module outputs debug messages with printf(), discard them while timing the engine.
+    fflush(stdout);
+    fd = dup(STDOUT_FILENO);
+    dup2(open("/dev/null", O_WRONLY), STDOUT_FILENO);
+
+    t = now();
+    for(pass = 0; pass < passes; pass++)
+        execute(data, size);
+    t = now() - t;
+
+    fflush(stdout);
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+
+    printf("engine: %zu bytes x %u in %.1f ms, %.0f kB/s\n", size, passes, t * 1000.0, (double)size * passes / t / 1000.0);
+
+    // The session banner is written to the stream, discard it along with the debug messages.
+    fflush(stdout);
+    fd = dup(STDOUT_FILENO);
+    dup2(open("/dev/null", O_WRONLY), STDOUT_FILENO);
+    host_stream = stdout;
+
+    t = now();
+    for(pass = 0; pass < passes; pass++)
+        polls += ingest(data, size);
+    t = now() - t;
+
+    host_stream = stream;
+    fflush(stdout);
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+
+    printf("ingest: %zu bytes x %u in %.1f ms, %.0f kB/s, %.0f chars/s, %.1f chars/poll\n", size, passes, t * 1000.0,
+            (double)size * passes / t / 1000.0, (double)size * passes / t, (double)size * passes / polls);
+
+    free(data);
+
+    return 0;
+}
+
+int main (int argc, char **argv)
+{
+    host_init();
+
+    if(argc == 3 && !strcmp(argv[1], "parse"))
+        return cmd_parse(argv[2]);
+
+    if(argc == 4 && !strcmp(argv[1], "convert"))
+        return cmd_convert(argv[2], argv[3]);
+
+    if(argc == 4 && !strcmp(argv[1], "diff"))
+        return cmd_diff(argv[2], argv[3]);
+
+    if(argc >= 2 && argc <= 4 && !strcmp(argv[1], "bench"))
+        return cmd_bench(argc > 2 ? argv[2] : NULL, argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : 10);
+
+    fprintf(stderr, "usage: %s parse <hpgl file>\n"
+                    "       %s convert <hpgl file> <gcode file>\n"
+                    "       %s diff <hpgl file> <reference hpgl_host>\n"
+                    "       %s bench [<hpgl file>|-] [<passes>]\n", argv[0], argv[0], argv[0], argv[0]);
+
+    return 2;
+}
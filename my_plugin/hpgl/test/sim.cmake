@@ -0,0 +1,34 @@
+# Run the job time simulation of INPUT with the pen driven by the spindle (SPINDLE) and by an aux port (PEN_PORT)
+# and compare: the aux port must be faster, the pen down distance and number of pen changes must match and
+# every pen change must have been made by an output command except the final lift, which is not followed by a move.
+
+function(simulate exe prefix)
+  execute_process(COMMAND ${exe} ${INPUT} RESULT_VARIABLE result OUTPUT_VARIABLE output OUTPUT_STRIP_TRAILING_WHITESPACE)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "simulation with ${exe} failed: ${result}")
+  endif()
+  message(STATUS "${prefix}: ${output}")
+  foreach(key time_ms stopped_ms pen_changes down_mm outputs)
+    string(REGEX MATCH "${key}=([0-9.]+)" match "${output}")
+    set(${prefix}_${key} ${CMAKE_MATCH_1} PARENT_SCOPE)
+  endforeach()
+endfunction()
+
+simulate(${SPINDLE} spindle)
+simulate(${PEN_PORT} pen_port)
+
+math(EXPR saved "100 - 100 * ${pen_port_time_ms} / ${spindle_time_ms}")
+message(STATUS "synchronized pen outputs save ${saved}% of the job time")
+
+if(NOT pen_port_time_ms LESS spindle_time_ms)
+  message(FATAL_ERROR "synchronized pen outputs are not faster")
+endif()
+
+math(EXPR outputs "${pen_port_outputs} + 1")
+if(NOT pen_port_pen_changes EQUAL spindle_pen_changes OR outputs LESS pen_port_pen_changes)
+  message(FATAL_ERROR "pen changes differ: ${spindle_pen_changes} spindle, ${pen_port_pen_changes} aux port, ${pen_port_outputs} outputs")
+endif()
+
+if(NOT pen_port_down_mm STREQUAL spindle_down_mm)
+  message(FATAL_ERROR "pen down distance differs: ${spindle_down_mm} mm spindle, ${pen_port_down_mm} mm aux port")
+endif()
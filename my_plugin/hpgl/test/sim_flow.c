@@ -0,0 +1,252 @@
+/*
+
+  sim_flow.c - XON/XOFF handshake simulation with a PC sender
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+Usage:
+
+  sim_flow <host latency ms> [<baud rate>]
+
+A $HPGL session is fed by a simulated PC sender that configures XON/XOFF handshaking with
+ESC.R, ESC.I81;;17: and ESC.N;19: and then transmits a plot of short vectors at the baud rate,
+default 38400. The sender stops and resumes transmission the given number of milliseconds after
+receiving XOFF and XON, characters are received by the plugin ISR handler via host_rx().
+Motion is executed by a simulated planner so that the parser is slower than the serial line.
+
+The clock is advanced one millisecond per realtime loop iteration. The output is one line of key=value pairs:
+
+  time_ms       total job time
+  xoff          XOFF characters sent by the plugin
+  xon           XON characters sent by the plugin
+  overruns      characters lost to a full receive buffer
+  starved_ms    time with the receive buffer and planner empty while the sender had data
+  flow          the ESC.Q report: received, parsed, throughput, XOFFs, deferred ACKs, latency,
+                max characters after XOFF and the high and low watermarks
+
+The exit code is 1 if characters were lost or the job did not complete.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "host.h"
+
+#include "grbl/protocol.h"
+
+#define SIM_BLOCKS      16          // planner buffer size
+#define SIM_VECTORS     4000        // number of vectors in the plot
+#define SIM_TIMEOUT     600000      // ms
+#define SIM_XON         0x11        // DC1, set by ESC.I
+#define SIM_XOFF        0x13        // DC3, set by ESC.N
+
+static struct {
+    uint_fast8_t head;
+    uint_fast8_t tail;
+    float block_ms[SIM_BLOCKS];
+    float remaining;
+    coord_data_t position;
+} planner;
+
+static struct {
+    const char *data;
+    size_t size;
+    size_t sent;
+    float chars_per_ms;
+    float credit;
+    uint32_t latency;
+    bool stopped;
+    uint32_t toggle_ms;             // time the pending XON/XOFF takes effect
+    bool toggle_pending;
+    bool toggle_stop;
+} sender;
+
+static uint32_t xoff = 0, xon = 0, overruns = 0, starved_ms = 0;
+static char flow_report[128] = "";
+
+static inline uint_fast8_t planner_count (void)
+{
+    return (planner.head + SIM_BLOCKS - planner.tail) % SIM_BLOCKS;
+}
+
+// XON/XOFF received by the sender, acted upon after the host latency.
+static void sim_write (const char *s)
+{
+    if(*s == SIM_XON || *s == SIM_XOFF) {
+        if(*s == SIM_XOFF)
+            xoff++;
+        else
+            xon++;
+        sender.toggle_pending = true;
+        sender.toggle_stop = *s == SIM_XOFF;
+        sender.toggle_ms = host_ms + sender.latency;
+    } else if(strlen(flow_report) + strlen(s) < sizeof(flow_report))
+        strcat(flow_report, s);
+}
+
+// One millisecond of motion and serial transmission.
+static void sim_realtime (void)
+{
+    float ms = 1.0f;
+
+    while(ms > 0.0f && planner_count()) {
+        if(planner.remaining == 0.0f)
+            planner.remaining = planner.block_ms[planner.tail];
+        if(planner.remaining > ms) {
+            planner.remaining -= ms;
+            break;
+        }
+        ms -= planner.remaining;
+        planner.remaining = 0.0f;
+        planner.tail = (planner.tail + 1) % SIM_BLOCKS;
+    }
+
+    if(sender.toggle_pending && host_ms >= sender.toggle_ms) {
+        sender.toggle_pending = false;
+        sender.stopped = sender.toggle_stop;
+    }
+
+    if(sender.sent < sender.size && !sender.stopped) {
+        if(planner_count() == 0 && hal.stream.get_rx_buffer_count() == 0)
+            starved_ms++;
+        sender.credit += sender.chars_per_ms;
+        while(sender.credit >= 1.0f && sender.sent < sender.size) {
+            sender.credit -= 1.0f;
+            if(!host_rx(sender.data[sender.sent++]))
+                overruns++;
+        }
+    } else
+        sender.credit = 0.0f;
+}
+
+static bool sim_mc_line (float *target, plan_line_data_t *pl_data)
+{
+    float length = hypotf(target[X_AXIS] - planner.position.x, target[Y_AXIS] - planner.position.y);
+
+    if(length < 0.001f)
+        return true;
+
+    planner.position.x = target[X_AXIS];
+    planner.position.y = target[Y_AXIS];
+
+    while(planner_count() == SIM_BLOCKS - 1)
+        protocol_execute_realtime();
+
+    planner.block_ms[planner.head] = length * 60000.0f / (pl_data->condition.rapid_motion ? 6000.0f : pl_data->feed_rate);
+    planner.head = (planner.head + 1) % SIM_BLOCKS;
+
+    return true;
+}
+
+static bool sim_check_full_buffer (void)
+{
+    return planner_count() == SIM_BLOCKS - 1;
+}
+
+static bool sim_buffer_synchronize (void)
+{
+    while(planner_count())
+        protocol_execute_realtime();
+
+    return true;
+}
+
+// Short pen down vectors, the parser is limited by the planner.
+static char *plot (size_t *size)
+{
+    uint32_t i, seed = 1;
+    size_t len = 0;
+    char *data = malloc(SIM_VECTORS * 16 + 32);
+
+    len += sprintf(data, "IN;SP1;PA5000,5000;PD;");
+
+    for(i = 0; i < SIM_VECTORS; i++) {
+        seed = seed * 1103515245 + 12345;
+        len += sprintf(data + len, "PR%d,%d;", (int)((seed >> 16) % 16) - 8, (int)((seed >> 8) % 16) - 8);
+    }
+
+    len += sprintf(data + len, "PU;SP0;");
+    *size = len;
+
+    return data;
+}
+
+static void send (const char *s)
+{
+    while(*s)
+        host_rx(*s++);
+}
+
+int main (int argc, char **argv)
+{
+    int fd;
+
+    if(argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <host latency ms> [<baud rate>]\n", argv[0]);
+        return 2;
+    }
+
+    sender.latency = (uint32_t)strtoul(argv[1], NULL, 10);
+    sender.chars_per_ms = (float)(argc > 2 ? strtoul(argv[2], NULL, 10) : 38400) / 10000.0f;
+    sender.data = plot(&sender.size);
+
+    host.mc_line = sim_mc_line;
+    host.check_full_buffer = sim_check_full_buffer;
+    host.buffer_synchronize = sim_buffer_synchronize;
+    host.realtime = sim_realtime;
+
+    host.write = sim_write;
+
+    host_init();
+
+    // The text module outputs debug messages with printf(), discard them while running the job.
+    fflush(stdout);
+    fd = dup(STDOUT_FILENO);
+    dup2(open("/dev/null", O_WRONLY), STDOUT_FILENO);
+
+    hpgl_set_output(NULL);
+    host_session_start();
+
+    send("\x1B.R\x1B.I81;;17:\x1B.N;19:");
+
+    while((sender.sent < sender.size || hal.stream.get_rx_buffer_count() || planner_count()) && host_ms < SIM_TIMEOUT) {
+        hal.stream.read();
+        protocol_execute_realtime();
+    }
+
+    *flow_report = '\0';
+    send("\x1B.Q");
+
+    fflush(stdout);
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+
+    printf("time_ms=%u xoff=%u xon=%u overruns=%u starved_ms=%u flow=%s", host_ms, xoff, xon, overruns, starved_ms, flow_report);
+
+    free((void *)sender.data);
+
+    return overruns || host_ms >= SIM_TIMEOUT ? 1 : 0;
+}
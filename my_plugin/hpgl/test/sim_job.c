@@ -0,0 +1,273 @@
+/*
+
+  sim_job.c - job time simulation of the HPGL planner output
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+Usage:
+
+  sim_job <hpgl file>
+
+Runs the file as a $HPGL session ended by CAN with the planner output and a simulated planner and stepper,
+the clock is advanced one millisecond per realtime loop iteration. Block times are calculated
+from trapezoidal velocity profiles with the junction speed limited by the corner angle, the machine
+decelerates to a stop when the planner buffer runs empty.
+
+The pen is driven by the spindle or, when the plugin is built with HPGL_PEN_PORT, by synchronized
+aux port output commands. The output is one line of key=value pairs:
+
+  time_ms       total job time
+  stopped_ms    time with no block executing
+  pen_changes   number of times the pen was raised or lowered
+  down_mm       distance moved with the pen down
+  outputs       output commands executed by the stepper
+
+The exit code is 1 if the pen is left down.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "host.h"
+
+#include "grbl/protocol.h"
+
+#define SIM_BLOCKS      35          // planner buffer size
+#define SIM_ACCEL       0.001f      // mm/ms^2, 1000 mm/s^2
+#define SIM_RAPID       6000.0f     // mm/min
+
+typedef struct {
+    float dx;
+    float dy;
+    float length;
+    float speed;                    // mm/ms
+    output_command_t *output;
+} sim_block_t;
+
+static struct {
+    uint_fast8_t head;
+    uint_fast8_t tail;
+    sim_block_t block[SIM_BLOCKS];
+    coord_data_t position;
+    bool running;
+    float speed;                    // exit speed of the executing block
+    float remaining;                // ms left of the executing block
+    bool pen_down;
+    uint32_t pen_changes;
+    uint32_t stopped_ms;
+    uint32_t outputs;
+    float down_mm;
+} sim;
+
+static inline uint_fast8_t sim_count (void)
+{
+    return (sim.head + SIM_BLOCKS - sim.tail) % SIM_BLOCKS;
+}
+
+static void sim_pen (bool down)
+{
+    if(sim.pen_down != down) {
+        sim.pen_down = down;
+        sim.pen_changes++;
+    }
+}
+
+static void sim_spindle (spindle_state_t state)
+{
+    sim_pen(state.on);
+}
+
+static void sim_digital_out (uint8_t port, bool on)
+{
+    sim_pen(on);
+}
+
+// Junction speed, full speed for collinear blocks down to zero for reversals.
+static float sim_junction (sim_block_t *from, sim_block_t *to)
+{
+    float cos_theta = (from->dx * to->dx + from->dy * to->dy) / (from->length * to->length);
+
+    return min(from->speed, to->speed) * (1.0f + cos_theta) * 0.5f;
+}
+
+// Time to execute a block with trapezoidal velocity profile.
+static float sim_block_time (float length, float speed, float entry, float exit)
+{
+    float peak = sqrtf((2.0f * SIM_ACCEL * length + entry * entry + exit * exit) * 0.5f), accel_dist, decel_dist;
+
+    peak = max(min(speed, peak), max(entry, exit));
+    accel_dist = (peak * peak - entry * entry) / (2.0f * SIM_ACCEL);
+    decel_dist = (peak * peak - exit * exit) / (2.0f * SIM_ACCEL);
+
+    return (peak - entry) / SIM_ACCEL + (peak - exit) / SIM_ACCEL + max(0.0f, length - accel_dist - decel_dist) / peak;
+}
+
+static void sim_start_block (void)
+{
+    sim_block_t *block = &sim.block[sim.tail];
+    float entry = sim.running ? sim.speed : 0.0f;
+    output_command_t *output = block->output;
+
+    while(output) {
+        output->is_executed = true;
+        if(output->is_digital)
+            hal.port.digital_out(output->port, output->value != 0);
+        sim.outputs++;
+        output = output->next;
+    }
+
+    sim.speed = sim_count() > 1 ? sim_junction(block, &sim.block[(sim.tail + 1) % SIM_BLOCKS]) : 0.0f;
+    sim.remaining = sim_block_time(block->length, block->speed, min(entry, block->speed), min(sim.speed, block->speed));
+    sim.running = true;
+
+    if(sim.pen_down)
+        sim.down_mm += block->length;
+}
+
+// One millisecond of motion.
+static void sim_realtime (void)
+{
+    float ms = 1.0f;
+
+    while(ms > 0.0f) {
+
+        if(!sim.running) {
+            if(sim_count() == 0) {
+                sim.stopped_ms++;
+                break;
+            }
+            sim_start_block();
+        }
+
+        if(sim.remaining > ms) {
+            sim.remaining -= ms;
+            break;
+        }
+
+        ms -= sim.remaining;
+        sim.tail = (sim.tail + 1) % SIM_BLOCKS;
+        sim.running = sim_count() > 0 && sim.speed > 0.0f;
+        if(sim.running)
+            sim_start_block();
+    }
+}
+
+static bool sim_mc_line (float *target, plan_line_data_t *pl_data)
+{
+    sim_block_t *block = &sim.block[sim.head];
+
+    block->dx = target[X_AXIS] - sim.position.x;
+    block->dy = target[Y_AXIS] - sim.position.y;
+    block->length = hypotf(block->dx, block->dy);
+
+    // The planner discards blocks without steps.
+    if(block->length < 0.001f)
+        return true;
+
+    block->speed = (pl_data->condition.rapid_motion ? SIM_RAPID : pl_data->feed_rate) / 60000.0f;
+    block->output = pl_data->output_commands;
+
+    sim.position.x = target[X_AXIS];
+    sim.position.y = target[Y_AXIS];
+
+    while(sim_count() == SIM_BLOCKS - 1)
+        protocol_execute_realtime();
+
+    sim.head = (sim.head + 1) % SIM_BLOCKS;
+
+    return true;
+}
+
+static bool sim_check_full_buffer (void)
+{
+    return sim_count() == SIM_BLOCKS - 1;
+}
+
+static plan_block_t *sim_get_current_block (void)
+{
+    return sim_count() || sim.running ? (plan_block_t *)&sim.block[sim.tail] : NULL;
+}
+
+static bool sim_buffer_synchronize (void)
+{
+    while(sim_count() || sim.running)
+        protocol_execute_realtime();
+
+    return true;
+}
+
+int main (int argc, char **argv)
+{
+    int c, fd;
+    FILE *file;
+
+    if(argc != 2) {
+        fprintf(stderr, "usage: %s <hpgl file>\n", argv[0]);
+        return 2;
+    }
+
+    if((file = fopen(argv[1], "rb")) == NULL) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 2;
+    }
+
+    host.mc_line = sim_mc_line;
+    host.check_full_buffer = sim_check_full_buffer;
+    host.get_current_block = sim_get_current_block;
+    host.buffer_synchronize = sim_buffer_synchronize;
+    host.spindle = sim_spindle;
+    host.digital_out = sim_digital_out;
+    host.realtime = sim_realtime;
+
+    host_init();
+
+    // The text module outputs debug messages with printf(), discard them while running the job.
+    fflush(stdout);
+    fd = dup(STDOUT_FILENO);
+    dup2(open("/dev/null", O_WRONLY), STDOUT_FILENO);
+
+    hpgl_set_output(NULL);
+    hpgl_start(STATE_IDLE, NULL);
+
+    while((c = fgetc(file)) != EOF) {
+        if(c != ASCII_ESC && c != ASCII_CAN)
+            do_stuff((char)c);
+    }
+
+    fclose(file);
+
+    // End the session, the pen must be lifted.
+    do_stuff(ASCII_CAN);
+
+    fflush(stdout);
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+
+    printf("time_ms=%u stopped_ms=%u pen_changes=%u down_mm=%.1f outputs=%u\n",
+            host_ms, sim.stopped_ms, sim.pen_changes, sim.down_mm, sim.outputs);
+
+    return sim.pen_down ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/*
+
+  test_clip.c - input window (IW) clipping tests
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "host.h"
+#include "clip.h"
+#include "config.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) if(!(cond)) { failures++; fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); }
+
+// Recording output, checks that the pen is only lowered and moved while down inside the window.
+static struct {
+    hpgl_point_t pos;
+    bool pen_down;
+    uint32_t pen_downs;
+    uint32_t down_outside;
+    uint32_t draw_outside;
+    uint32_t beyond_limits;
+    hpgl_point_t first_down;
+    hpgl_point_t last_draw;
+} rec;
+
+static bool rec_move (hpgl_point_t point, bool rapid, float feed_rate)
+{
+    if(rec.pen_down && !(clip_inside(rec.pos) && clip_inside(point)))
+        rec.draw_outside++;
+
+    if(point.x > hpgl_settings.max_x || point.y > hpgl_settings.max_y)
+        rec.beyond_limits++;
+
+    if(rec.pen_down)
+        rec.last_draw = point;
+
+    rec.pos = point;
+
+    return true;
+}
+
+static void rec_pen (pen_status_t state)
+{
+    if((rec.pen_down = state == Pen_Down)) {
+        if(rec.pen_downs++ == 0)
+            rec.first_down = rec.pos;
+        if(!clip_inside(rec.pos))
+            rec.down_outside++;
+    }
+}
+
+static bool rec_tool (uint_fast16_t pen)
+{
+    return true;
+}
+
+static void rec_sync (void)
+{
+}
+
+static const hpgl_output_t rec_output = {
+    .live = false,
+    .move = rec_move,
+    .pen = rec_pen,
+    .tool = rec_tool,
+    .sync = rec_sync
+};
+
+static void plot (const char *hpgl)
+{
+    memset(&rec, 0, sizeof(rec));
+
+    hpgl_set_output(&rec_output);
+    plotter_init();
+
+    while(*hpgl)
+        do_stuff(*hpgl++);
+
+    pen_control(Pen_Up);
+    hpgl_set_output(NULL);
+}
+
+// Clipped segments must be inside the window and on the original line, rejected segments must be outside.
+static void test_clip_line (void)
+{
+    uint32_t i, s, bad = 0, clipped = 0;
+    double dx, dy, len, d0, d1;
+    hpgl_point_t p0, p1, a, b;
+
+    hpgl_state.iw_pad[0] = 1000;
+    hpgl_state.iw_pad[1] = 500;
+    hpgl_state.iw_pad[2] = 9000;
+    hpgl_state.iw_pad[3] = 7000;
+    clip_set_window();
+
+    srand(1);
+
+    for(i = 0; i < 200000; i++) {
+
+        a.x = p0.x = rand() % 12000 - 500;
+        a.y = p0.y = rand() % 9000 - 500;
+        b.x = p1.x = rand() % 12000 - 500;
+        b.y = p1.y = rand() % 9000 - 500;
+
+        switch(clip_line(&p0, &p1)) {
+
+            case Clip_Rejected:
+                // Sample the segment, no point may be inside by more than rounding.
+                for(s = 0; s <= 64; s++) {
+                    hpgl_point_t p = { .x = a.x + (b.x - a.x) * (int32_t)s / 64, .y = a.y + (b.y - a.y) * (int32_t)s / 64 };
+                    if(p.x > 1001 && p.x < 8999 && p.y > 501 && p.y < 6999) {
+                        bad++;
+                        break;
+                    }
+                }
+                break;
+
+            case Clip_Accepted:
+                if(p0.x != a.x || p0.y != a.y || p1.x != b.x || p1.y != b.y || !clip_inside(p0) || !clip_inside(p1))
+                    bad++;
+                break;
+
+            case Clip_Clipped:
+                clipped++;
+                dx = b.x - a.x;
+                dy = b.y - a.y;
+                len = hypot(dx, dy);
+                d0 = fabs((p0.x - a.x) * dy - (p0.y - a.y) * dx) / len;
+                d1 = fabs((p1.x - a.x) * dy - (p1.y - a.y) * dx) / len;
+                if(!clip_inside(p0) || !clip_inside(p1) || d0 > 1.0 || d1 > 1.0)
+                    bad++;
+                break;
+        }
+    }
+
+    CHECK(bad == 0, "clip_line: %u of %u segments wrong", bad, i);
+    CHECK(clipped > 0, "clip_line: no segments clipped");
+}
+
+// A pen down line from outside the window: the pen must be lowered at the entry point, not where the
+// pen up move outside the window left off.
+static void test_entry_point (void)
+{
+    plot("IN;SP1;IW1000,1000,5000,4000;PA0,0;PD6000,5000;PU;");
+
+    CHECK(rec.pen_downs == 1, "entry point: %u pen downs, expected 1", rec.pen_downs);
+    CHECK(rec.first_down.x == 1200 && rec.first_down.y == 1000, "entry point: pen lowered at %d,%d, expected 1200,1000", rec.first_down.x, rec.first_down.y);
+    CHECK(rec.last_draw.x == 4800 && rec.last_draw.y == 4000, "entry point: line ends at %d,%d, expected 4800,4000", rec.last_draw.x, rec.last_draw.y);
+    CHECK(rec.down_outside == 0 && rec.draw_outside == 0, "entry point: pen down outside window");
+
+    // PD without coordinates outside the window must not leave a dot.
+    plot("IN;SP1;IW1000,1000,5000,4000;PA0,0;PD;PU;PA2000,2000;PD;PU;");
+
+    CHECK(rec.pen_downs == 1 && rec.first_down.x == 2000 && rec.first_down.y == 2000, "dot: %u pen downs, first at %d,%d", rec.pen_downs, rec.first_down.x, rec.first_down.y);
+}
+
+// Random plots with random windows, line types and arcs.
+static void test_random_plots (void)
+{
+    static const char *const cmds[] = { "PA", "PR", "PD", "PU", "CI", "AA", "AR", "EA", "ER", "LT" };
+
+    char hpgl[2048];
+    uint32_t i, j, len;
+
+    srand(2);
+
+    for(i = 0; i < 500; i++) {
+
+        uint32_t x0 = rand() % 8000, y0 = rand() % 6000;
+
+        len = sprintf(hpgl, "IN;SP1;IW%u,%u,%u,%u;", x0, y0, x0 + 100 + rand() % 5000, y0 + 100 + rand() % 3000);
+
+        for(j = 0; j < 40; j++) {
+            const char *cmd = cmds[rand() % (sizeof(cmds) / sizeof(cmds[0]))];
+            if(!strcmp(cmd, "CI"))
+                len += sprintf(hpgl + len, "CI%u;", 10 + rand() % 2000);
+            else if(!strcmp(cmd, "AA"))
+                len += sprintf(hpgl + len, "AA%u,%u,%d;", rand() % 12000, rand() % 8000, rand() % 360 - 180);
+            else if(!strcmp(cmd, "AR") || !strcmp(cmd, "ER") || !strcmp(cmd, "PR"))
+                len += sprintf(hpgl + len, "%s%d,%d;", cmd, rand() % 4000 - 2000, rand() % 4000 - 2000);
+            else if(!strcmp(cmd, "LT"))
+                len += sprintf(hpgl + len, "LT%u,%u;", rand() % 7, 1 + rand() % 5);
+            else
+                len += sprintf(hpgl + len, "%s%u,%u;", cmd, rand() % 13000, rand() % 9000);
+        }
+
+        plot(hpgl);
+
+        CHECK(rec.down_outside == 0, "random plot %u: pen lowered outside the window %u times\n%s", i, rec.down_outside, hpgl);
+        CHECK(rec.draw_outside == 0, "random plot %u: %u pen down moves outside the window\n%s", i, rec.draw_outside, hpgl);
+        CHECK(rec.beyond_limits == 0, "random plot %u: %u moves beyond the hard-clip limits\n%s", i, rec.beyond_limits, hpgl);
+
+        if(failures)
+            break;
+    }
+}
+
+int main (int argc, char **argv)
+{
+    host_init();
+
+    test_clip_line();
+    test_entry_point();
+    test_random_plots();
+
+    if(failures == 0)
+        printf("all clip tests passed\n");
+
+    return failures ? 1 : 0;
+}
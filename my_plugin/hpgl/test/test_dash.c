@@ -0,0 +1,268 @@
+/*
+
+  test_dash.c - line type (LT) pattern tests
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "host.h"
+#include "dash.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) if(!(cond)) { failures++; fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); }
+
+// Dash and gap percentages from the HP-GL reference, alternating dash and gap.
+static const struct {
+    uint_fast8_t segments;
+    float percent[6];
+} expected[] = {
+    { 2, { 0, 100 } },
+    { 2, { 50, 50 } },
+    { 2, { 70, 30 } },
+    { 4, { 80, 10, 0, 10 } },
+    { 4, { 70, 10, 10, 10 } },
+    { 6, { 50, 10, 10, 10, 10, 10 } }
+};
+
+static float pattern_units (float percent)
+{
+    return hypotf((float)(hpgl_state.ip_pad[2] - hpgl_state.ip_pad[0]), (float)(hpgl_state.ip_pad[3] - hpgl_state.ip_pad[1])) * percent / 100.0f;
+}
+
+static void set_pattern (uint8_t type, float percent)
+{
+    hpgl_state.pattern_type = type;
+    hpgl_state.pattern_length = percent;
+    dash_configure();
+}
+
+// Run horizontal vectors from x = 0 through the given vertices and return the pen down length.
+// Segment lengths are stored in seg[] with the pen state in down[], dots are skipped and consecutive
+// segments with the same pen state are merged.
+static float run (const int32_t *vertex, uint_fast8_t n_vertices, float *seg, bool *down, uint32_t *n_seg)
+{
+    bool pen;
+    uint_fast8_t v;
+    float pen_down = 0.0f;
+    hpgl_point_t from = {0}, to = {0}, point;
+
+    *n_seg = 0;
+
+    for(v = 0; v < n_vertices; v++) {
+        to.x = vertex[v];
+        dash_begin(from, to);
+        while(dash_next(&point, &pen)) {
+            float length = (float)(point.x - from.x);
+            if(length == 0.0f)
+                continue;
+            if(*n_seg && down[*n_seg - 1] == pen)
+                seg[*n_seg - 1] += length;
+            else {
+                down[*n_seg] = pen;
+                seg[(*n_seg)++] = length;
+            }
+            if(pen)
+                pen_down += length;
+            from = point;
+        }
+    }
+
+    return pen_down;
+}
+
+// Dash and gap lengths must match the pattern within rounding, also across vertices.
+static void test_patterns (void)
+{
+    static float seg[2000], exp_seg[2000];
+    static bool down[2000], exp_down[2000];
+
+    static const int32_t single[] = { 10000 };
+    static const int32_t split[] = { 1234, 1235, 4000, 7777, 10000 };
+
+    uint8_t type;
+    uint32_t i, n_seg, n_exp, p;
+    float pen_down, pen_down_split;
+
+    for(type = 2; type <= 6; type++) {
+
+        set_pattern(type, 4.0f);
+        pen_down = run(single, 1, seg, down, &n_seg);
+
+        // Expected segments, zero length dashes (dots) merge with the neighbouring gaps.
+        for(i = 0, p = 0, n_exp = 0; n_exp < n_seg; i++, p = (p + 1) % expected[type - 1].segments) {
+            if(expected[type - 1].percent[p] == 0.0f)
+                continue;
+            if(n_exp && exp_down[n_exp - 1] == !(p & 1))
+                exp_seg[n_exp - 1] += pattern_units(4.0f) * expected[type - 1].percent[p] / 100.0f;
+            else {
+                exp_down[n_exp] = !(p & 1);
+                exp_seg[n_exp++] = pattern_units(4.0f) * expected[type - 1].percent[p] / 100.0f;
+            }
+        }
+
+        // Skip the last segment which is cut by the end of the vector.
+        for(i = 0; i < n_seg - 1; i++) {
+            CHECK(down[i] == exp_down[i] && fabsf(seg[i] - exp_seg[i]) <= 1.0f,
+                   "LT%u: segment %u is %s %.1f units, expected %s %.1f", type, i, down[i] ? "dash" : "gap", seg[i],
+                    exp_down[i] ? "dash" : "gap", exp_seg[i]);
+        }
+
+        // The pattern phase is carried across vertices.
+        dash_restart();
+        pen_down_split = run(split, sizeof(split) / sizeof(split[0]), seg, down, &n_seg);
+        CHECK(fabsf(pen_down - pen_down_split) <= (float)(sizeof(split) / sizeof(split[0])),
+               "LT%u: pen down %.1f units through vertices, %.1f units as one vector", type, pen_down_split, pen_down);
+    }
+}
+
+// Short gaps are plotted with the pen down but at most HPGL_DASH_MERGE_MAX percent of the pattern.
+static void test_merge_bound (void)
+{
+    static float seg[20000];
+    static bool down[20000];
+    static const int32_t line[] = { 10000 };
+
+    uint8_t type;
+    uint32_t n_seg;
+    float pen_down, gaps;
+
+    for(type = 2; type <= 6; type++) {
+
+        // Pattern length 20 units, gaps of 10% are 2 units.
+        set_pattern(type, 20.0f * 100.0f / pattern_units(100.0f));
+        pen_down = run(line, 1, seg, down, &n_seg);
+
+        gaps = 100.0f - (expected[type - 1].percent[0] + expected[type - 1].percent[2] + expected[type - 1].percent[4]);
+
+        CHECK(pen_down <= 10000.0f * (100.0f - gaps + 10.0f) / 100.0f + 20.0f,
+               "LT%u: %.1f%% plotted, more than %.0f%% dashes + 10%% merged gaps", type, pen_down / 100.0f, 100.0f - gaps);
+        CHECK(pen_down < 10000.0f, "LT%u: short pattern plotted as a solid line", type);
+    }
+
+    // Gaps above the threshold are always lifted.
+    set_pattern(6, 4.0f);
+    pen_down = run(line, 1, seg, down, &n_seg);
+    CHECK(fabsf(pen_down - 7000.0f) <= pattern_units(4.0f) * 0.7f, "LT6: %.1f units plotted, expected about 7000", pen_down);
+}
+
+// LT0: a dot at the end of each vector.
+static void test_dots (void)
+{
+    bool pen;
+    hpgl_point_t from = {0}, to = { .x = 500, .y = 300 }, point;
+
+    set_pattern(0, 4.0f);
+
+    dash_begin(from, to);
+
+    CHECK(dash_next(&point, &pen) && !pen && point.x == 500 && point.y == 300, "LT0: expected pen up move to the end point");
+    CHECK(dash_next(&point, &pen) && pen && point.x == 500 && point.y == 300, "LT0: expected a dot at the end point");
+    CHECK(!dash_next(&point, &pen), "LT0: expected end of vector");
+}
+
+// Engine: dashes are plotted with pen down moves only, gaps with the pen raised.
+static struct {
+    bool pen_down;
+    hpgl_point_t pos;
+    uint32_t lifts;
+    float down;
+    float up;
+} rec;
+
+static bool rec_move (hpgl_point_t point, bool rapid, float feed_rate)
+{
+    float length = hypotf((float)(point.x - rec.pos.x), (float)(point.y - rec.pos.y));
+
+    if(rec.pen_down)
+        rec.down += length;
+    else
+        rec.up += length;
+
+    rec.pos = point;
+
+    return true;
+}
+
+static void rec_pen (pen_status_t state)
+{
+    if(rec.pen_down && state != Pen_Down)
+        rec.lifts++;
+
+    rec.pen_down = state == Pen_Down;
+}
+
+static bool rec_tool (uint_fast16_t pen)
+{
+    return true;
+}
+
+static void rec_sync (void)
+{
+}
+
+static const hpgl_output_t rec_output = {
+    .live = false,
+    .move = rec_move,
+    .pen = rec_pen,
+    .tool = rec_tool,
+    .sync = rec_sync
+};
+
+static void test_engine (void)
+{
+    const char *hpgl = "IN;SP1;LT2,4;PA0,0;PD10000,0;PU;";
+    float pattern;
+
+    memset(&rec, 0, sizeof(rec));
+
+    hpgl_set_output(&rec_output);
+    plotter_init();
+
+    while(*hpgl)
+        do_stuff(*hpgl++);
+
+    hpgl_set_output(NULL);
+
+    pattern = pattern_units(4.0f);
+
+    CHECK(fabsf(rec.down - 5000.0f) <= pattern * 0.5f, "engine LT2: %.1f units plotted, expected about 5000", rec.down);
+    CHECK(rec.lifts >= (uint32_t)(10000.0f / pattern), "engine LT2: %u pen lifts, expected at least %u", rec.lifts, (uint32_t)(10000.0f / pattern));
+}
+
+int main (int argc, char **argv)
+{
+    host_init();
+    plotter_init();
+
+    test_patterns();
+    test_merge_bound();
+    test_dots();
+    test_engine();
+
+    if(failures == 0)
+        printf("all dash tests passed\n");
+
+    return failures ? 1 : 0;
+}
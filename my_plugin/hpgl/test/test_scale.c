@@ -0,0 +1,170 @@
+/*
+
+  test_scale.c - equivalence of the user to plotter transforms with the previous divide based code
+
+  Part of grblHAL
+
+  Copyright (c) 2026 Terje Io
+
+  grblHAL is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grblHAL is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grblHAL. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+
+scale.c multiplies by precalculated reciprocals and rounds inline, the previous code divided by the
+scale factors and called roundf(). Float rounding of the reciprocal may move a point that lies close
+to a half unit to the neighbouring plotter coordinate, so the results are required to be within one
+plotter unit of the reference rather than bit-exact. The number of points that differ is reported.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "host.h"
+#include "scale.h"
+#include "config.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) if(!(cond)) { failures++; fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); }
+
+// Reference, the transforms as they were before the reciprocals were introduced.
+
+static user_point_t ref_scale;
+
+static void ref_translate_scale (void)
+{
+    user_point_t iprange = range_P1P2();
+
+    ref_scale.x = iprange.x / (float)(hpgl_state.sc_pad[1] - hpgl_state.sc_pad[0]);
+    ref_scale.y = iprange.y / (float)(hpgl_state.sc_pad[3] - hpgl_state.sc_pad[2]);
+}
+
+static void ref_userscale (user_point_t src, hpgl_point_t *target, user_point_t *out)
+{
+    target->x = (hpgl_coord_t)roundf(src.x * ref_scale.x);
+    target->y = (hpgl_coord_t)roundf(src.y * ref_scale.y);
+
+    out->x = (float)target->x / ref_scale.x;
+    out->y = (float)target->y / ref_scale.y;
+}
+
+static void ref_userscalerelative (user_point_t src, hpgl_point_t *target, user_point_t *out)
+{
+    target->x = (hpgl_coord_t)roundf(out->x + src.x * ref_scale.x);
+    target->y = (hpgl_coord_t)roundf(out->y + src.y * ref_scale.y);
+
+    out->x = (float)target->x / ref_scale.x;
+    out->y = (float)target->y / ref_scale.y;
+}
+
+static void ref_userprescale (user_point_t abs, user_point_t *out)
+{
+    out->x = abs.x / ref_scale.x;
+    out->y = abs.y / ref_scale.y;
+}
+
+static float rnd (float min, float max)
+{
+    return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+static void test_sc (int32_t xmin, int32_t xmax, int32_t ymin, int32_t ymax)
+{
+    uint32_t i, differ = 0, worst = 0;
+    float umin_x, umax_x, umin_y, umax_y, worst_out = 0.0f;
+    hpgl_point_t t, r;
+    user_point_t p, o, ro;
+
+    translate_init_ip();
+    translate_init_sc();
+    hpgl_state.sc_pad[0] = xmin;
+    hpgl_state.sc_pad[1] = xmax;
+    hpgl_state.sc_pad[2] = ymin;
+    hpgl_state.sc_pad[3] = ymax;
+    translate_scale();
+    ref_translate_scale();
+
+    // User coordinates mapping to the plotter range with some margin, plotter coordinates are 16 bit.
+    umin_x = -1000.0f / ref_scale.x;
+    umax_x = 30000.0f / ref_scale.x;
+    umin_y = -1000.0f / ref_scale.y;
+    umax_y = 30000.0f / ref_scale.y;
+
+    for(i = 0; i < 1000000; i++) {
+
+        p.x = rnd(umin_x, umax_x);
+        p.y = rnd(umin_y, umax_y);
+
+        switch(i % 3) {
+
+            case 0:
+                userscale(p, &t, &o);
+                ref_userscale(p, &r, &ro);
+                break;
+
+            case 1:
+                // Relative moves from a random start point, p scaled down to a short distance.
+                o.x = ro.x = rnd(0.0f, 20000.0f);
+                o.y = ro.y = rnd(0.0f, 20000.0f);
+                p.x *= 0.1f;
+                p.y *= 0.1f;
+                userscalerelative(p, &t, &o);
+                ref_userscalerelative(p, &r, &ro);
+                break;
+
+            default:
+                userprescale(p, &o);
+                ref_userprescale(p, &ro);
+                t = r = (hpgl_point_t){0};
+                break;
+        }
+
+        if(t.x != r.x || t.y != r.y)
+            differ++;
+
+        worst = max(worst, (uint32_t)max(abs(t.x - r.x), abs(t.y - r.y)));
+        // Difference of the corrected user position in plotter units.
+        worst_out = fmaxf(worst_out, fmaxf(fabsf(o.x - ro.x) * ref_scale.x, fabsf(o.y - ro.y) * ref_scale.y));
+    }
+
+    printf("SC%d,%d,%d,%d: %u of %u points differ, worst %u unit(s), corrected position %.3f unit(s)\n",
+            xmin, xmax, ymin, ymax, differ, i, worst, worst_out);
+
+    CHECK(worst <= 1, "SC%d,%d,%d,%d: plotter coordinate off by %u units", xmin, xmax, ymin, ymax, worst);
+    CHECK(worst_out <= 1.0f, "SC%d,%d,%d,%d: corrected position off by %.3f units", xmin, xmax, ymin, ymax, worst_out);
+}
+
+int main (int argc, char **argv)
+{
+    host_init();
+
+    srand(28);
+
+    test_sc(0, hpgl_settings.max_x, 0, hpgl_settings.max_y);
+    test_sc(0, 100, 0, 100);
+    test_sc(-50, 3000, 7, 9000);
+    test_sc(0, 20000, 0, 15000);
+    test_sc(0, 1000000, 0, 700000);
+    test_sc(0, 3, 0, 7);
+
+    if(failures == 0)
+        printf("all scale tests passed\n");
+
+    return failures ? 1 : 0;
+}